@@ -0,0 +1,311 @@
+/*
+  benchmark harness
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+
+  Parses and serializes the generated corpora with the bindings in
+  binds.c and prints one tab-separated result line per corpus and
+  benchmark to stdout:
+
+	corpus bench MB/s docs/s calls/B allocs/doc
+
+  MB/s and calls/B refer to the JSON text, ie, the input of the
+  parser or the output of the serializer.
+*/
+
+/*  includes */
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "uni_json_types.h"
+#include "uni_json_p_binding.h"
+#include "uni_json_s_binding.h"
+#include "uni_json_parser.h"
+#include "uni_json_serializer.h"
+#include "bench.h"
+
+/*  constants */
+enum {
+    DEF_SIZE =		4 << 20,        /* bytes per corpus */
+    MIN_PASSES =	3
+};
+
+enum {
+    COUNT_CALLS =	1,
+    COUNT_ALLOCS =	2
+};
+
+/*  types */
+struct run {
+    struct corpus *c;
+    struct node **trees;        /* parsed documents for serializing */
+    void *binds;
+    int fmt;
+    size_t out;                 /* serializer output of the last pass */
+};
+
+typedef void bench_pass(struct run *);
+
+struct bench {
+    char *name;
+    bench_pass *pass;
+    void *binds;
+    int fmt;
+    unsigned counted;           /* COUNT_* bits */
+};
+
+/*  prototypes */
+static bench_pass parse_pass, serialize_pass;
+
+/*  variables */
+static struct bench benches[] = {
+    {
+        .name = "parse-null",	.pass = parse_pass,
+        .binds = &null_p_binding
+    },
+
+    {
+        .name = "parse-count",	.pass = parse_pass,
+        .binds = &counting_p_binding,	.counted = COUNT_CALLS | COUNT_ALLOCS
+    },
+
+    {
+        .name = "parse-tree",	.pass = parse_pass,
+        .binds = &tree_p_binding,	.counted = COUNT_ALLOCS
+    },
+
+    {
+        .name = "ser-fast",	.pass = serialize_pass,
+        .binds = &tree_s_binding,	.fmt = UJ_FMT_FAST
+    },
+
+    {
+        .name = "ser-det",	.pass = serialize_pass,
+        .binds = &tree_s_binding,	.fmt = UJ_FMT_DET,	.counted = COUNT_ALLOCS
+    },
+
+    {
+        .name = "ser-count",	.pass = serialize_pass,
+        .binds = &counting_s_binding,	.fmt = UJ_FMT_FAST,
+        .counted = COUNT_CALLS | COUNT_ALLOCS
+    }
+};
+
+static double min_time = 0.25;
+
+/*  routines */
+/**  passes */
+static int drop_value(void *val, size_t, void *p)
+{
+    if (p) free_node(val);
+    return 1;
+}
+
+static void parse_pass(struct run *r)
+{
+    struct uni_json_p_binding *binds;
+    struct corpus *c;
+    size_t ndx;
+    void *v;
+    int tree;
+
+    binds = r->binds;
+    tree = binds == &tree_p_binding;
+    c = r->c;
+
+    if (c->seq) {
+        uni_json_parse_seq(c->data, c->len, binds, drop_value, tree ? binds : NULL, 0);
+        return;
+    }
+
+    for (ndx = 0; ndx < c->n_docs; ++ndx) {
+        v = uni_json_parse(c->data + c->offs[ndx], c->offs[ndx + 1] - c->offs[ndx],
+                           binds, NULL);
+        if (tree && v) free_node(v);
+    }
+}
+
+static void serialize_pass(struct run *r)
+{
+    size_t ndx;
+
+    r->out = 0;
+    for (ndx = 0; ndx < r->c->n_docs; ++ndx)
+        uni_json_serialize(r->trees[ndx], &r->out, r->binds, r->fmt);
+}
+
+/**  timing */
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double best_pass(bench_pass *pass, struct run *r)
+{
+    /*
+      Run passes for at least min_time seconds and return the time
+      of the fastest one.
+    */
+    double start, t0, t, best;
+    unsigned n;
+
+    best = 0;
+    n = 0;
+    start = now();
+    do {
+        t0 = now();
+        pass(r);
+        t = now() - t0;
+
+        if (!n || t < best) best = t;
+        ++n;
+    } while (n < MIN_PASSES || now() - start < min_time);
+
+    return best;
+}
+
+/**  corpora */
+static int seq_tree(void *val, size_t, void *p)
+{
+    struct node ***tp;
+
+    tp = p;
+    *(*tp)++ = val;
+    return 1;
+}
+
+static struct node **parse_trees(struct corpus *c)
+{
+    struct node **trees, **tp;
+    size_t ndx;
+
+    trees = malloc(c->n_docs * sizeof(*trees));
+
+    if (c->seq) {
+        tp = trees;
+        uni_json_parse_seq(c->data, c->len, &tree_p_binding, seq_tree, &tp, 0);
+    } else
+        for (ndx = 0; ndx < c->n_docs; ++ndx)
+            trees[ndx] = uni_json_parse(c->data + c->offs[ndx],
+                                        c->offs[ndx + 1] - c->offs[ndx],
+                                        &tree_p_binding, NULL);
+
+    return trees;
+}
+
+static int write_corpus(char *dir, struct corpus *c)
+{
+    char path[4096];
+    FILE *fp;
+    int rc;
+
+    snprintf(path, sizeof(path), "%s/%s.json", dir, c->name);
+    fp = fopen(path, "w");
+    if (!fp) {
+        perror(path);
+        return -1;
+    }
+
+    rc = fwrite(c->data, 1, c->len, fp) == c->len ? 0 : -1;
+    if (fclose(fp) == EOF) rc = -1;
+    if (rc == -1) perror(path);
+
+    return rc;
+}
+
+/**  main */
+static void usage(char *me)
+{
+    fprintf(stderr, "usage: %s [-c <corpus dir>] [-s <MB per corpus>] [-t <min seconds>] [-q]\n", me);
+    exit(1);
+}
+
+int main(int argc, char **argv)
+{
+    struct corpus *corpora, *c;
+    struct bench *b;
+    struct run r;
+    char *dir;
+    size_t size, ndx;
+    unsigned n, nc, nb;
+    double t, len;
+    int opt, quiet;
+
+    dir = NULL;
+    size = DEF_SIZE;
+    quiet = 0;
+    while (opt = getopt(argc, argv, "c:s:t:q"), opt != -1)
+        switch (opt) {
+        case 'c':
+            dir = optarg;
+            break;
+
+        case 's':
+            size = atof(optarg) * (1 << 20);
+            break;
+
+        case 't':
+            min_time = atof(optarg);
+            break;
+
+        case 'q':
+            quiet = 1;
+            break;
+
+        default:
+            usage(*argv);
+        }
+
+    corpora = make_corpora(size, &n);
+
+    if (!quiet) printf("# corpus\tbench\tMB/s\tdocs/s\tcalls/B\tallocs/doc\n");
+
+    for (nc = 0; nc < n; ++nc) {
+        c = corpora + nc;
+        if (dir && write_corpus(dir, c) == -1) return 1;
+
+        r.c = c;
+        r.trees = parse_trees(c);
+
+        for (nb = 0; nb < sizeof(benches) / sizeof(*benches); ++nb) {
+            b = benches + nb;
+
+            r.binds = b->binds;
+            r.fmt = b->fmt;
+            t = best_pass(b->pass, &r);
+
+            /*  one more pass for the counts */
+            memset(&counts, 0, sizeof(counts));
+            b->pass(&r);
+
+            len = b->pass == serialize_pass ? r.out : c->len;
+            printf("%s\t%s\t%.1f\t%.0f\t", c->name, b->name, len / t / 1e6, c->n_docs / t);
+            if (b->counted & COUNT_CALLS)
+                printf("%.4f\t", counts.calls / len);
+            else
+                printf("-\t");
+
+            if (b->counted & COUNT_ALLOCS)
+                printf("%.2f\n", (double)counts.allocs / c->n_docs);
+            else
+                printf("-\n");
+        }
+
+        for (ndx = 0; ndx < c->n_docs; ++ndx) free_node(r.trees[ndx]);
+        free(r.trees);
+        free(c->data);
+        free(c->offs);
+    }
+
+    free(corpora);
+    return 0;
+}
@@ -0,0 +1,56 @@
+/*
+  benchmark harness
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+*/
+#ifndef uni_json_bench_h
+#define uni_json_bench_h
+
+/*  includes */
+#include <inttypes.h>
+#include <stddef.h>
+
+/*  types */
+struct corpus {
+    char *name;
+
+    /*
+      Documents, each on a line of its own. offs has n_docs + 1
+      entries, the start of every document and the end of the data.
+    */
+    uint8_t *data;
+    size_t len;
+    size_t *offs, n_docs;
+
+    int seq;                    /* parse as one sequence of values */
+};
+
+struct node {
+    unsigned type;
+
+    /*  string and number text, value of a boolean in len */
+    uint8_t *s;
+    size_t len;
+
+    /*  array values or alternating object keys and values */
+    struct node **kids;
+    size_t n, size, pos;
+};
+
+struct counts {
+    uint64_t calls, allocs;
+};
+
+/*  variables */
+extern struct counts counts;
+
+extern struct uni_json_p_binding null_p_binding, counting_p_binding, tree_p_binding;
+extern struct uni_json_s_binding tree_s_binding, counting_s_binding;
+
+/*  routines */
+struct corpus *make_corpora(size_t size, unsigned *n);
+void free_node(void *p);
+
+#endif
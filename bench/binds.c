@@ -0,0 +1,415 @@
+/*
+  benchmark bindings
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+*/
+
+/*  includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "uni_json_types.h"
+#include "uni_json_p_binding.h"
+#include "uni_json_s_binding.h"
+#include "uni_json_parser.h"
+#include "bench.h"
+
+/*  variables */
+struct counts counts;
+
+static char dummy;
+
+/*  routines */
+static void on_error(unsigned code, size_t pos, void *)
+{
+    /*  the corpora are valid JSON */
+    fprintf(stderr, "corpus error at %zu: %s\n", pos, uni_json_ec_2_msg(code));
+    exit(1);
+}
+
+/**  null parser binding */
+static void *null_make(void)
+{
+    return &dummy;
+}
+
+static void null_free(void *)
+{
+}
+
+static int null_add_2_object(void *, void *, void *)
+{
+    return 1;
+}
+
+static int null_add_2_array(void *, void *)
+{
+    return 1;
+}
+
+static int null_add_2_string(uint8_t *, size_t, void *)
+{
+    return 1;
+}
+
+static void *null_make_bool(int)
+{
+    return &dummy;
+}
+
+static void *null_make_number(uint8_t *, size_t, unsigned)
+{
+    return &dummy;
+}
+
+struct uni_json_p_binding null_p_binding = {
+    .on_error =		on_error,
+
+    .make_object =	null_make,
+    .free_object =	null_free,
+    .add_2_object =	null_add_2_object,
+
+    .make_array =	null_make,
+    .free_array =	null_free,
+    .add_2_array =	null_add_2_array,
+
+    .make_string =	null_make,
+    .free_string =	null_free,
+    .add_2_string =	null_add_2_string,
+
+    .make_null =	null_make,
+    .free_null =	null_free,
+
+    .make_bool =	null_make_bool,
+    .free_bool =	null_free,
+
+    .make_number =	null_make_number,
+    .free_number =	null_free,
+
+    .alloc =		malloc,
+    .dealloc =		free
+};
+
+/**  counting parser binding */
+/*
+  c_(ret, f, params, args) defines a routine counted_f which
+  counts the call and calls f.
+*/
+#define c_(ret, f, params, args)                        \
+    static ret counted_ ## f params                     \
+    {                                                   \
+        ++counts.calls;                                 \
+        return f args;                                  \
+    }
+
+c_(void *, null_make, (void), ())
+c_(void, null_free, (void *p), (p))
+c_(int, null_add_2_object, (void *k, void *v, void *o), (k, v, o))
+c_(int, null_add_2_array, (void *v, void *a), (v, a))
+c_(int, null_add_2_string, (uint8_t *d, size_t l, void *s), (d, l, s))
+c_(void *, null_make_bool, (int b), (b))
+c_(void *, null_make_number, (uint8_t *d, size_t l, unsigned f), (d, l, f))
+
+static void *counted_malloc(size_t len)
+{
+    ++counts.calls;
+    ++counts.allocs;
+    return malloc(len);
+}
+
+static void counted_free(void *p)
+{
+    ++counts.calls;
+    free(p);
+}
+
+struct uni_json_p_binding counting_p_binding = {
+    .on_error =		on_error,
+
+    .make_object =	counted_null_make,
+    .free_object =	counted_null_free,
+    .add_2_object =	counted_null_add_2_object,
+
+    .make_array =	counted_null_make,
+    .free_array =	counted_null_free,
+    .add_2_array =	counted_null_add_2_array,
+
+    .make_string =	counted_null_make,
+    .free_string =	counted_null_free,
+    .add_2_string =	counted_null_add_2_string,
+
+    .make_null =	counted_null_make,
+    .free_null =	counted_null_free,
+
+    .make_bool =	counted_null_make_bool,
+    .free_bool =	counted_null_free,
+
+    .make_number =	counted_null_make_number,
+    .free_number =	counted_null_free,
+
+    .alloc =		counted_malloc,
+    .dealloc =		counted_free
+};
+
+/**  tree parser binding */
+static struct node *new_node(unsigned type)
+{
+    struct node *n;
+
+    ++counts.allocs;
+    n = calloc(1, sizeof(*n));
+    n->type = type;
+    return n;
+}
+
+void free_node(void *p)
+{
+    struct node *n;
+    size_t ndx;
+
+    n = p;
+    for (ndx = 0; ndx < n->n; ++ndx) free_node(n->kids[ndx]);
+
+    free(n->kids);
+    free(n->s);
+    free(n);
+}
+
+static void add_kid(struct node *n, struct node *kid)
+{
+    if (n->n == n->size) {
+        ++counts.allocs;
+        n->size = n->size ? n->size * 2 : 4;
+        n->kids = realloc(n->kids, n->size * sizeof(*n->kids));
+    }
+
+    n->kids[n->n++] = kid;
+}
+
+static void *tree_make_object(void)
+{
+    return new_node(UJ_T_OBJ);
+}
+
+static int tree_add_2_object(void *key, void *value, void *obj)
+{
+    add_kid(obj, key);
+    add_kid(obj, value);
+    return 1;
+}
+
+static void *tree_make_array(void)
+{
+    return new_node(UJ_T_ARY);
+}
+
+static int tree_add_2_array(void *value, void *ary)
+{
+    add_kid(ary, value);
+    return 1;
+}
+
+static void *tree_make_string(void)
+{
+    return new_node(UJ_T_STR);
+}
+
+static void *tree_make_string_span(uint8_t *data, size_t len)
+{
+    struct node *n;
+
+    n = new_node(UJ_T_STR);
+
+    ++counts.allocs;
+    n->s = malloc(len + 1);
+    memcpy(n->s, data, len);
+    n->len = len;
+
+    return n;
+}
+
+static int tree_add_2_string(uint8_t *data, size_t len, void *str)
+{
+    struct node *n;
+
+    n = str;
+
+    ++counts.allocs;
+    n->s = realloc(n->s, n->len + len + 1);
+    memcpy(n->s + n->len, data, len);
+    n->len += len;
+
+    return 1;
+}
+
+static void *tree_make_null(void)
+{
+    return new_node(UJ_T_NULL);
+}
+
+static void *tree_make_bool(int true_false)
+{
+    struct node *n;
+
+    n = new_node(UJ_T_BOOL);
+    n->len = true_false;
+    return n;
+}
+
+static void *tree_make_number(uint8_t *data, size_t len, unsigned)
+{
+    struct node *n;
+
+    n = tree_make_string_span(data, len);
+    n->type = UJ_T_NUM;
+    return n;
+}
+
+static void *tree_malloc(size_t len)
+{
+    ++counts.allocs;
+    return malloc(len);
+}
+
+struct uni_json_p_binding tree_p_binding = {
+    .on_error =			on_error,
+
+    .make_object =		tree_make_object,
+    .free_object =		free_node,
+    .add_2_object =		tree_add_2_object,
+
+    .make_array =		tree_make_array,
+    .free_array =		free_node,
+    .add_2_array =		tree_add_2_array,
+
+    .make_string =		tree_make_string,
+    .free_string =		free_node,
+    .add_2_string =		tree_add_2_string,
+    .make_string_span =		tree_make_string_span,
+
+    .make_null =		tree_make_null,
+    .free_null =		free_node,
+
+    .make_bool =		tree_make_bool,
+    .free_bool =		free_node,
+
+    .make_number =		tree_make_number,
+    .free_number =		free_node,
+
+    .alloc =			tree_malloc,
+    .dealloc =			free
+};
+
+/**  tree serializer binding */
+/*
+  Output is discarded and only counted in the size_t the sink
+  points to. Nodes serve as their own iterators as no node is
+  traversed twice at the same time.
+*/
+static void tree_output(uint8_t *, size_t len, void *sink)
+{
+    *(size_t *)sink += len;
+}
+
+static int tree_type_of(void *p)
+{
+    return ((struct node *)p)->type;
+}
+
+static void *tree_start_traversal(void *p)
+{
+    ((struct node *)p)->pos = 0;
+    return p;
+}
+
+static size_t tree_max_kv_pairs(void *obj)
+{
+    return ((struct node *)obj)->n / 2;
+}
+
+static int tree_next_kv_pair(void *oiter, struct uj_kv_pair *kvp)
+{
+    struct node *n, *key;
+
+    n = oiter;
+    if (n->pos == n->n) return 0;
+
+    key = n->kids[n->pos];
+    kvp->key.s = key->s;
+    kvp->key.len = key->len;
+    kvp->val = n->kids[n->pos + 1];
+    n->pos += 2;
+
+    return 1;
+}
+
+static void *tree_next_value(void *aiter)
+{
+    struct node *n;
+
+    n = aiter;
+    return n->pos < n->n ? n->kids[n->pos++] : NULL;
+}
+
+static void tree_get_data(void *p, struct uj_data *data)
+{
+    struct node *n;
+
+    n = p;
+    data->s = n->s;
+    data->len = n->len;
+}
+
+static int tree_get_bool_value(void *p)
+{
+    return ((struct node *)p)->len;
+}
+
+struct uni_json_s_binding tree_s_binding = {
+    .output =			tree_output,
+    .type_of =			tree_type_of,
+    .alloc =			tree_malloc,
+    .dealloc =			free,
+
+    .start_object_traversal =	tree_start_traversal,
+    .max_kv_pairs =		tree_max_kv_pairs,
+    .next_kv_pair =		tree_next_kv_pair,
+
+    .start_array_traversal =	tree_start_traversal,
+    .next_value =		tree_next_value,
+
+    .get_num_data =		tree_get_data,
+    .get_string_data =		tree_get_data,
+    .get_bool_value =		tree_get_bool_value
+};
+
+/**  counting serializer binding */
+c_(void, tree_output, (uint8_t *d, size_t l, void *s), (d, l, s))
+c_(int, tree_type_of, (void *p), (p))
+c_(void *, tree_start_traversal, (void *p), (p))
+c_(size_t, tree_max_kv_pairs, (void *p), (p))
+c_(int, tree_next_kv_pair, (void *i, struct uj_kv_pair *kvp), (i, kvp))
+c_(void *, tree_next_value, (void *i), (i))
+c_(void, tree_get_data, (void *p, struct uj_data *d), (p, d))
+c_(int, tree_get_bool_value, (void *p), (p))
+
+struct uni_json_s_binding counting_s_binding = {
+    .output =			counted_tree_output,
+    .type_of =			counted_tree_type_of,
+    .alloc =			counted_malloc,
+    .dealloc =			counted_free,
+
+    .start_object_traversal =	counted_tree_start_traversal,
+    .max_kv_pairs =		counted_tree_max_kv_pairs,
+    .next_kv_pair =		counted_tree_next_kv_pair,
+
+    .start_array_traversal =	counted_tree_start_traversal,
+    .next_value =		counted_tree_next_value,
+
+    .get_num_data =		counted_tree_get_data,
+    .get_string_data =		counted_tree_get_data,
+    .get_bool_value =		counted_tree_get_bool_value
+};
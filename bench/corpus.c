@@ -0,0 +1,356 @@
+/*
+  benchmark corpora
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+
+  All corpora are generated from a fixed seed and are thus the same
+  for every run.
+*/
+
+/*  includes */
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+
+/*  constants */
+enum {
+    SEED =		0x756e692d6a736f6e,
+
+    /*  document shapes */
+    STR_RECORDS =	16,
+    NUM_ROWS =		64,
+    NUM_COLS =		8,
+    NEST_DEPTH =	96,
+    WIDE_KEYS =		2000,
+    ESC_STRINGS =	64,
+    UTF8_STRINGS =	64
+};
+
+/*  types */
+struct buf {
+    uint8_t *p;
+    size_t len, size;
+};
+
+typedef void gen_doc(struct buf *);
+
+struct shape {
+    char *name;
+    gen_doc *gen;
+    int seq;
+};
+
+/*  prototypes */
+static gen_doc gen_strings, gen_numbers, gen_nested, gen_wide, gen_escapes,
+    gen_utf8, gen_ndjson;
+
+/*  variables */
+static struct shape shapes[] = {
+    { .name = "strings",	.gen = gen_strings },
+    { .name = "numbers",	.gen = gen_numbers },
+    { .name = "nested",		.gen = gen_nested },
+    { .name = "wide",		.gen = gen_wide },
+    { .name = "escapes",	.gen = gen_escapes },
+    { .name = "utf8",		.gen = gen_utf8 },
+    { .name = "ndjson",		.gen = gen_ndjson,	.seq = 1 }
+};
+
+static char *words[] = {
+    "lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing",
+    "elit", "sed", "do", "eiusmod", "tempor", "incididunt", "ut", "labore",
+    "et", "dolore", "magna", "aliqua", "enim", "ad", "minim", "veniam",
+    "quis", "nostrud", "exercitation", "ullamco", "laboris", "nisi",
+    "aliquip", "ex", "ea", "commodo", "consequat"
+};
+
+static char *intl_words[] = {
+    "caf\xc3\xa9", "na\xc3\xafve", "Stra\xc3\x9f" "e", "\xc3\xa5r",
+    "\xce\xba\xce\xb1\xce\xbb\xce\xb7\xce\xbc\xce\xad\xcf\x81\xce\xb1",
+    "\xd0\xbf\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82",
+    "\xd7\xa9\xd7\x9c\xd7\x95\xd7\x9d",
+    "\xd9\x85\xd8\xb1\xd8\xad\xd8\xa8\xd8\xa7",
+    "\xe0\xa4\xa8\xe0\xa4\xae\xe0\xa4\xb8\xe0\xa5\x8d\xe0\xa4\xa4\xe0\xa5\x87",
+    "\xe4\xbd\xa0\xe5\xa5\xbd", "\xe4\xb8\x96\xe7\x95\x8c",
+    "\xe3\x81\x93\xe3\x82\x93\xe3\x81\xab\xe3\x81\xa1\xe3\x81\xaf",
+    "\xec\x95\x88\xeb\x85\x95", "\xf0\x9f\x98\x80", "\xf0\x9f\x8c\x8d",
+    "plain", "ascii"
+};
+
+static char *escapes[] = {
+    "\\n", "\\t", "\\\"", "\\\\", "\\/", "\\r", "\\u00e9", "\\u20ac",
+    "\\ud83d\\ude00", "\\u0001"
+};
+
+static char *levels[] = { "debug", "info", "info", "info", "warn", "error" };
+
+static uint64_t rnd_state;
+
+/*  routines */
+/**  helpers */
+static uint64_t rnd(void)
+{
+    /*  xorshift64* */
+    rnd_state ^= rnd_state >> 12;
+    rnd_state ^= rnd_state << 25;
+    rnd_state ^= rnd_state >> 27;
+    return rnd_state * 0x2545f4914f6cdd1dULL;
+}
+
+static unsigned rnd_n(unsigned n)
+{
+    return rnd() % n;
+}
+
+static void put(struct buf *b, void *data, size_t len)
+{
+    if (b->len + len > b->size) {
+        do b->size = b->size ? b->size * 2 : 65536; while (b->len + len > b->size);
+        b->p = realloc(b->p, b->size);
+    }
+
+    memcpy(b->p + b->len, data, len);
+    b->len += len;
+}
+
+static void put_s(struct buf *b, char *s)
+{
+    put(b, s, strlen(s));
+}
+
+static void put_f(struct buf *b, char *fmt, ...)
+    __attribute__ ((format (printf, 2, 3)));
+
+static void put_f(struct buf *b, char *fmt, ...)
+{
+    char tmp[64];
+    va_list val;
+    int len;
+
+    va_start(val, fmt);
+    len = vsnprintf(tmp, sizeof(tmp), fmt, val);
+    va_end(val);
+
+    put(b, tmp, len);
+}
+
+static void put_words(struct buf *b, char **ws, unsigned n_ws, unsigned n)
+{
+    put_s(b, "\"");
+
+    while (n) {
+        put_s(b, ws[rnd_n(n_ws)]);
+        if (--n) put_s(b, " ");
+    }
+
+    put_s(b, "\"");
+}
+
+#define n_elems(a) (sizeof(a) / sizeof(*a))
+
+/**  document shapes */
+static void gen_strings(struct buf *b)
+{
+    unsigned r, t;
+
+    put_s(b, "[");
+
+    for (r = 0; r < STR_RECORDS; ++r) {
+        if (r) put_s(b, ",");
+
+        put_f(b, "{\"id\":%u,\"title\":", r);
+        put_words(b, words, n_elems(words), 2 + rnd_n(6));
+
+        put_s(b, ",\"tags\":[");
+        for (t = rnd_n(5); t; --t) {
+            put_words(b, words, n_elems(words), 1);
+            if (t > 1) put_s(b, ",");
+        }
+
+        put_s(b, "],\"body\":");
+        put_words(b, words, n_elems(words), 10 + rnd_n(60));
+        put_s(b, "}");
+    }
+
+    put_s(b, "]");
+}
+
+static void gen_numbers(struct buf *b)
+{
+    unsigned r, c;
+
+    put_s(b, "[");
+
+    for (r = 0; r < NUM_ROWS; ++r) {
+        put_s(b, r ? ",[" : "[");
+
+        for (c = 0; c < NUM_COLS; ++c) {
+            if (c) put_s(b, ",");
+
+            switch (c % 4) {
+            case 0:
+                put_f(b, "%u", rnd_n(10000));
+                break;
+
+            case 1:
+                put_f(b, "%" PRId64, (int64_t)rnd() >> rnd_n(63));
+                break;
+
+            case 2:
+                put_f(b, "%.*f", 1 + rnd_n(6), (int)rnd_n(2000000) / 1000.0 - 1000);
+                break;
+
+            case 3:
+                put_f(b, "%.*fe%d", 1 + rnd_n(16), (rnd() >> 11) * 0x1p-53 * 10,
+                      (int)rnd_n(600) - 300);
+            }
+        }
+
+        put_s(b, "]");
+    }
+
+    put_s(b, "]");
+}
+
+static void gen_nested_value(struct buf *b, unsigned depth)
+{
+    if (!depth) {
+        put_s(b, "null");
+        return;
+    }
+
+    if (depth & 1) {
+        put_f(b, "{\"level\":%u,\"ok\":%s,\"next\":", depth, rnd_n(2) ? "true" : "false");
+        gen_nested_value(b, depth - 1);
+        put_s(b, "}");
+    } else {
+        put_f(b, "[%u,", depth);
+        gen_nested_value(b, depth - 1);
+        put_s(b, "]");
+    }
+}
+
+static void gen_nested(struct buf *b)
+{
+    gen_nested_value(b, NEST_DEPTH);
+}
+
+static void gen_wide(struct buf *b)
+{
+    unsigned k, start;
+
+    put_s(b, "{");
+
+    start = rnd_n(WIDE_KEYS);
+    for (k = 0; k < WIDE_KEYS; ++k) {
+        if (k) put_s(b, ",");
+        put_f(b, "\"field_%05u\":", (start + k * 7919) % WIDE_KEYS);
+
+        switch (rnd_n(3)) {
+        case 0:
+            put_f(b, "%u", rnd_n(1000000));
+            break;
+
+        case 1:
+            put_words(b, words, n_elems(words), 1);
+            break;
+
+        case 2:
+            put_s(b, rnd_n(2) ? "true" : "false");
+        }
+    }
+
+    put_s(b, "}");
+}
+
+static void gen_escapes(struct buf *b)
+{
+    unsigned s, n;
+
+    put_s(b, "[");
+
+    for (s = 0; s < ESC_STRINGS; ++s) {
+        put_s(b, s ? ",\"" : "\"");
+
+        for (n = 20 + rnd_n(80); n; --n)
+            if (rnd_n(2))
+                put_s(b, escapes[rnd_n(n_elems(escapes))]);
+            else
+                put_s(b, words[rnd_n(n_elems(words))]);
+
+        put_s(b, "\"");
+    }
+
+    put_s(b, "]");
+}
+
+static void gen_utf8(struct buf *b)
+{
+    unsigned s;
+
+    put_s(b, "[");
+
+    for (s = 0; s < UTF8_STRINGS; ++s) {
+        if (s) put_s(b, ",");
+        put_words(b, intl_words, n_elems(intl_words), 4 + rnd_n(40));
+    }
+
+    put_s(b, "]");
+}
+
+static void gen_ndjson(struct buf *b)
+{
+    put_f(b, "{\"ts\":%" PRIu64 ",\"level\":\"%s\",\"msg\":",
+          (uint64_t)1700000000000 + rnd_n(100000000), levels[rnd_n(n_elems(levels))]);
+    put_words(b, words, n_elems(words), 3 + rnd_n(12));
+    put_f(b, ",\"user\":{\"id\":%u,\"name\":", rnd_n(100000));
+    put_words(b, words, n_elems(words), 1);
+    put_f(b, "},\"latency_ms\":%.2f,\"cached\":%s}",
+          rnd_n(100000) / 100.0, rnd_n(2) ? "true" : "false");
+}
+
+/**  corpora */
+static void make_corpus(struct shape *shape, size_t size, struct corpus *c)
+{
+    struct buf b;
+    size_t n;
+
+    rnd_state = SEED;
+    memset(&b, 0, sizeof(b));
+
+    c->offs = NULL;
+    n = 0;
+    do {
+        if (!(n & (n - 1)))
+            c->offs = realloc(c->offs, (n ? n * 2 : 1) * sizeof(*c->offs) + sizeof(*c->offs));
+        c->offs[n++] = b.len;
+
+        shape->gen(&b);
+        put_s(&b, "\n");
+    } while (b.len < size);
+
+    c->offs[n] = b.len;
+    c->n_docs = n;
+
+    c->name = shape->name;
+    c->data = b.p;
+    c->len = b.len;
+    c->seq = shape->seq;
+}
+
+struct corpus *make_corpora(size_t size, unsigned *n)
+{
+    struct corpus *corpora;
+    unsigned ndx;
+
+    corpora = malloc(n_elems(shapes) * sizeof(*corpora));
+    for (ndx = 0; ndx < n_elems(shapes); ++ndx)
+        make_corpus(shapes + ndx, size, corpora + ndx);
+
+    *n = n_elems(shapes);
+    return corpora;
+}
@@ -0,0 +1,60 @@
+/*
+  number parsing kernels
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+
+  The parser source is included to get at its static routines.
+*/
+
+/*  includes */
+#include "../../src/parser_number.c"
+
+#include <stdlib.h>
+#include "micro.h"
+
+/*  constants */
+enum {
+    DIGITS_LEN =	1 << 16
+};
+
+/*  variables */
+static uint8_t digits_buf[DIGITS_LEN + 32];
+static size_t digits_len;
+
+/*  routines */
+static void setup_digits(void)
+{
+    /*  runs of 1 to 20 digits separated by dots */
+    unsigned n;
+
+    srand(4);
+    while (digits_len < DIGITS_LEN) {
+        n = 1 + rand() % 20;
+        while (n--) digits_buf[digits_len++] = '0' + rand() % 10;
+        digits_buf[digits_len++] = '.';
+    }
+}
+
+static uint64_t run_digits(void)
+{
+    struct pstate pstate;
+    unsigned n;
+
+    pstate.p = digits_buf;
+    pstate.e = digits_buf + digits_len;
+    n = 0;
+    while (pstate.p < pstate.e) {
+        n += skip_digits(&pstate) == 0;
+        ++pstate.p;
+    }
+
+    micro_sink += n;
+    return digits_len;
+}
+
+struct kernel k_skip_digits = {
+    .name = "skip_digits",	.unit = "byte",
+    .setup = setup_digits,	.run = run_digits
+};
@@ -0,0 +1,127 @@
+/*
+  literal and whitespace kernels
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+*/
+
+/*  includes */
+#include <stdlib.h>
+#include <string.h>
+
+#include "uni_json_p_binding.h"
+#include "pstate.h"
+#include "parser_literals.h"
+#include "micro.h"
+
+/*  constants */
+enum {
+    N_LITERALS =	1 << 14,
+    WS_LEN =		1 << 16,
+    MAX_WS_RUN =	64
+};
+
+/*  prototypes */
+void *parse_value(struct pstate *, struct uni_json_p_binding *);
+
+/*  variables */
+static char *literals[] = { "true", "false", "null" };
+
+static uint8_t lit_buf[N_LITERALS * 5];
+static uint8_t *lit_want[N_LITERALS];
+static size_t lit_len;
+
+static uint8_t ws_buf[WS_LEN + MAX_WS_RUN + 2];
+static size_t ws_len;
+
+static char dummy;
+
+/*  routines */
+/**  skip_literal */
+static void setup_literals(void)
+{
+    unsigned n;
+    size_t len;
+    char *s;
+
+    srand(5);
+    for (n = 0; n < N_LITERALS; ++n) {
+        s = literals[rand() % (sizeof(literals) / sizeof(*literals))];
+        len = strlen(s);
+        memcpy(lit_buf + lit_len, s, len);
+        lit_len += len;
+        lit_want[n] = s;
+    }
+}
+
+static uint64_t run_literals(void)
+{
+    struct pstate pstate;
+    unsigned n, ok;
+
+    pstate.p = lit_buf;
+    pstate.e = lit_buf + lit_len;
+    ok = 0;
+    for (n = 0; n < N_LITERALS; ++n) ok += skip_literal(&pstate, lit_want[n]) == 0;
+
+    micro_sink += ok;
+    return N_LITERALS;
+}
+
+struct kernel k_skip_literal = {
+    .name = "skip_literal",	.unit = "literal",
+    .setup = setup_literals,	.run = run_literals
+};
+
+/**  whitespace loop of parse_value */
+/*
+  The input is single-digit numbers separated by runs of
+  whitespace of random length. The numbers are parsed with a
+  binding which doesn't do anything.
+*/
+static void *make_number(uint8_t *, size_t, unsigned)
+{
+    return &dummy;
+}
+
+static struct uni_json_p_binding ws_binds = {
+    .make_number =	make_number
+};
+
+static void setup_ws(void)
+{
+    static char ws[] = " \t\n\r";
+    unsigned n;
+
+    srand(6);
+    while (ws_len < WS_LEN) {
+        n = 1 + rand() % MAX_WS_RUN;
+        while (n--) ws_buf[ws_len++] = ws[rand() % 4];
+        ws_buf[ws_len++] = '0' + rand() % 10;
+    }
+
+    ws_buf[ws_len++] = ' ';
+}
+
+static uint64_t run_ws(void)
+{
+    struct pstate pstate;
+    unsigned n;
+
+    memset(&pstate, 0, sizeof(pstate));
+    pstate.p = ws_buf;
+    pstate.e = ws_buf + ws_len;
+    pstate.max_nesting = -1;
+
+    n = 0;
+    while (pstate.p < pstate.e && parse_value(&pstate, &ws_binds)) ++n;
+
+    micro_sink += n;
+    return ws_len;
+}
+
+struct kernel k_ws_loop = {
+    .name = "parse_value_ws",	.unit = "byte",
+    .setup = setup_ws,		.run = run_ws
+};
@@ -0,0 +1,172 @@
+/*
+  serializer kernels
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+
+  The serializer source is included to get at its static routines.
+*/
+
+/*  includes */
+#include "../../src/uni_json_serializer.c"
+
+#include "micro.h"
+
+/*  constants */
+enum {
+    N_STRS =		1024,
+    MAX_STR =		200,
+    N_KEYS =		1 << 12,
+    HEAP_SIZE =		256
+};
+
+/*  types */
+struct kvp_iter {
+    struct uj_kv_pair *p, *e;
+};
+
+/*  variables */
+static uint8_t str_buf[N_STRS * MAX_STR];
+static uint8_t *strs[N_STRS + 1];
+static size_t strs_len;
+
+static uint8_t key_buf[N_KEYS * 16];
+static struct uj_kv_pair keys[N_KEYS];
+static struct uj_kv_pair heap[HEAP_SIZE + 1];
+
+/*  routines */
+/**  ser_string_data */
+/*
+  Mostly ASCII text with a quote, backslash or control character
+  every 40 bytes on average.
+*/
+static void discard(uint8_t *, size_t, void *)
+{
+}
+
+static struct uni_json_s_binding str_binds = {
+    .output =	discard,
+    .alloc =	malloc,
+    .dealloc =	free
+};
+
+static void setup_strs(void)
+{
+    static char specials[] = "\"\\\n\t\001";
+    uint8_t *p;
+    unsigned n, len;
+
+    srand(7);
+    p = str_buf;
+    for (n = 0; n < N_STRS; ++n) {
+        strs[n] = p;
+
+        len = 8 + rand() % (MAX_STR - 8);
+        while (len--)
+            *p++ = rand() % 40 ? 'a' + rand() % 26 : specials[rand() % 5];
+    }
+
+    strs[n] = p;
+    strs_len = p - str_buf;
+}
+
+static uint64_t run_strs(void)
+{
+    uint8_t buf[4096];
+    struct sstate st;
+    unsigned n;
+
+    st.binds = &str_binds;
+    st.sink = NULL;
+    start_output(&st, buf, sizeof(buf));
+
+    for (n = 0; n < N_STRS; ++n)
+        ser_string_data(strs[n], strs[n + 1] - strs[n], &st);
+
+    micro_sink += st.p - st.buf;
+    end_output(&st);
+
+    return strs_len;
+}
+
+struct kernel k_ser_string_data = {
+    .name = "ser_string_data",	.unit = "byte",
+    .setup = setup_strs,	.run = run_strs
+};
+
+/**  key_cmp */
+/*
+  Keys like the ones of the wide objects of the benchmark corpora,
+  which share a 6 byte prefix.
+*/
+static void setup_keys(void)
+{
+    unsigned n;
+    int len;
+
+    srand(8);
+    for (n = 0; n < N_KEYS; ++n) {
+        len = sprintf((char *)key_buf + n * 16, "field_%05u", rand() % 100000);
+        keys[n].key.s = key_buf + n * 16;
+        keys[n].key.len = len;
+    }
+}
+
+static uint64_t run_key_cmp(void)
+{
+    unsigned n;
+    int sum;
+
+    sum = 0;
+    for (n = 1; n < N_KEYS; ++n) sum += key_cmp(keys + n - 1, keys + n) < 0;
+
+    micro_sink += sum;
+    return N_KEYS - 1;
+}
+
+struct kernel k_key_cmp = {
+    .name = "key_cmp",		.unit = "compare",
+    .setup = setup_keys,	.run = run_key_cmp
+};
+
+/**  build_kvph and rm_kvph_root */
+static int next_kvp(void *p, struct uj_kv_pair *kvp)
+{
+    struct kvp_iter *it;
+
+    it = p;
+    if (it->p == it->e) return 0;
+
+    *kvp = *it->p++;
+    return 1;
+}
+
+static struct uni_json_s_binding kvp_binds = {
+    .next_kv_pair =	next_kvp
+};
+
+static uint64_t run_kvph(void)
+{
+    struct kvp_heap kvph;
+    struct kvp_iter it;
+    unsigned n;
+    size_t sum;
+
+    sum = 0;
+    for (n = 0; n < N_KEYS; n += HEAP_SIZE) {
+        it.p = keys + n;
+        it.e = it.p + HEAP_SIZE;
+
+        build_kvph(&it, heap, &kvph, &kvp_binds);
+        do sum += kvph.h[1].key.len; while (rm_kvph_root(&kvph), kvph.last);
+    }
+
+    micro_sink += sum;
+    return N_KEYS;
+}
+
+struct kernel k_kvph = {
+    .name = "kvph",		.unit = "key",
+    .setup = setup_keys,	.run = run_kvph
+};
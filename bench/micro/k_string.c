@@ -0,0 +1,139 @@
+/*
+  string parsing kernels
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+
+  The parser source is included to get at its static routines.
+*/
+
+/*  includes */
+#include "../../src/parser_string.c"
+
+#include <stdlib.h>
+#include "micro.h"
+
+/*  constants */
+enum {
+    UTF8_LEN =		1 << 16,
+    N_HEX =		1 << 14,
+    N_U_ESC =		1 << 14
+};
+
+/*  variables */
+static uint8_t utf8_buf[UTF8_LEN + 4];
+static size_t utf8_len;
+
+static uint8_t hex_buf[N_HEX * 4];
+
+static uint8_t u_esc_buf[N_U_ESC * 12];
+static size_t u_esc_len;
+
+static char *u_escs[] = {
+    "\\u00e9", "\\u20ac", "\\u0041", "\\ud83d\\ude00", "\\uFFFD", "\\ud834\\udd1e"
+};
+
+/*  routines */
+/**  skip_utf8 */
+static void setup_utf8(void)
+{
+    /*  2-, 3- and 4-byte sequences */
+    static char *seqs[] = {
+        "\xc3\xa9", "\xd0\xbf", "\xe2\x82\xac", "\xe4\xbd\xa0", "\xf0\x9f\x98\x80"
+    };
+    size_t len;
+    char *s;
+
+    srand(1);
+    while (utf8_len < UTF8_LEN) {
+        s = seqs[rand() % (sizeof(seqs) / sizeof(*seqs))];
+        len = strlen(s);
+        memcpy(utf8_buf + utf8_len, s, len);
+        utf8_len += len;
+    }
+}
+
+static uint64_t run_utf8(void)
+{
+    uint8_t *p, *e;
+
+    p = utf8_buf;
+    e = p + utf8_len;
+    while (p && p < e) p = skip_utf8(p, e);
+
+    micro_sink += p == e;
+    return utf8_len;
+}
+
+struct kernel k_skip_utf8 = {
+    .name = "skip_utf8",	.unit = "byte",
+    .setup = setup_utf8,	.run = run_utf8
+};
+
+/**  parse_4dg_hex */
+static void setup_hex(void)
+{
+    static char hex[] = "0123456789abcdefABCDEF";
+    size_t ndx;
+
+    srand(2);
+    for (ndx = 0; ndx < sizeof(hex_buf); ++ndx)
+        hex_buf[ndx] = hex[rand() % (sizeof(hex) - 1)];
+}
+
+static uint64_t run_hex(void)
+{
+    struct pstate pstate;
+    uint8_t *p;
+    uint32_t sum;
+
+    pstate.e = hex_buf + sizeof(hex_buf);
+    sum = 0;
+    for (p = hex_buf; p < pstate.e; p += 4) sum += parse_4dg_hex(&pstate, p);
+
+    micro_sink += sum;
+    return N_HEX;
+}
+
+struct kernel k_parse_4dg_hex = {
+    .name = "parse_4dg_hex",	.unit = "call",
+    .setup = setup_hex,		.run = run_hex
+};
+
+/**  parse_u_esc */
+static void setup_u_esc(void)
+{
+    size_t len, n;
+    char *s;
+
+    srand(3);
+    for (n = 0; n < N_U_ESC; ++n) {
+        s = u_escs[rand() % (sizeof(u_escs) / sizeof(*u_escs))];
+        len = strlen(s);
+        memcpy(u_esc_buf + u_esc_len, s, len);
+        u_esc_len += len;
+    }
+}
+
+static uint64_t run_u_esc(void)
+{
+    struct pstate pstate;
+    uint32_t sum;
+
+    pstate.p = u_esc_buf;
+    pstate.e = u_esc_buf + u_esc_len;
+    sum = 0;
+    while (pstate.p < pstate.e) {
+        pstate.p += 2;          /* \u */
+        sum += parse_u_esc(&pstate);
+    }
+
+    micro_sink += sum;
+    return N_U_ESC;
+}
+
+struct kernel k_parse_u_esc = {
+    .name = "parse_u_esc",	.unit = "escape",
+    .setup = setup_u_esc,	.run = run_u_esc
+};
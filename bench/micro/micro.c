@@ -0,0 +1,153 @@
+/*
+  microbenchmarks of individual routines
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+
+  Runs each kernel repeatedly for a minimum time and prints one
+  tab-separated line per kernel:
+
+	kernel unit ns/unit cycles/unit IPC br-misses/unit cache-misses/unit
+
+  Counter values are from the fastest run. They're printed as -
+  if perf_event_open(2) isn't available.
+*/
+
+/*  includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "micro.h"
+
+/*  constants */
+enum {
+    MIN_RUNS =		5
+};
+
+/*  variables */
+volatile uint64_t micro_sink;
+
+static struct kernel *kernels[] = {
+    &k_skip_utf8,
+    &k_parse_4dg_hex,
+    &k_parse_u_esc,
+    &k_skip_digits,
+    &k_skip_literal,
+    &k_ws_loop,
+    &k_ser_string_data,
+    &k_key_cmp,
+    &k_kvph
+};
+
+static double min_time = 0.2;
+
+/*  routines */
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void per_unit(uint64_t v, uint64_t units)
+{
+    if (v == (uint64_t)PC_NONE)
+        printf("\t-");
+    else
+        printf("\t%.3f", (double)v / units);
+}
+
+static void run_kernel(struct kernel *k, struct perf *pf)
+{
+    /*
+      Run the kernel for at least min_time seconds and report the
+      fastest run.
+    */
+    uint64_t vals[N_PCS], best_vals[N_PCS], units;
+    double start, t0, t, best;
+    unsigned n;
+
+    k->setup();
+    k->run();
+
+    best = 0;
+    units = 0;
+    n = 0;
+    start = now();
+    do {
+        t0 = now();
+        perf_start(pf);
+        units = k->run();
+        perf_stop(pf, vals);
+        t = now() - t0;
+
+        if (!n || t < best) {
+            best = t;
+            memcpy(best_vals, vals, sizeof(vals));
+        }
+        ++n;
+    } while (n < MIN_RUNS || now() - start < min_time);
+
+    printf("%s\t%s\t%.3f", k->name, k->unit, best * 1e9 / units);
+    per_unit(best_vals[PC_CYCLES], units);
+
+    if (best_vals[PC_CYCLES] == (uint64_t)PC_NONE || best_vals[PC_INSNS] == (uint64_t)PC_NONE
+        || !best_vals[PC_CYCLES])
+        printf("\t-");
+    else
+        printf("\t%.2f", (double)best_vals[PC_INSNS] / best_vals[PC_CYCLES]);
+
+    per_unit(best_vals[PC_BR_MISSES], units);
+    per_unit(best_vals[PC_CACHE_MISSES], units);
+    putchar('\n');
+}
+
+static void usage(char *me)
+{
+    fprintf(stderr, "usage: %s [-t <min seconds>] [-q] [<kernel> ...]\n", me);
+    exit(1);
+}
+
+int main(int argc, char **argv)
+{
+    struct perf pf;
+    unsigned ndx;
+    int opt, quiet, n;
+
+    quiet = 0;
+    while (opt = getopt(argc, argv, "t:q"), opt != -1)
+        switch (opt) {
+        case 't':
+            min_time = atof(optarg);
+            break;
+
+        case 'q':
+            quiet = 1;
+            break;
+
+        default:
+            usage(*argv);
+        }
+
+    if (!perf_open(&pf) && !quiet)
+        fprintf(stderr, "%s: hardware counters not available, reporting times only\n", *argv);
+
+    if (!quiet)
+        printf("# kernel\tunit\tns/unit\tcycles/unit\tIPC\tbr-misses/unit\tcache-misses/unit\n");
+
+    for (ndx = 0; ndx < sizeof(kernels) / sizeof(*kernels); ++ndx) {
+        if (optind < argc) {
+            for (n = optind; n < argc && strcmp(argv[n], kernels[ndx]->name); ++n);
+            if (n == argc) continue;
+        }
+
+        run_kernel(kernels[ndx], &pf);
+    }
+
+    return 0;
+}
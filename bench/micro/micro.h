@@ -0,0 +1,60 @@
+/*
+  microbenchmarks of individual routines
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+*/
+#ifndef uni_json_micro_h
+#define uni_json_micro_h
+
+/*  includes */
+#include <inttypes.h>
+
+/*  constants */
+enum {
+    /*  hardware counters */
+    PC_CYCLES,
+    PC_INSNS,
+    PC_BR_MISSES,
+    PC_CACHE_MISSES,
+
+    N_PCS
+};
+
+enum {
+    PC_NONE = -1                /* value of a counter which isn't available */
+};
+
+/*  types */
+struct kernel {
+    char *name, *unit;
+
+    /*
+      setup prepares the input and is called once. run runs the
+      routine over the whole input and returns the number of units
+      processed.
+    */
+    void (*setup)(void);
+    uint64_t (*run)(void);
+};
+
+struct perf {
+    int fds[N_PCS];
+    unsigned n;                 /* number of counters opened */
+};
+
+/*  variables */
+extern volatile uint64_t micro_sink;
+
+extern struct kernel k_skip_utf8, k_parse_4dg_hex, k_parse_u_esc;
+extern struct kernel k_skip_digits;
+extern struct kernel k_skip_literal, k_ws_loop;
+extern struct kernel k_ser_string_data, k_key_cmp, k_kvph;
+
+/*  routines */
+int perf_open(struct perf *pf);
+void perf_start(struct perf *pf);
+void perf_stop(struct perf *pf, uint64_t *vals);
+
+#endif
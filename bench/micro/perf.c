@@ -0,0 +1,93 @@
+/*
+  hardware performance counters
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+
+  Counters are read as a group via perf_event_open(2). Counters
+  which can't be opened, eg, because the kernel doesn't permit it
+  or there's no PMU in a virtual machine, are reported as PC_NONE.
+*/
+
+/*  includes */
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "micro.h"
+
+/*  variables */
+static uint64_t pc_configs[N_PCS] = {
+    [PC_CYCLES] =		PERF_COUNT_HW_CPU_CYCLES,
+    [PC_INSNS] =		PERF_COUNT_HW_INSTRUCTIONS,
+    [PC_BR_MISSES] =		PERF_COUNT_HW_BRANCH_MISSES,
+    [PC_CACHE_MISSES] =		PERF_COUNT_HW_CACHE_MISSES
+};
+
+/*  routines */
+static int open_counter(uint64_t config, int group)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = group == -1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+
+    return syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+int perf_open(struct perf *pf)
+{
+    /*
+      Open the counters with the cycle counter as group
+      leader. Returns the number of counters which could be opened.
+    */
+    unsigned pc;
+
+    pf->n = 0;
+    for (pc = 0; pc < N_PCS; ++pc) {
+        pf->fds[pc] = open_counter(pc_configs[pc], pc ? pf->fds[PC_CYCLES] : -1);
+        if (pf->fds[pc] != -1) ++pf->n;
+        else if (!pc) break;
+    }
+
+    while (++pc < N_PCS) pf->fds[pc] = -1;
+    return pf->n;
+}
+
+void perf_start(struct perf *pf)
+{
+    if (!pf->n) return;
+
+    ioctl(pf->fds[PC_CYCLES], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(pf->fds[PC_CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+void perf_stop(struct perf *pf, uint64_t *vals)
+{
+    /*
+      The group is read as the number of counters followed by
+      their values in the order they were opened.
+    */
+    uint64_t data[N_PCS + 1];
+    unsigned pc, ndx;
+
+    for (pc = 0; pc < N_PCS; ++pc) vals[pc] = PC_NONE;
+    if (!pf->n) return;
+
+    ioctl(pf->fds[PC_CYCLES], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    if (read(pf->fds[PC_CYCLES], data, sizeof(data)) < (ssize_t)sizeof(*data))
+        return;
+
+    ndx = 1;
+    for (pc = 0; pc < N_PCS && ndx <= data[0]; ++pc)
+        if (pf->fds[pc] != -1) vals[pc] = data[ndx++];
+}
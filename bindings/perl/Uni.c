@@ -0,0 +1,1563 @@
+/*
+ * This file was generated automatically by ExtUtils::ParseXS version 3.45 from the
+ * contents of Uni.xs. Do not edit this file, edit Uni.xs instead.
+ *
+ *    ANY CHANGES MADE HERE WILL BE LOST!
+ *
+ */
+
+#line 1 "Uni.xs"
+/*
+  uni-json bindings for Perl -- XS code
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed
+*/
+
+/*  includes */
+#define PERL_NO_GET_CONTEXT
+#include "EXTERN.h"
+#include "perl.h"
+#include "XSUB.h"
+
+#include "uni_json_p_binding.h"
+#include "uni_json_parser.h"
+#include "uni_json_serializer.h"
+
+/*  constants */
+enum {
+    INIT_BUF_SIZE = 128
+};
+
+enum {
+    UJ_P_IN_SITU = 1 << 16      /* parser objects may modify the text */
+};
+
+/*  types */
+struct a_const {
+    char *n;
+    uint64_t v;
+};
+
+struct feed {
+    struct uni_json_feed *f;
+    struct uni_json_p_binding binds;
+    SV *on_error;
+};
+
+struct parser {
+    struct uni_json_parser *p;
+    struct uni_json_p_binding binds;
+};
+
+struct pull {
+    struct uni_json_pull *pl;
+    SV *val;                    /* copy of the value being serialized */
+};
+
+struct paths {
+    AV *res;
+    char *wild;                 /* path i contains a * segment */
+    SV *on_error;
+};
+
+/*  prototypes */
+void *parse(uint8_t *, size_t);
+int perl_uj_parse_events(uint8_t *, size_t, HV *);
+SV *serialize(SV *, int);
+
+/*  variables */
+extern struct uni_json_p_binding default_perl_uj_parser_bindings;
+extern struct uni_json_s_binding default_perl_uj_serializer_bindings;
+extern struct uni_json_s_binding default_perl_uj_pull_bindings;
+
+#define n_(x) { .n = #x, .v = x }
+
+static struct a_const err_consts[] = {
+    n_(UJ_E_INV),
+    n_(UJ_E_NO_VAL),
+    n_(UJ_E_INV_LIT),
+    n_(UJ_E_GARBAGE),
+    n_(UJ_E_EOS),
+    n_(UJ_E_INV_IN),
+    n_(UJ_E_ADD),
+    n_(UJ_E_LEADZ),
+    n_(UJ_E_NO_DGS),
+    n_(UJ_E_INV_CHAR),
+    n_(UJ_E_INV_UTF8),
+    n_(UJ_E_INV_ESC),
+    n_(UJ_E_INV_KEY),
+    n_(UJ_E_NO_KEY),
+    n_(UJ_E_TOO_DEEP),
+    n_(UJ_E_NO_MEM),
+    n_(UJ_E_INV_PATH)
+};
+
+static struct a_const fmt_consts[] = {
+    n_(UJ_FMT_FAST),
+    n_(UJ_FMT_DET),
+    n_(UJ_FMT_PRETTY)
+};
+
+static struct a_const seq_consts[] = {
+    n_(UJ_SEQ_RESYNC)
+};
+
+static struct a_const path_consts[] = {
+    n_(UJ_PATH_NO_VALIDATE)
+};
+
+static struct a_const parser_consts[] = {
+    n_(UJ_P_ITER),
+    n_(UJ_P_TAPE),
+    n_(UJ_P_IN_SITU)
+};
+
+#undef n_
+
+static void set_parser_flags(struct parser *parser, unsigned flags)
+{
+    /*
+      UJ_P_IN_SITU is handled here. The library ignores it in the
+      flags of the handle.
+    */
+    if (flags & UJ_P_IN_SITU)
+        parser->binds.span_flags |= UJ_SPAN_IN_SITU;
+    else
+        parser->binds.span_flags &= ~UJ_SPAN_IN_SITU;
+
+    uni_json_parser_set_flags(parser->p, flags);
+}
+
+static void invoke_error_handler(unsigned code, size_t pos, void *p)
+{
+    dTHX;
+    dSP;
+
+    ENTER;
+    SAVETMPS;
+
+    PUSHMARK(SP);
+    EXTEND(SP, 2);
+    PUSHs(sv_2mortal(newSVuv(code)));
+    PUSHs(sv_2mortal(newSVuv(pos)));
+    PUTBACK;
+
+    call_sv((SV *)p, G_DISCARD);
+
+    FREETMPS;
+    LEAVE;
+}
+
+static struct feed *get_feed(SV *self)
+{
+    dTHX;
+    struct feed *feed;
+
+    feed = INT2PTR(struct feed *, SvIV(SvRV(self)));
+    if (!feed->f) croak("feed already finished");
+    return feed;
+}
+
+static void invoke_any_error_handler(unsigned code, size_t pos, void *p)
+{
+    /*
+      Error handler for parser objects. These are created once,
+      hence, the handler argument of a parse call is passed as
+      error pointer. The default handler is used without one.
+    */
+    if (p)
+        invoke_error_handler(code, pos, p);
+    else
+        default_perl_uj_parser_bindings.on_error(code, pos, NULL);
+}
+
+static struct parser *get_parser(SV *self)
+{
+    dTHX;
+    return INT2PTR(struct parser *, SvIV(SvRV(self)));
+}
+
+static int invoke_value_handler(void *val, size_t pos, void *p)
+{
+    dTHX;
+    dSP;
+
+    ENTER;
+    SAVETMPS;
+
+    PUSHMARK(SP);
+    EXTEND(SP, 2);
+    PUSHs(sv_2mortal(val));
+    PUSHs(sv_2mortal(newSVuv(pos)));
+    PUTBACK;
+
+    /*
+      The parser may hold references to interned keys. Hence, the
+      handler must not die while it's running.
+    */
+    call_sv(((SV **)p)[0], G_DISCARD | G_EVAL);
+
+    FREETMPS;
+    LEAVE;
+
+    return !SvTRUE(ERRSV);
+}
+
+static void invoke_seq_error_handler(unsigned code, size_t pos, void *p)
+{
+    invoke_error_handler(code, pos, ((SV **)p)[1]);
+}
+
+static int has_wildcard(char *p)
+{
+    while ((p = strstr(p, "/*")))
+        if (!*(p += 2) || *p == '/') return 1;
+
+    return 0;
+}
+
+static int store_path_value(unsigned path, void *val, size_t, void *p)
+{
+    /*
+      Values for paths with wildcards are collected in an array,
+      for other paths, a later value replaces an earlier one like
+      a duplicate key in a hash.
+    */
+    dTHX;
+    struct paths *paths;
+    SV **svp;
+
+    paths = p;
+    if (paths->wild[path]) {
+        svp = av_fetch(paths->res, path, 0);
+        av_push((AV *)SvRV(*svp), val);
+    } else
+        av_store(paths->res, path, val);
+
+    return 1;
+}
+
+static void invoke_paths_error_handler(unsigned code, size_t pos, void *p)
+{
+    invoke_any_error_handler(code, pos, ((struct paths *)p)->on_error);
+}
+
+/*  XS code */
+#line 249 "Uni.c"
+#ifndef PERL_UNUSED_VAR
+#  define PERL_UNUSED_VAR(var) if (0) var = var
+#endif
+
+#ifndef dVAR
+#  define dVAR		dNOOP
+#endif
+
+
+/* This stuff is not part of the API! You have been warned. */
+#ifndef PERL_VERSION_DECIMAL
+#  define PERL_VERSION_DECIMAL(r,v,s) (r*1000000 + v*1000 + s)
+#endif
+#ifndef PERL_DECIMAL_VERSION
+#  define PERL_DECIMAL_VERSION \
+	  PERL_VERSION_DECIMAL(PERL_REVISION,PERL_VERSION,PERL_SUBVERSION)
+#endif
+#ifndef PERL_VERSION_GE
+#  define PERL_VERSION_GE(r,v,s) \
+	  (PERL_DECIMAL_VERSION >= PERL_VERSION_DECIMAL(r,v,s))
+#endif
+#ifndef PERL_VERSION_LE
+#  define PERL_VERSION_LE(r,v,s) \
+	  (PERL_DECIMAL_VERSION <= PERL_VERSION_DECIMAL(r,v,s))
+#endif
+
+/* XS_INTERNAL is the explicit static-linkage variant of the default
+ * XS macro.
+ *
+ * XS_EXTERNAL is the same as XS_INTERNAL except it does not include
+ * "STATIC", ie. it exports XSUB symbols. You probably don't want that
+ * for anything but the BOOT XSUB.
+ *
+ * See XSUB.h in core!
+ */
+
+
+/* TODO: This might be compatible further back than 5.10.0. */
+#if PERL_VERSION_GE(5, 10, 0) && PERL_VERSION_LE(5, 15, 1)
+#  undef XS_EXTERNAL
+#  undef XS_INTERNAL
+#  if defined(__CYGWIN__) && defined(USE_DYNAMIC_LOADING)
+#    define XS_EXTERNAL(name) __declspec(dllexport) XSPROTO(name)
+#    define XS_INTERNAL(name) STATIC XSPROTO(name)
+#  endif
+#  if defined(__SYMBIAN32__)
+#    define XS_EXTERNAL(name) EXPORT_C XSPROTO(name)
+#    define XS_INTERNAL(name) EXPORT_C STATIC XSPROTO(name)
+#  endif
+#  ifndef XS_EXTERNAL
+#    if defined(HASATTRIBUTE_UNUSED) && !defined(__cplusplus)
+#      define XS_EXTERNAL(name) void name(pTHX_ CV* cv __attribute__unused__)
+#      define XS_INTERNAL(name) STATIC void name(pTHX_ CV* cv __attribute__unused__)
+#    else
+#      ifdef __cplusplus
+#        define XS_EXTERNAL(name) extern "C" XSPROTO(name)
+#        define XS_INTERNAL(name) static XSPROTO(name)
+#      else
+#        define XS_EXTERNAL(name) XSPROTO(name)
+#        define XS_INTERNAL(name) STATIC XSPROTO(name)
+#      endif
+#    endif
+#  endif
+#endif
+
+/* perl >= 5.10.0 && perl <= 5.15.1 */
+
+
+/* The XS_EXTERNAL macro is used for functions that must not be static
+ * like the boot XSUB of a module. If perl didn't have an XS_EXTERNAL
+ * macro defined, the best we can do is assume XS is the same.
+ * Dito for XS_INTERNAL.
+ */
+#ifndef XS_EXTERNAL
+#  define XS_EXTERNAL(name) XS(name)
+#endif
+#ifndef XS_INTERNAL
+#  define XS_INTERNAL(name) XS(name)
+#endif
+
+/* Now, finally, after all this mess, we want an ExtUtils::ParseXS
+ * internal macro that we're free to redefine for varying linkage due
+ * to the EXPORT_XSUB_SYMBOLS XS keyword. This is internal, use
+ * XS_EXTERNAL(name) or XS_INTERNAL(name) in your code if you need to!
+ */
+
+#undef XS_EUPXS
+#if defined(PERL_EUPXS_ALWAYS_EXPORT)
+#  define XS_EUPXS(name) XS_EXTERNAL(name)
+#else
+   /* default to internal */
+#  define XS_EUPXS(name) XS_INTERNAL(name)
+#endif
+
+#ifndef PERL_ARGS_ASSERT_CROAK_XS_USAGE
+#define PERL_ARGS_ASSERT_CROAK_XS_USAGE assert(cv); assert(params)
+
+/* prototype to pass -Wmissing-prototypes */
+STATIC void
+S_croak_xs_usage(const CV *const cv, const char *const params);
+
+STATIC void
+S_croak_xs_usage(const CV *const cv, const char *const params)
+{
+    const GV *const gv = CvGV(cv);
+
+    PERL_ARGS_ASSERT_CROAK_XS_USAGE;
+
+    if (gv) {
+        const char *const gvname = GvNAME(gv);
+        const HV *const stash = GvSTASH(gv);
+        const char *const hvname = stash ? HvNAME(stash) : NULL;
+
+        if (hvname)
+	    Perl_croak_nocontext("Usage: %s::%s(%s)", hvname, gvname, params);
+        else
+	    Perl_croak_nocontext("Usage: %s(%s)", gvname, params);
+    } else {
+        /* Pants. I don't think that it should be possible to get here. */
+	Perl_croak_nocontext("Usage: CODE(0x%" UVxf ")(%s)", PTR2UV(cv), params);
+    }
+}
+#undef  PERL_ARGS_ASSERT_CROAK_XS_USAGE
+
+#define croak_xs_usage        S_croak_xs_usage
+
+#endif
+
+/* NOTE: the prototype of newXSproto() is different in versions of perls,
+ * so we define a portable version of newXSproto()
+ */
+#ifdef newXS_flags
+#define newXSproto_portable(name, c_impl, file, proto) newXS_flags(name, c_impl, file, proto, 0)
+#else
+#define newXSproto_portable(name, c_impl, file, proto) (PL_Sv=(SV*)newXS(name, c_impl, file), sv_setpv(PL_Sv, proto), (CV*)PL_Sv)
+#endif /* !defined(newXS_flags) */
+
+#if PERL_VERSION_LE(5, 21, 5)
+#  define newXS_deffile(a,b) Perl_newXS(aTHX_ a,b,file)
+#else
+#  define newXS_deffile(a,b) Perl_newXS_deffile(aTHX_ a,b)
+#endif
+
+#line 393 "Uni.c"
+
+XS_EUPXS(XS_JSON__Uni_err_consts); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni_err_consts)
+{
+    dVAR; dXSARGS;
+    if (items != 0)
+       croak_xs_usage(cv,  "");
+    {
+	SV *	RETVAL;
+#line 244 "Uni.xs"
+	RETVAL = newSVpv((void *)err_consts, sizeof(err_consts));
+#line 405 "Uni.c"
+	RETVAL = sv_2mortal(RETVAL);
+	ST(0) = RETVAL;
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_JSON__Uni_fmt_consts); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni_fmt_consts)
+{
+    dVAR; dXSARGS;
+    if (items != 0)
+       croak_xs_usage(cv,  "");
+    {
+	SV *	RETVAL;
+#line 251 "Uni.xs"
+	RETVAL = newSVpv((void *)fmt_consts, sizeof(fmt_consts));
+#line 423 "Uni.c"
+	RETVAL = sv_2mortal(RETVAL);
+	ST(0) = RETVAL;
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_JSON__Uni_seq_consts); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni_seq_consts)
+{
+    dVAR; dXSARGS;
+    if (items != 0)
+       croak_xs_usage(cv,  "");
+    {
+	SV *	RETVAL;
+#line 258 "Uni.xs"
+	RETVAL = newSVpv((void *)seq_consts, sizeof(seq_consts));
+#line 441 "Uni.c"
+	RETVAL = sv_2mortal(RETVAL);
+	ST(0) = RETVAL;
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_JSON__Uni_path_consts); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni_path_consts)
+{
+    dVAR; dXSARGS;
+    if (items != 0)
+       croak_xs_usage(cv,  "");
+    {
+	SV *	RETVAL;
+#line 265 "Uni.xs"
+	RETVAL = newSVpv((void *)path_consts, sizeof(path_consts));
+#line 459 "Uni.c"
+	RETVAL = sv_2mortal(RETVAL);
+	ST(0) = RETVAL;
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_JSON__Uni_parser_consts); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni_parser_consts)
+{
+    dVAR; dXSARGS;
+    if (items != 0)
+       croak_xs_usage(cv,  "");
+    {
+	SV *	RETVAL;
+#line 272 "Uni.xs"
+	RETVAL = newSVpv((void *)parser_consts, sizeof(parser_consts));
+#line 477 "Uni.c"
+	RETVAL = sv_2mortal(RETVAL);
+	ST(0) = RETVAL;
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_JSON__Uni_parse_json); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni_parse_json)
+{
+    dVAR; dXSARGS;
+    if (items < 1 || items > 2)
+       croak_xs_usage(cv,  "data, on_error = &PL_sv_undef");
+    {
+	SV *	data = ST(0)
+;
+	SV *	on_error;
+#line 281 "Uni.xs"
+	struct uni_json_p_binding ours, *binds;
+        void *err_p;
+	uint8_t *d;
+        STRLEN len;
+#line 500 "Uni.c"
+	SV *	RETVAL;
+
+	if (items < 2)
+	    on_error = &PL_sv_undef;
+	else {
+	    on_error = ST(1)
+;
+	}
+#line 286 "Uni.xs"
+	d = SvPV(data, len);
+
+	if (SvOK(on_error)) {
+		err_p = on_error;
+
+		ours = default_perl_uj_parser_bindings;
+                ours.on_error = invoke_error_handler;
+                binds = &ours;
+	} else {
+		err_p = NULL;
+                binds = &default_perl_uj_parser_bindings;
+	}
+
+        RETVAL = uni_json_parse(d, len, binds, err_p);
+#line 524 "Uni.c"
+	RETVAL = sv_2mortal(RETVAL);
+	ST(0) = RETVAL;
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_JSON__Uni_parse_json_iter); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni_parse_json_iter)
+{
+    dVAR; dXSARGS;
+    if (items < 1 || items > 2)
+       croak_xs_usage(cv,  "data, on_error = &PL_sv_undef");
+    {
+	SV *	data = ST(0)
+;
+	SV *	on_error;
+#line 308 "Uni.xs"
+	struct uni_json_p_binding ours, *binds;
+        void *err_p;
+	uint8_t *d;
+        STRLEN len;
+#line 547 "Uni.c"
+	SV *	RETVAL;
+
+	if (items < 2)
+	    on_error = &PL_sv_undef;
+	else {
+	    on_error = ST(1)
+;
+	}
+#line 313 "Uni.xs"
+	d = SvPV(data, len);
+
+	if (SvOK(on_error)) {
+		err_p = on_error;
+
+		ours = default_perl_uj_parser_bindings;
+                ours.on_error = invoke_error_handler;
+                binds = &ours;
+	} else {
+		err_p = NULL;
+                binds = &default_perl_uj_parser_bindings;
+	}
+
+        RETVAL = uni_json_parse_iter(d, len, binds, err_p);
+#line 571 "Uni.c"
+	RETVAL = sv_2mortal(RETVAL);
+	ST(0) = RETVAL;
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_JSON__Uni_parse_json_tape); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni_parse_json_tape)
+{
+    dVAR; dXSARGS;
+    if (items < 1 || items > 2)
+       croak_xs_usage(cv,  "data, on_error = &PL_sv_undef");
+    {
+	SV *	data = ST(0)
+;
+	SV *	on_error;
+#line 335 "Uni.xs"
+	struct uni_json_p_binding ours, *binds;
+        void *err_p;
+	uint8_t *d;
+        STRLEN len;
+#line 594 "Uni.c"
+	SV *	RETVAL;
+
+	if (items < 2)
+	    on_error = &PL_sv_undef;
+	else {
+	    on_error = ST(1)
+;
+	}
+#line 340 "Uni.xs"
+	d = SvPV(data, len);
+
+	if (SvOK(on_error)) {
+		err_p = on_error;
+
+		ours = default_perl_uj_parser_bindings;
+                ours.on_error = invoke_error_handler;
+                binds = &ours;
+	} else {
+		err_p = NULL;
+                binds = &default_perl_uj_parser_bindings;
+	}
+
+        RETVAL = uni_json_parse_tape(d, len, binds, err_p);
+#line 618 "Uni.c"
+	RETVAL = sv_2mortal(RETVAL);
+	ST(0) = RETVAL;
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_JSON__Uni_parse_json_seq); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni_parse_json_seq)
+{
+    dVAR; dXSARGS;
+    if (items < 2 || items > 4)
+       croak_xs_usage(cv,  "data, on_value, on_error = &PL_sv_undef, flags = 0");
+    {
+	SV *	data = ST(0)
+;
+	SV *	on_value = ST(1)
+;
+	SV *	on_error;
+	unsigned	flags;
+#line 364 "Uni.xs"
+	struct uni_json_p_binding ours;
+        SV *cbs[2];
+	uint8_t *d;
+        STRLEN len;
+#line 644 "Uni.c"
+	IV	RETVAL;
+	dXSTARG;
+
+	if (items < 3)
+	    on_error = &PL_sv_undef;
+	else {
+	    on_error = ST(2)
+;
+	}
+
+	if (items < 4)
+	    flags = 0;
+	else {
+	    flags = (unsigned)SvUV(ST(3))
+;
+	}
+#line 369 "Uni.xs"
+	d = SvPV(data, len);
+
+	ours = default_perl_uj_parser_bindings;
+	if (SvOK(on_error)) ours.on_error = invoke_seq_error_handler;
+
+	cbs[0] = on_value;
+        cbs[1] = on_error;
+        CLEAR_ERRSV();
+        RETVAL = uni_json_parse_seq(d, len, &ours, invoke_value_handler, cbs, flags);
+        if (SvTRUE(ERRSV)) croak_sv(ERRSV);
+        if (RETVAL == -1) XSRETURN_UNDEF;
+#line 673 "Uni.c"
+	XSprePUSH;
+	PUSHi((IV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_JSON__Uni_parse_json_paths); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni_parse_json_paths)
+{
+    dVAR; dXSARGS;
+    if (items < 2 || items > 4)
+       croak_xs_usage(cv,  "data, path_list, on_error = &PL_sv_undef, flags = 0");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+	SV *	data = ST(0)
+;
+	AV *	path_list;
+	SV *	on_error;
+	unsigned	flags;
+#line 390 "Uni.xs"
+	struct uni_json_p_binding ours;
+        struct paths paths;
+        char **ptrs;
+        unsigned n, i;
+	uint8_t *d;
+        STRLEN len;
+        SV **svp;
+        int rc;
+#line 704 "Uni.c"
+
+	STMT_START {
+		SV* const xsub_tmp_sv = ST(1);
+		SvGETMAGIC(xsub_tmp_sv);
+		if (SvROK(xsub_tmp_sv) && SvTYPE(SvRV(xsub_tmp_sv)) == SVt_PVAV){
+		    path_list = (AV*)SvRV(xsub_tmp_sv);
+		}
+		else{
+		    Perl_croak_nocontext("%s: %s is not an ARRAY reference",
+				"JSON::Uni::parse_json_paths",
+				"path_list");
+		}
+	} STMT_END
+;
+
+	if (items < 3)
+	    on_error = &PL_sv_undef;
+	else {
+	    on_error = ST(2)
+;
+	}
+
+	if (items < 4)
+	    flags = 0;
+	else {
+	    flags = (unsigned)SvUV(ST(3))
+;
+	}
+#line 399 "Uni.xs"
+	d = SvPV(data, len);
+
+	n = av_count(path_list);
+        Newx(ptrs, n, char *);
+        SAVEFREEPV(ptrs);
+        Newxz(paths.wild, n, char);
+        SAVEFREEPV(paths.wild);
+
+        /*  mortal so that it's freed if the error handler dies */
+        paths.res = (AV *)sv_2mortal((SV *)newAV());
+        av_extend(paths.res, n);
+        paths.on_error = SvOK(on_error) ? on_error : NULL;
+
+        for (i = 0; i < n; ++i) {
+		svp = av_fetch(path_list, i, 0);
+        	ptrs[i] = svp ? SvPVutf8_nolen(*svp) : "";
+
+                if (has_wildcard(ptrs[i])) {
+                	paths.wild[i] = 1;
+                        av_store(paths.res, i, newRV_noinc((SV *)newAV()));
+                }
+        }
+
+	ours = default_perl_uj_parser_bindings;
+        ours.on_error = invoke_paths_error_handler;
+        rc = uni_json_parse_paths(d, len, &ours, ptrs, n, store_path_value, &paths, flags);
+        if (rc == -1) XSRETURN_EMPTY;
+
+	EXTEND(SP, n);
+        for (i = 0; i < n; ++i) {
+        	svp = av_fetch(paths.res, i, 0);
+                PUSHs(svp ? *svp : &PL_sv_undef);
+        }
+#line 767 "Uni.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_JSON__Uni_is_valid_json); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni_is_valid_json)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "data");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+	SV *	data = ST(0)
+;
+#line 437 "Uni.xs"
+	unsigned code;
+        size_t pos;
+	uint8_t *d;
+        STRLEN len;
+#line 790 "Uni.c"
+#line 442 "Uni.xs"
+	d = SvPV(data, len);
+
+	if (uni_json_validate(d, len, &code, &pos)) XSRETURN_YES;
+	if (GIMME_V != G_ARRAY) XSRETURN_NO;
+
+	EXTEND(SP, 3);
+        PUSHs(&PL_sv_no);
+        mPUSHu(code);
+        mPUSHu(pos);
+#line 801 "Uni.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_JSON__Uni_parse_json_events); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni_parse_json_events)
+{
+    dVAR; dXSARGS;
+    if (items != 2)
+       croak_xs_usage(cv,  "data, handlers");
+    {
+	SV *	data = ST(0)
+;
+	HV *	handlers;
+#line 457 "Uni.xs"
+	uint8_t *d;
+        STRLEN len;
+        int rc;
+#line 822 "Uni.c"
+	SV *	RETVAL;
+
+	STMT_START {
+		SV* const xsub_tmp_sv = ST(1);
+		SvGETMAGIC(xsub_tmp_sv);
+		if (SvROK(xsub_tmp_sv) && SvTYPE(SvRV(xsub_tmp_sv)) == SVt_PVHV){
+		    handlers = (HV*)SvRV(xsub_tmp_sv);
+		}
+		else{
+		    Perl_croak_nocontext("%s: %s is not a HASH reference",
+				"JSON::Uni::parse_json_events",
+				"handlers");
+		}
+	} STMT_END
+;
+#line 461 "Uni.xs"
+	d = SvPV(data, len);
+
+	rc = perl_uj_parse_events(d, len, handlers);
+        if (rc == -1) XSRETURN_UNDEF;
+
+	RETVAL = newSViv(rc);
+#line 845 "Uni.c"
+	RETVAL = sv_2mortal(RETVAL);
+	ST(0) = RETVAL;
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_JSON__Uni_json_ec_2_msg); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni_json_ec_2_msg)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "ec");
+    {
+	UV	ec = (UV)SvUV(ST(0))
+;
+	char *	RETVAL;
+	dXSTARG;
+#line 474 "Uni.xs"
+	RETVAL = uni_json_ec_2_msg(ec);
+#line 866 "Uni.c"
+	sv_setpv(TARG, RETVAL);
+	XSprePUSH;
+	PUSHTARG;
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_JSON__Uni_max_nesting); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni_max_nesting)
+{
+    dVAR; dXSARGS;
+    if (items != 0)
+       croak_xs_usage(cv,  "");
+    {
+	unsigned	RETVAL;
+	dXSTARG;
+#line 481 "Uni.xs"
+	RETVAL = uni_json_max_nesting;
+#line 886 "Uni.c"
+	XSprePUSH;
+	PUSHu((UV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_JSON__Uni_set_max_nesting); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni_set_max_nesting)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "max");
+    {
+	unsigned	max = (unsigned)SvUV(ST(0))
+;
+#line 489 "Uni.xs"
+	uni_json_max_nesting = max;
+#line 905 "Uni.c"
+    }
+    XSRETURN_EMPTY;
+}
+
+
+XS_EUPXS(XS_JSON__Uni_json_serialize); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni_json_serialize)
+{
+    dVAR; dXSARGS;
+    if (items < 1 || items > 2)
+       croak_xs_usage(cv,  "val, fmt = UJ_FMT_FAST");
+    {
+	SV *	val = ST(0)
+;
+	int	fmt;
+#line 496 "Uni.xs"
+        SV * out;
+#line 923 "Uni.c"
+	SV *	RETVAL;
+
+	if (items < 2)
+	    fmt = UJ_FMT_FAST;
+	else {
+	    fmt = (int)SvIV(ST(1))
+;
+	}
+#line 498 "Uni.xs"
+	out = newSV(INIT_BUF_SIZE);
+	SvPOK_on(out);
+	SvUTF8_on(out);
+
+	uni_json_serialize(val, out, &default_perl_uj_serializer_bindings, fmt);
+
+	RETVAL = out;
+#line 940 "Uni.c"
+	RETVAL = sv_2mortal(RETVAL);
+	ST(0) = RETVAL;
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_JSON__Uni_json_serialize_fd); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni_json_serialize_fd)
+{
+    dVAR; dXSARGS;
+    if (items < 2 || items > 3)
+       croak_xs_usage(cv,  "val, fh, fmt = UJ_FMT_FAST");
+    PERL_UNUSED_VAR(ax); /* -Wall */
+    SP -= items;
+    {
+	SV *	val = ST(0)
+;
+	SV *	fh = ST(1)
+;
+	int	fmt;
+#line 514 "Uni.xs"
+	PerlIO *io;
+        int fd;
+#line 965 "Uni.c"
+
+	if (items < 3)
+	    fmt = UJ_FMT_FAST;
+	else {
+	    fmt = (int)SvIV(ST(2))
+;
+	}
+#line 517 "Uni.xs"
+	if (!SvROK(fh) && SvIOK(fh))
+		fd = SvIV(fh);
+	else {
+		io = IoOFP(sv_2io(fh));
+		if (!io) {
+			errno = EBADF;
+			XSRETURN_UNDEF;
+		}
+
+		PerlIO_flush(io);
+		fd = PerlIO_fileno(io);
+	}
+
+	/*
+	  String data passed to the serializer are the buffers of the
+	  SVs in val or mortal copies and stay valid until this returns.
+	*/
+	if (uni_json_serialize_fd(val, fd, &default_perl_uj_serializer_bindings, fmt,
+				  UJ_FD_REF_DATA) == -1)
+		XSRETURN_UNDEF;
+
+	XSRETURN_YES;
+#line 996 "Uni.c"
+	PUTBACK;
+	return;
+    }
+}
+
+
+XS_EUPXS(XS_JSON__Uni__Feed_new); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni__Feed_new)
+{
+    dVAR; dXSARGS;
+    if (items < 1 || items > 2)
+       croak_xs_usage(cv,  "class, on_error = &PL_sv_undef");
+    {
+	char *	class = (char *)SvPV_nolen(ST(0))
+;
+	SV *	on_error;
+#line 547 "Uni.xs"
+	struct feed *feed;
+        void *err_p;
+#line 1016 "Uni.c"
+	SV *	RETVAL;
+
+	if (items < 2)
+	    on_error = &PL_sv_undef;
+	else {
+	    on_error = ST(1)
+;
+	}
+#line 550 "Uni.xs"
+	Newxz(feed, 1, struct feed);
+	feed->binds = default_perl_uj_parser_bindings;
+
+	if (SvOK(on_error)) {
+		feed->on_error = newSVsv(on_error);
+                feed->binds.on_error = invoke_error_handler;
+                err_p = feed->on_error;
+	} else
+		err_p = NULL;
+
+	feed->f = uni_json_feed_start(&feed->binds, err_p);
+        if (!feed->f) {
+		if (feed->on_error) SvREFCNT_dec(feed->on_error);
+                Safefree(feed);
+                croak("%s", uni_json_ec_2_msg(UJ_E_NO_MEM));
+	}
+
+	RETVAL = sv_setref_pv(newSV(0), class, feed);
+#line 1044 "Uni.c"
+	RETVAL = sv_2mortal(RETVAL);
+	ST(0) = RETVAL;
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_JSON__Uni__Feed_budget); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni__Feed_budget)
+{
+    dVAR; dXSARGS;
+    if (items != 2)
+       croak_xs_usage(cv,  "self, budget");
+    {
+	SV *	self = ST(0)
+;
+	UV	budget = (UV)SvUV(ST(1))
+;
+#line 576 "Uni.xs"
+	uni_json_feed_budget(get_feed(self)->f, budget);
+#line 1065 "Uni.c"
+    }
+    XSRETURN_EMPTY;
+}
+
+
+XS_EUPXS(XS_JSON__Uni__Feed_feed); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni__Feed_feed)
+{
+    dVAR; dXSARGS;
+    if (items != 2)
+       croak_xs_usage(cv,  "self, data");
+    {
+	SV *	self = ST(0)
+;
+	SV *	data = ST(1)
+;
+#line 583 "Uni.xs"
+	struct uni_json_feed *f;
+	struct feed *feed;
+	uint8_t *d;
+        STRLEN len;
+        size_t used;
+        int rc;
+#line 1089 "Uni.c"
+	UV	RETVAL;
+	dXSTARG;
+#line 590 "Uni.xs"
+	feed = get_feed(self);
+	d = SvPV(data, len);
+
+	/*
+	  The parser state is gone after an error. As the error
+	  handler might die, this must be recorded before calling
+	  the parser.
+	*/
+	f = feed->f;
+	feed->f = NULL;
+
+	rc = uni_json_feed(f, d, len, &used);
+        if (rc == -1) XSRETURN_UNDEF;
+
+	feed->f = f;
+        RETVAL = used;
+#line 1109 "Uni.c"
+	XSprePUSH;
+	PUSHu((UV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_JSON__Uni__Feed_finish); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni__Feed_finish)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	SV *	self = ST(0)
+;
+#line 613 "Uni.xs"
+	struct uni_json_feed *f;
+	struct feed *feed;
+#line 1129 "Uni.c"
+	SV *	RETVAL;
+#line 616 "Uni.xs"
+	feed = get_feed(self);
+
+	f = feed->f;
+	feed->f = NULL;
+
+	RETVAL = uni_json_feed_finish(f);
+        if (!RETVAL) XSRETURN_UNDEF;
+#line 1139 "Uni.c"
+	RETVAL = sv_2mortal(RETVAL);
+	ST(0) = RETVAL;
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_JSON__Uni__Feed_DESTROY); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni__Feed_DESTROY)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	SV *	self = ST(0)
+;
+#line 630 "Uni.xs"
+	struct feed *feed;
+#line 1158 "Uni.c"
+#line 632 "Uni.xs"
+	feed = INT2PTR(struct feed *, SvIV(SvRV(self)));
+
+	if (feed->f) uni_json_feed_abort(feed->f);
+        if (feed->on_error) SvREFCNT_dec(feed->on_error);
+        Safefree(feed);
+#line 1165 "Uni.c"
+    }
+    XSRETURN_EMPTY;
+}
+
+
+XS_EUPXS(XS_JSON__Uni__Pull_new); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni__Pull_new)
+{
+    dVAR; dXSARGS;
+    if (items < 2 || items > 3)
+       croak_xs_usage(cv,  "class, val, fmt = UJ_FMT_FAST");
+    {
+	char *	class = (char *)SvPV_nolen(ST(0))
+;
+	SV *	val = ST(1)
+;
+	int	fmt;
+#line 646 "Uni.xs"
+	struct pull *pull;
+#line 1185 "Uni.c"
+	SV *	RETVAL;
+
+	if (items < 3)
+	    fmt = UJ_FMT_FAST;
+	else {
+	    fmt = (int)SvIV(ST(2))
+;
+	}
+#line 648 "Uni.xs"
+	Newxz(pull, 1, struct pull);
+	pull->val = newSVsv(val);
+
+	pull->pl = uni_json_pull_start(&default_perl_uj_pull_bindings, pull->val, fmt);
+	if (!pull->pl) {
+		SvREFCNT_dec(pull->val);
+		Safefree(pull);
+		croak("%s", uni_json_ec_2_msg(UJ_E_NO_MEM));
+	}
+
+	RETVAL = sv_setref_pv(newSV(0), class, pull);
+#line 1206 "Uni.c"
+	RETVAL = sv_2mortal(RETVAL);
+	ST(0) = RETVAL;
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_JSON__Uni__Pull_next); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni__Pull_next)
+{
+    dVAR; dXSARGS;
+    if (items < 1 || items > 2)
+       croak_xs_usage(cv,  "self, max = 65536");
+    {
+	SV *	self = ST(0)
+;
+	UV	max;
+#line 667 "Uni.xs"
+	struct pull *pull;
+        size_t used;
+        int rc;
+#line 1228 "Uni.c"
+	SV *	RETVAL;
+
+	if (items < 2)
+	    max = 65536;
+	else {
+	    max = (UV)SvUV(ST(1))
+;
+	}
+#line 671 "Uni.xs"
+	pull = INT2PTR(struct pull *, SvIV(SvRV(self)));
+	if (!pull->pl) XSRETURN_UNDEF;
+	if (!max) max = 1;
+
+	RETVAL = newSV(max);
+	SvPOK_on(RETVAL);
+
+	rc = uni_json_pull(pull->pl, SvPVX(RETVAL), max, &used);
+	if (rc == -1) {
+		SvREFCNT_dec(RETVAL);
+		croak("%s", uni_json_ec_2_msg(UJ_E_NO_MEM));
+	}
+
+	if (rc == 0) {
+		uni_json_pull_free(pull->pl);
+		pull->pl = NULL;
+
+		if (!used) {
+			SvREFCNT_dec(RETVAL);
+			XSRETURN_UNDEF;
+		}
+	}
+
+	SvCUR_set(RETVAL, used);
+	*SvEND(RETVAL) = 0;
+#line 1263 "Uni.c"
+	RETVAL = sv_2mortal(RETVAL);
+	ST(0) = RETVAL;
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_JSON__Uni__Pull_DESTROY); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni__Pull_DESTROY)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	SV *	self = ST(0)
+;
+#line 703 "Uni.xs"
+	struct pull *pull;
+#line 1282 "Uni.c"
+#line 705 "Uni.xs"
+	pull = INT2PTR(struct pull *, SvIV(SvRV(self)));
+
+	if (pull->pl) uni_json_pull_free(pull->pl);
+	SvREFCNT_dec(pull->val);
+	Safefree(pull);
+#line 1289 "Uni.c"
+    }
+    XSRETURN_EMPTY;
+}
+
+
+XS_EUPXS(XS_JSON__Uni__Parser_new); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni__Parser_new)
+{
+    dVAR; dXSARGS;
+    if (items < 1 || items > 3)
+       croak_xs_usage(cv,  "class, max_nesting = -1, flags = 0");
+    {
+	char *	class = (char *)SvPV_nolen(ST(0))
+;
+	unsigned	max_nesting;
+	unsigned	flags;
+#line 719 "Uni.xs"
+	struct parser *parser;
+#line 1308 "Uni.c"
+	SV *	RETVAL;
+
+	if (items < 2)
+	    max_nesting = -1;
+	else {
+	    max_nesting = (unsigned)SvUV(ST(1))
+;
+	}
+
+	if (items < 3)
+	    flags = 0;
+	else {
+	    flags = (unsigned)SvUV(ST(2))
+;
+	}
+#line 721 "Uni.xs"
+	Newxz(parser, 1, struct parser);
+	parser->binds = default_perl_uj_parser_bindings;
+        parser->binds.on_error = invoke_any_error_handler;
+
+	parser->p = uni_json_parser_new(&parser->binds);
+        if (!parser->p) {
+                Safefree(parser);
+                croak("%s", uni_json_ec_2_msg(UJ_E_NO_MEM));
+	}
+
+	uni_json_parser_set_max_nesting(parser->p, max_nesting);
+        set_parser_flags(parser, flags);
+
+	RETVAL = sv_setref_pv(newSV(0), class, parser);
+#line 1339 "Uni.c"
+	RETVAL = sv_2mortal(RETVAL);
+	ST(0) = RETVAL;
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_JSON__Uni__Parser_parse); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni__Parser_parse)
+{
+    dVAR; dXSARGS;
+    if (items < 2 || items > 3)
+       croak_xs_usage(cv,  "self, data, on_error = &PL_sv_undef");
+    {
+	SV *	self = ST(0)
+;
+	SV *	data = ST(1)
+;
+	SV *	on_error;
+#line 744 "Uni.xs"
+	struct parser *parser;
+	uint8_t *d;
+        STRLEN len;
+#line 1363 "Uni.c"
+	SV *	RETVAL;
+
+	if (items < 3)
+	    on_error = &PL_sv_undef;
+	else {
+	    on_error = ST(2)
+;
+	}
+#line 748 "Uni.xs"
+	parser = get_parser(self);
+
+        /*  strings are unescaped in the text itself */
+        if (parser->binds.span_flags & UJ_SPAN_IN_SITU)
+		d = SvPV_force(data, len);
+	else
+		d = SvPV(data, len);
+
+	RETVAL = uni_json_parser_parse(parser->p, d, len,
+                                       SvOK(on_error) ? on_error : NULL);
+        if (!RETVAL) XSRETURN_UNDEF;
+#line 1384 "Uni.c"
+	RETVAL = sv_2mortal(RETVAL);
+	ST(0) = RETVAL;
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_JSON__Uni__Parser_max_nesting); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni__Parser_max_nesting)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	SV *	self = ST(0)
+;
+	unsigned	RETVAL;
+	dXSTARG;
+#line 766 "Uni.xs"
+	RETVAL = uni_json_parser_max_nesting(get_parser(self)->p);
+#line 1405 "Uni.c"
+	XSprePUSH;
+	PUSHu((UV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_JSON__Uni__Parser_set_max_nesting); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni__Parser_set_max_nesting)
+{
+    dVAR; dXSARGS;
+    if (items != 2)
+       croak_xs_usage(cv,  "self, max");
+    {
+	SV *	self = ST(0)
+;
+	unsigned	max = (unsigned)SvUV(ST(1))
+;
+#line 775 "Uni.xs"
+	uni_json_parser_set_max_nesting(get_parser(self)->p, max);
+#line 1426 "Uni.c"
+    }
+    XSRETURN_EMPTY;
+}
+
+
+XS_EUPXS(XS_JSON__Uni__Parser_flags); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni__Parser_flags)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	SV *	self = ST(0)
+;
+	unsigned	RETVAL;
+	dXSTARG;
+#line 781 "Uni.xs"
+	RETVAL = uni_json_parser_flags(get_parser(self)->p);
+#line 1445 "Uni.c"
+	XSprePUSH;
+	PUSHu((UV)RETVAL);
+    }
+    XSRETURN(1);
+}
+
+
+XS_EUPXS(XS_JSON__Uni__Parser_set_flags); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni__Parser_set_flags)
+{
+    dVAR; dXSARGS;
+    if (items != 2)
+       croak_xs_usage(cv,  "self, flags");
+    {
+	SV *	self = ST(0)
+;
+	unsigned	flags = (unsigned)SvUV(ST(1))
+;
+#line 790 "Uni.xs"
+	set_parser_flags(get_parser(self), flags);
+#line 1466 "Uni.c"
+    }
+    XSRETURN_EMPTY;
+}
+
+
+XS_EUPXS(XS_JSON__Uni__Parser_DESTROY); /* prototype to pass -Wmissing-prototypes */
+XS_EUPXS(XS_JSON__Uni__Parser_DESTROY)
+{
+    dVAR; dXSARGS;
+    if (items != 1)
+       croak_xs_usage(cv,  "self");
+    {
+	SV *	self = ST(0)
+;
+#line 796 "Uni.xs"
+	struct parser *parser;
+#line 1483 "Uni.c"
+#line 798 "Uni.xs"
+	parser = get_parser(self);
+
+	uni_json_parser_free(parser->p);
+        Safefree(parser);
+#line 1489 "Uni.c"
+    }
+    XSRETURN_EMPTY;
+}
+
+#ifdef __cplusplus
+extern "C"
+#endif
+XS_EXTERNAL(boot_JSON__Uni); /* prototype to pass -Wmissing-prototypes */
+XS_EXTERNAL(boot_JSON__Uni)
+{
+#if PERL_VERSION_LE(5, 21, 5)
+    dVAR; dXSARGS;
+#else
+    dVAR; dXSBOOTARGSXSAPIVERCHK;
+#endif
+#if PERL_VERSION_LE(5, 8, 999) /* PERL_VERSION_LT is 5.33+ */
+    char* file = __FILE__;
+#else
+    const char* file = __FILE__;
+#endif
+
+    PERL_UNUSED_VAR(file);
+
+    PERL_UNUSED_VAR(cv); /* -W */
+    PERL_UNUSED_VAR(items); /* -W */
+#if PERL_VERSION_LE(5, 21, 5)
+    XS_VERSION_BOOTCHECK;
+#  ifdef XS_APIVERSION_BOOTCHECK
+    XS_APIVERSION_BOOTCHECK;
+#  endif
+#endif
+
+        newXS_deffile("JSON::Uni::err_consts", XS_JSON__Uni_err_consts);
+        newXS_deffile("JSON::Uni::fmt_consts", XS_JSON__Uni_fmt_consts);
+        newXS_deffile("JSON::Uni::seq_consts", XS_JSON__Uni_seq_consts);
+        newXS_deffile("JSON::Uni::path_consts", XS_JSON__Uni_path_consts);
+        newXS_deffile("JSON::Uni::parser_consts", XS_JSON__Uni_parser_consts);
+        newXS_deffile("JSON::Uni::parse_json", XS_JSON__Uni_parse_json);
+        newXS_deffile("JSON::Uni::parse_json_iter", XS_JSON__Uni_parse_json_iter);
+        newXS_deffile("JSON::Uni::parse_json_tape", XS_JSON__Uni_parse_json_tape);
+        newXS_deffile("JSON::Uni::parse_json_seq", XS_JSON__Uni_parse_json_seq);
+        newXS_deffile("JSON::Uni::parse_json_paths", XS_JSON__Uni_parse_json_paths);
+        newXS_deffile("JSON::Uni::is_valid_json", XS_JSON__Uni_is_valid_json);
+        newXS_deffile("JSON::Uni::parse_json_events", XS_JSON__Uni_parse_json_events);
+        newXS_deffile("JSON::Uni::json_ec_2_msg", XS_JSON__Uni_json_ec_2_msg);
+        newXS_deffile("JSON::Uni::max_nesting", XS_JSON__Uni_max_nesting);
+        newXS_deffile("JSON::Uni::set_max_nesting", XS_JSON__Uni_set_max_nesting);
+        newXS_deffile("JSON::Uni::json_serialize", XS_JSON__Uni_json_serialize);
+        newXS_deffile("JSON::Uni::json_serialize_fd", XS_JSON__Uni_json_serialize_fd);
+        newXS_deffile("JSON::Uni::Feed::new", XS_JSON__Uni__Feed_new);
+        newXS_deffile("JSON::Uni::Feed::budget", XS_JSON__Uni__Feed_budget);
+        newXS_deffile("JSON::Uni::Feed::feed", XS_JSON__Uni__Feed_feed);
+        newXS_deffile("JSON::Uni::Feed::finish", XS_JSON__Uni__Feed_finish);
+        newXS_deffile("JSON::Uni::Feed::DESTROY", XS_JSON__Uni__Feed_DESTROY);
+        newXS_deffile("JSON::Uni::Pull::new", XS_JSON__Uni__Pull_new);
+        newXS_deffile("JSON::Uni::Pull::next", XS_JSON__Uni__Pull_next);
+        newXS_deffile("JSON::Uni::Pull::DESTROY", XS_JSON__Uni__Pull_DESTROY);
+        newXS_deffile("JSON::Uni::Parser::new", XS_JSON__Uni__Parser_new);
+        newXS_deffile("JSON::Uni::Parser::parse", XS_JSON__Uni__Parser_parse);
+        newXS_deffile("JSON::Uni::Parser::max_nesting", XS_JSON__Uni__Parser_max_nesting);
+        newXS_deffile("JSON::Uni::Parser::set_max_nesting", XS_JSON__Uni__Parser_set_max_nesting);
+        newXS_deffile("JSON::Uni::Parser::flags", XS_JSON__Uni__Parser_flags);
+        newXS_deffile("JSON::Uni::Parser::set_flags", XS_JSON__Uni__Parser_set_flags);
+        newXS_deffile("JSON::Uni::Parser::DESTROY", XS_JSON__Uni__Parser_DESTROY);
+#if PERL_VERSION_LE(5, 21, 5)
+#  if PERL_VERSION_GE(5, 9, 0)
+    if (PL_unitcheckav)
+        call_list(PL_scopestack_ix, PL_unitcheckav);
+#  endif
+    XSRETURN_YES;
+#else
+    Perl_xs_boot_epilog(aTHX_ ax);
+#endif
+}
+
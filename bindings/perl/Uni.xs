@@ -21,19 +21,47 @@ enum {
     INIT_BUF_SIZE = 128
 };
 
+enum {
+    UJ_P_IN_SITU = 1 << 16      /* parser objects may modify the text */
+};
+
 /*  types */
 struct a_const {
     char *n;
     uint64_t v;
 };
 
+struct feed {
+    struct uni_json_feed *f;
+    struct uni_json_p_binding binds;
+    SV *on_error;
+};
+
+struct parser {
+    struct uni_json_parser *p;
+    struct uni_json_p_binding binds;
+};
+
+struct pull {
+    struct uni_json_pull *pl;
+    SV *val;                    /* copy of the value being serialized */
+};
+
+struct paths {
+    AV *res;
+    char *wild;                 /* path i contains a * segment */
+    SV *on_error;
+};
+
 /*  prototypes */
 void *parse(uint8_t *, size_t);
+int perl_uj_parse_events(uint8_t *, size_t, HV *);
 SV *serialize(SV *, int);
 
 /*  variables */
 extern struct uni_json_p_binding default_perl_uj_parser_bindings;
 extern struct uni_json_s_binding default_perl_uj_serializer_bindings;
+extern struct uni_json_s_binding default_perl_uj_pull_bindings;
 
 #define n_(x) { .n = #x, .v = x }
 
@@ -52,7 +80,9 @@ static struct a_const err_consts[] = {
     n_(UJ_E_INV_ESC),
     n_(UJ_E_INV_KEY),
     n_(UJ_E_NO_KEY),
-    n_(UJ_E_TOO_DEEP)
+    n_(UJ_E_TOO_DEEP),
+    n_(UJ_E_NO_MEM),
+    n_(UJ_E_INV_PATH)
 };
 
 static struct a_const fmt_consts[] = {
@@ -61,8 +91,36 @@ static struct a_const fmt_consts[] = {
     n_(UJ_FMT_PRETTY)
 };
 
+static struct a_const seq_consts[] = {
+    n_(UJ_SEQ_RESYNC)
+};
+
+static struct a_const path_consts[] = {
+    n_(UJ_PATH_NO_VALIDATE)
+};
+
+static struct a_const parser_consts[] = {
+    n_(UJ_P_ITER),
+    n_(UJ_P_TAPE),
+    n_(UJ_P_IN_SITU)
+};
+
 #undef n_
 
+static void set_parser_flags(struct parser *parser, unsigned flags)
+{
+    /*
+      UJ_P_IN_SITU is handled here. The library ignores it in the
+      flags of the handle.
+    */
+    if (flags & UJ_P_IN_SITU)
+        parser->binds.span_flags |= UJ_SPAN_IN_SITU;
+    else
+        parser->binds.span_flags &= ~UJ_SPAN_IN_SITU;
+
+    uni_json_parser_set_flags(parser->p, flags);
+}
+
 static void invoke_error_handler(unsigned code, size_t pos, void *p)
 {
     dTHX;
@@ -83,6 +141,100 @@ static void invoke_error_handler(unsigned code, size_t pos, void *p)
     LEAVE;
 }
 
+static struct feed *get_feed(SV *self)
+{
+    dTHX;
+    struct feed *feed;
+
+    feed = INT2PTR(struct feed *, SvIV(SvRV(self)));
+    if (!feed->f) croak("feed already finished");
+    return feed;
+}
+
+static void invoke_any_error_handler(unsigned code, size_t pos, void *p)
+{
+    /*
+      Error handler for parser objects. These are created once,
+      hence, the handler argument of a parse call is passed as
+      error pointer. The default handler is used without one.
+    */
+    if (p)
+        invoke_error_handler(code, pos, p);
+    else
+        default_perl_uj_parser_bindings.on_error(code, pos, NULL);
+}
+
+static struct parser *get_parser(SV *self)
+{
+    dTHX;
+    return INT2PTR(struct parser *, SvIV(SvRV(self)));
+}
+
+static int invoke_value_handler(void *val, size_t pos, void *p)
+{
+    dTHX;
+    dSP;
+
+    ENTER;
+    SAVETMPS;
+
+    PUSHMARK(SP);
+    EXTEND(SP, 2);
+    PUSHs(sv_2mortal(val));
+    PUSHs(sv_2mortal(newSVuv(pos)));
+    PUTBACK;
+
+    /*
+      The parser may hold references to interned keys. Hence, the
+      handler must not die while it's running.
+    */
+    call_sv(((SV **)p)[0], G_DISCARD | G_EVAL);
+
+    FREETMPS;
+    LEAVE;
+
+    return !SvTRUE(ERRSV);
+}
+
+static void invoke_seq_error_handler(unsigned code, size_t pos, void *p)
+{
+    invoke_error_handler(code, pos, ((SV **)p)[1]);
+}
+
+static int has_wildcard(char *p)
+{
+    while ((p = strstr(p, "/*")))
+        if (!*(p += 2) || *p == '/') return 1;
+
+    return 0;
+}
+
+static int store_path_value(unsigned path, void *val, size_t, void *p)
+{
+    /*
+      Values for paths with wildcards are collected in an array,
+      for other paths, a later value replaces an earlier one like
+      a duplicate key in a hash.
+    */
+    dTHX;
+    struct paths *paths;
+    SV **svp;
+
+    paths = p;
+    if (paths->wild[path]) {
+        svp = av_fetch(paths->res, path, 0);
+        av_push((AV *)SvRV(*svp), val);
+    } else
+        av_store(paths->res, path, val);
+
+    return 1;
+}
+
+static void invoke_paths_error_handler(unsigned code, size_t pos, void *p)
+{
+    invoke_any_error_handler(code, pos, ((struct paths *)p)->on_error);
+}
+
 /*  XS code */
 MODULE = JSON::Uni PACKAGE = JSON::Uni
 
@@ -100,6 +252,27 @@ CODE:
 OUTPUT:
 	RETVAL
 
+SV *
+seq_consts()
+CODE:
+	RETVAL = newSVpv((void *)seq_consts, sizeof(seq_consts));
+OUTPUT:
+	RETVAL
+
+SV *
+path_consts()
+CODE:
+	RETVAL = newSVpv((void *)path_consts, sizeof(path_consts));
+OUTPUT:
+	RETVAL
+
+SV *
+parser_consts()
+CODE:
+	RETVAL = newSVpv((void *)parser_consts, sizeof(parser_consts));
+OUTPUT:
+	RETVAL
+
 SV *
 parse_json(data, on_error = &PL_sv_undef)
 	SV * data
@@ -127,6 +300,173 @@ CODE:
 OUTPUT:
 	RETVAL
 
+SV *
+parse_json_iter(data, on_error = &PL_sv_undef)
+	SV * data
+        SV * on_error
+PREINIT:
+	struct uni_json_p_binding ours, *binds;
+        void *err_p;
+	uint8_t *d;
+        STRLEN len;
+CODE:
+	d = SvPV(data, len);
+
+	if (SvOK(on_error)) {
+		err_p = on_error;
+
+		ours = default_perl_uj_parser_bindings;
+                ours.on_error = invoke_error_handler;
+                binds = &ours;
+	} else {
+		err_p = NULL;
+                binds = &default_perl_uj_parser_bindings;
+	}
+
+        RETVAL = uni_json_parse_iter(d, len, binds, err_p);
+OUTPUT:
+	RETVAL
+
+SV *
+parse_json_tape(data, on_error = &PL_sv_undef)
+	SV * data
+        SV * on_error
+PREINIT:
+	struct uni_json_p_binding ours, *binds;
+        void *err_p;
+	uint8_t *d;
+        STRLEN len;
+CODE:
+	d = SvPV(data, len);
+
+	if (SvOK(on_error)) {
+		err_p = on_error;
+
+		ours = default_perl_uj_parser_bindings;
+                ours.on_error = invoke_error_handler;
+                binds = &ours;
+	} else {
+		err_p = NULL;
+                binds = &default_perl_uj_parser_bindings;
+	}
+
+        RETVAL = uni_json_parse_tape(d, len, binds, err_p);
+OUTPUT:
+	RETVAL
+
+IV
+parse_json_seq(data, on_value, on_error = &PL_sv_undef, flags = 0)
+	SV * data
+        SV * on_value
+        SV * on_error
+        unsigned flags
+PREINIT:
+	struct uni_json_p_binding ours;
+        SV *cbs[2];
+	uint8_t *d;
+        STRLEN len;
+CODE:
+	d = SvPV(data, len);
+
+	ours = default_perl_uj_parser_bindings;
+	if (SvOK(on_error)) ours.on_error = invoke_seq_error_handler;
+
+	cbs[0] = on_value;
+        cbs[1] = on_error;
+        CLEAR_ERRSV();
+        RETVAL = uni_json_parse_seq(d, len, &ours, invoke_value_handler, cbs, flags);
+        if (SvTRUE(ERRSV)) croak_sv(ERRSV);
+        if (RETVAL == -1) XSRETURN_UNDEF;
+OUTPUT:
+	RETVAL
+
+void
+parse_json_paths(data, path_list, on_error = &PL_sv_undef, flags = 0)
+	SV * data
+        AV * path_list
+        SV * on_error
+        unsigned flags
+PREINIT:
+	struct uni_json_p_binding ours;
+        struct paths paths;
+        char **ptrs;
+        unsigned n, i;
+	uint8_t *d;
+        STRLEN len;
+        SV **svp;
+        int rc;
+PPCODE:
+	d = SvPV(data, len);
+
+	n = av_count(path_list);
+        Newx(ptrs, n, char *);
+        SAVEFREEPV(ptrs);
+        Newxz(paths.wild, n, char);
+        SAVEFREEPV(paths.wild);
+
+        /*  mortal so that it's freed if the error handler dies */
+        paths.res = (AV *)sv_2mortal((SV *)newAV());
+        av_extend(paths.res, n);
+        paths.on_error = SvOK(on_error) ? on_error : NULL;
+
+        for (i = 0; i < n; ++i) {
+		svp = av_fetch(path_list, i, 0);
+        	ptrs[i] = svp ? SvPVutf8_nolen(*svp) : "";
+
+                if (has_wildcard(ptrs[i])) {
+                	paths.wild[i] = 1;
+                        av_store(paths.res, i, newRV_noinc((SV *)newAV()));
+                }
+        }
+
+	ours = default_perl_uj_parser_bindings;
+        ours.on_error = invoke_paths_error_handler;
+        rc = uni_json_parse_paths(d, len, &ours, ptrs, n, store_path_value, &paths, flags);
+        if (rc == -1) XSRETURN_EMPTY;
+
+	EXTEND(SP, n);
+        for (i = 0; i < n; ++i) {
+        	svp = av_fetch(paths.res, i, 0);
+                PUSHs(svp ? *svp : &PL_sv_undef);
+        }
+
+void
+is_valid_json(data)
+	SV * data
+PREINIT:
+	unsigned code;
+        size_t pos;
+	uint8_t *d;
+        STRLEN len;
+PPCODE:
+	d = SvPV(data, len);
+
+	if (uni_json_validate(d, len, &code, &pos)) XSRETURN_YES;
+	if (GIMME_V != G_ARRAY) XSRETURN_NO;
+
+	EXTEND(SP, 3);
+        PUSHs(&PL_sv_no);
+        mPUSHu(code);
+        mPUSHu(pos);
+
+SV *
+parse_json_events(data, handlers)
+	SV * data
+        HV * handlers
+PREINIT:
+	uint8_t *d;
+        STRLEN len;
+        int rc;
+CODE:
+	d = SvPV(data, len);
+
+	rc = perl_uj_parse_events(d, len, handlers);
+        if (rc == -1) XSRETURN_UNDEF;
+
+	RETVAL = newSViv(rc);
+OUTPUT:
+	RETVAL
+
 char *
 json_ec_2_msg(ec)
 	UV ec
@@ -164,3 +504,298 @@ CODE:
 	RETVAL = out;
 OUTPUT:
 	RETVAL
+
+void
+json_serialize_fd(val, fh, fmt = UJ_FMT_FAST)
+	SV * val
+        SV * fh
+        int fmt
+PREINIT:
+	PerlIO *io;
+        int fd;
+PPCODE:
+	if (!SvROK(fh) && SvIOK(fh))
+		fd = SvIV(fh);
+	else {
+		io = IoOFP(sv_2io(fh));
+		if (!io) {
+			errno = EBADF;
+			XSRETURN_UNDEF;
+		}
+
+		PerlIO_flush(io);
+		fd = PerlIO_fileno(io);
+	}
+
+	/*
+	  String data passed to the serializer are the buffers of the
+	  SVs in val or mortal copies and stay valid until this returns.
+	*/
+	if (uni_json_serialize_fd(val, fd, &default_perl_uj_serializer_bindings, fmt,
+				  UJ_FD_REF_DATA) == -1)
+		XSRETURN_UNDEF;
+
+	XSRETURN_YES;
+
+MODULE = JSON::Uni PACKAGE = JSON::Uni::Feed
+
+SV *
+new(class, on_error = &PL_sv_undef)
+	char * class
+        SV * on_error
+PREINIT:
+	struct feed *feed;
+        void *err_p;
+CODE:
+	Newxz(feed, 1, struct feed);
+	feed->binds = default_perl_uj_parser_bindings;
+
+	if (SvOK(on_error)) {
+		feed->on_error = newSVsv(on_error);
+                feed->binds.on_error = invoke_error_handler;
+                err_p = feed->on_error;
+	} else
+		err_p = NULL;
+
+	feed->f = uni_json_feed_start(&feed->binds, err_p);
+        if (!feed->f) {
+		if (feed->on_error) SvREFCNT_dec(feed->on_error);
+                Safefree(feed);
+                croak("%s", uni_json_ec_2_msg(UJ_E_NO_MEM));
+	}
+
+	RETVAL = sv_setref_pv(newSV(0), class, feed);
+OUTPUT:
+	RETVAL
+
+void
+budget(self, budget)
+	SV * self
+        UV budget
+CODE:
+	uni_json_feed_budget(get_feed(self)->f, budget);
+
+UV
+feed(self, data)
+	SV * self
+        SV * data
+PREINIT:
+	struct uni_json_feed *f;
+	struct feed *feed;
+	uint8_t *d;
+        STRLEN len;
+        size_t used;
+        int rc;
+CODE:
+	feed = get_feed(self);
+	d = SvPV(data, len);
+
+	/*
+	  The parser state is gone after an error. As the error
+	  handler might die, this must be recorded before calling
+	  the parser.
+	*/
+	f = feed->f;
+	feed->f = NULL;
+
+	rc = uni_json_feed(f, d, len, &used);
+        if (rc == -1) XSRETURN_UNDEF;
+
+	feed->f = f;
+        RETVAL = used;
+OUTPUT:
+	RETVAL
+
+SV *
+finish(self)
+	SV * self
+PREINIT:
+	struct uni_json_feed *f;
+	struct feed *feed;
+CODE:
+	feed = get_feed(self);
+
+	f = feed->f;
+	feed->f = NULL;
+
+	RETVAL = uni_json_feed_finish(f);
+        if (!RETVAL) XSRETURN_UNDEF;
+OUTPUT:
+	RETVAL
+
+void
+DESTROY(self)
+	SV * self
+PREINIT:
+	struct feed *feed;
+CODE:
+	feed = INT2PTR(struct feed *, SvIV(SvRV(self)));
+
+	if (feed->f) uni_json_feed_abort(feed->f);
+        if (feed->on_error) SvREFCNT_dec(feed->on_error);
+        Safefree(feed);
+
+MODULE = JSON::Uni PACKAGE = JSON::Uni::Pull
+
+SV *
+new(class, val, fmt = UJ_FMT_FAST)
+	char * class
+        SV * val
+        int fmt
+PREINIT:
+	struct pull *pull;
+CODE:
+	Newxz(pull, 1, struct pull);
+	pull->val = newSVsv(val);
+
+	pull->pl = uni_json_pull_start(&default_perl_uj_pull_bindings, pull->val, fmt);
+	if (!pull->pl) {
+		SvREFCNT_dec(pull->val);
+		Safefree(pull);
+		croak("%s", uni_json_ec_2_msg(UJ_E_NO_MEM));
+	}
+
+	RETVAL = sv_setref_pv(newSV(0), class, pull);
+OUTPUT:
+	RETVAL
+
+SV *
+next(self, max = 65536)
+	SV * self
+        UV max
+PREINIT:
+	struct pull *pull;
+        size_t used;
+        int rc;
+CODE:
+	pull = INT2PTR(struct pull *, SvIV(SvRV(self)));
+	if (!pull->pl) XSRETURN_UNDEF;
+	if (!max) max = 1;
+
+	RETVAL = newSV(max);
+	SvPOK_on(RETVAL);
+
+	rc = uni_json_pull(pull->pl, SvPVX(RETVAL), max, &used);
+	if (rc == -1) {
+		SvREFCNT_dec(RETVAL);
+		croak("%s", uni_json_ec_2_msg(UJ_E_NO_MEM));
+	}
+
+	if (rc == 0) {
+		uni_json_pull_free(pull->pl);
+		pull->pl = NULL;
+
+		if (!used) {
+			SvREFCNT_dec(RETVAL);
+			XSRETURN_UNDEF;
+		}
+	}
+
+	SvCUR_set(RETVAL, used);
+	*SvEND(RETVAL) = 0;
+OUTPUT:
+	RETVAL
+
+void
+DESTROY(self)
+	SV * self
+PREINIT:
+	struct pull *pull;
+CODE:
+	pull = INT2PTR(struct pull *, SvIV(SvRV(self)));
+
+	if (pull->pl) uni_json_pull_free(pull->pl);
+	SvREFCNT_dec(pull->val);
+	Safefree(pull);
+
+MODULE = JSON::Uni PACKAGE = JSON::Uni::Parser
+
+SV *
+new(class, max_nesting = -1, flags = 0)
+	char * class
+        unsigned max_nesting
+        unsigned flags
+PREINIT:
+	struct parser *parser;
+CODE:
+	Newxz(parser, 1, struct parser);
+	parser->binds = default_perl_uj_parser_bindings;
+        parser->binds.on_error = invoke_any_error_handler;
+
+	parser->p = uni_json_parser_new(&parser->binds);
+        if (!parser->p) {
+                Safefree(parser);
+                croak("%s", uni_json_ec_2_msg(UJ_E_NO_MEM));
+	}
+
+	uni_json_parser_set_max_nesting(parser->p, max_nesting);
+        set_parser_flags(parser, flags);
+
+	RETVAL = sv_setref_pv(newSV(0), class, parser);
+OUTPUT:
+	RETVAL
+
+SV *
+parse(self, data, on_error = &PL_sv_undef)
+	SV * self
+	SV * data
+        SV * on_error
+PREINIT:
+	struct parser *parser;
+	uint8_t *d;
+        STRLEN len;
+CODE:
+	parser = get_parser(self);
+
+        /*  strings are unescaped in the text itself */
+        if (parser->binds.span_flags & UJ_SPAN_IN_SITU)
+		d = SvPV_force(data, len);
+	else
+		d = SvPV(data, len);
+
+	RETVAL = uni_json_parser_parse(parser->p, d, len,
+                                       SvOK(on_error) ? on_error : NULL);
+        if (!RETVAL) XSRETURN_UNDEF;
+OUTPUT:
+	RETVAL
+
+unsigned
+max_nesting(self)
+	SV * self
+CODE:
+	RETVAL = uni_json_parser_max_nesting(get_parser(self)->p);
+OUTPUT:
+	RETVAL
+
+void
+set_max_nesting(self, max)
+	SV * self
+        unsigned max
+CODE:
+	uni_json_parser_set_max_nesting(get_parser(self)->p, max);
+
+unsigned
+flags(self)
+	SV * self
+CODE:
+	RETVAL = uni_json_parser_flags(get_parser(self)->p);
+OUTPUT:
+	RETVAL
+
+void
+set_flags(self, flags)
+	SV * self
+        unsigned flags
+CODE:
+	set_parser_flags(get_parser(self), flags);
+
+void
+DESTROY(self)
+	SV * self
+PREINIT:
+	struct parser *parser;
+CODE:
+	parser = get_parser(self);
+
+	uni_json_parser_free(parser->p);
+        Safefree(parser);
@@ -0,0 +1,394 @@
+# uni-json Perl bindings
+#
+# Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+#
+
+#*  code
+#
+package JSON::Uni;
+
+
+BEGIN {
+    use version; our $VERSION = version->declare('v0.1.0');
+
+    require DynaLoader;
+    our @ISA = 'DynaLoader';
+    __PACKAGE__->bootstrap();
+
+    my %h;
+
+    %h = unpack('(pQ)*', err_consts());
+    require constant;
+    constant->import(\%h);
+
+    %h = unpack('(pQ)*', fmt_consts());
+    require constant;
+    constant->import(\%h);
+
+    %h = unpack('(pQ)*', seq_consts());
+    require constant;
+    constant->import(\%h);
+
+    %h = unpack('(pQ)*', path_consts());
+    require constant;
+    constant->import(\%h);
+
+    %h = unpack('(pQ)*', parser_consts());
+    require constant;
+    constant->import(\%h);
+}
+
+use Exporter	'import';
+our @EXPORT_OK = qw(parse_json parse_json_iter parse_json_tape parse_json_paths parse_json_seq parse_json_events is_valid_json max_nesting set_max_nesting json_serialize json_serialize_fd json_ec_2_msg
+
+                    UJ_E_INV UJ_E_NO_VAL UJ_E_INV_LIT
+                    UJ_E_GARBAGE UJ_E_EOS UJ_E_INV_IN
+                    UJ_E_ADD UJ_E_LEADZ UJ_E_NO_DGS
+                    UJ_E_INV_CHAR UJ_E_INV_UTF8 UJ_E_INV_ESC
+                    UJ_E_INV_KEY UJ_E_NO_KEY UJ_E_TOO_DEEP
+                    UJ_E_NO_MEM UJ_E_INV_PATH
+
+                    UJ_FMT_FAST UJ_FMT_DET UJ_FMT_PRETTY
+
+                    UJ_SEQ_RESYNC
+
+                    UJ_PATH_NO_VALIDATE
+
+                    UJ_P_ITER UJ_P_TAPE UJ_P_IN_SITU
+                  );
+
+# Ach ja
+1;
+
+__END__
+
+=head1 NAME
+
+JSON::Uni - Perl interface to uni-json parser and serializer
+
+=head1 SYNOPSIS
+
+ use JSON::Uni	qw(parse_json parse_json_iter parse_json_tape parse_json_paths parse_json_seq parse_json_events is_valid_json max_nesting set_max_nesting json_serialize json_serialize_fd
+
+                   UJ_E_INV UJ_E_NO_VAL UJ_E_INV_LIT
+                   UJ_E_GARBAGE UJ_E_EOS UJ_E_INV_IN
+                   UJ_E_ADD UJ_E_LEADZ UJ_E_NO_DGS
+                   UJ_E_INV_CHAR UJ_E_INV_UTF8 UJ_E_INV_ESC
+                   UJ_E_INV_KEY UJ_E_NO_KEY UJ_E_TOO_DEEP
+                   UJ_E_NO_MEM UJ_E_INV_PATH
+
+                   UJ_FMT_FAST UJ_FMT_DET UJ_FMT_PRETTY
+
+                   UJ_SEQ_RESYNC
+
+                   UJ_PATH_NO_VALIDATE
+
+                   UJ_P_ITER UJ_P_TAPE UJ_P_IN_SITU);
+
+ my $obj = parse_json(<JSON string>[, <error handler>]);
+ my $obj = parse_json_iter(<JSON string>[, <error handler>]);
+ my $obj = parse_json_tape(<JSON string>[, <error handler>]);
+ my @values = parse_json_paths(<JSON string>, [<JSON pointer>, ...][, <error handler>[, <flags>]]);
+ my $n = parse_json_seq(<JSON strings>, <value handler>[, <error handler>[, <flags>]]);
+ my $rc = parse_json_events(<JSON string>, { <event> => <handler>, ... });
+ my $ok = is_valid_json(<JSON string>);
+ my ($ok, $code, $pos) = is_valid_json(<JSON string>);
+
+ my $nesting = max_nesting();
+ set_max_nesting(<max nesting level);
+
+ my $str = json_serialize(<perl object>[, <format spec>]);
+ my $ok = json_serialize_fd(<perl object>, <file handle or descriptor>[, <format spec>]);
+
+ my $pull = JSON::Uni::Pull->new(<perl object>[, <format spec>]);
+ my $chunk = $pull->next([<max bytes>]);
+
+ my $feed = JSON::Uni::Feed->new([<error handler>]);
+ $feed->budget(<max bytes per call>);
+ my $used = $feed->feed(<JSON text chunk>);
+ my $obj = $feed->finish();
+
+ my $parser = JSON::Uni::Parser->new([<max nesting level>[, <flags>]]);
+ my $obj = $parser->parse(<JSON string>[, <error handler>]);
+
+=head1 DESCRIPTION
+
+This module provides the default Perl interface to the uni-json JSON
+parser and serializer.
+
+=head2 Exportable Functions
+
+The module can export the following functions:
+
+=over
+
+=item * C<parse_json>
+
+Parses a JSON string and returns an equivalent Perl data structure
+based on a straight-forward mapping of JSON value types to Perl
+constructs. Strings containing only ASCII characters are created without
+the UTF-8 flag, all others with it.
+
+The optional I<error handler> argument should either be the name of a
+subroutine or a refence to one. In case of a parsing error, it'll be
+invoked with the error code as first argument and the position of the
+error in the input string as second. The various C<UJ_E_...> constants are
+the symbolic names of these error codes, a detailed description of them
+is in L<uni-json(3)>.
+
+It's safe to call C<die> or an equivalent from this handler as all
+memory allocated during parsing will have been free before it's
+invoked.
+
+=item * C<parse_json_iter>
+
+Same as C<parse_json> except that nested arrays and objects are tracked
+on the heap instead of by recursion. The stack space needed for parsing
+is thus constant regardless of the nesting depth.
+
+=item * C<parse_json_tape>
+
+Same as C<parse_json> except that the text is indexed first and the
+Perl data structure then built from the index. Arrays and hashes are
+created with their final size. Errors are the same as for C<parse_json>.
+
+=item * C<parse_json_paths>
+
+Parses a JSON string but only creates the values at the JSON pointers
+(RFC 6901) in the array passed as second argument, eg, C</user/id>. A
+segment C<*> matches every array element or object member. Everything else
+is skipped without creating Perl values for it. Returns a list with one
+element per pointer. This is the value at the pointer, C<undef> if there's
+none, or, for pointers with a C<*> segment, a reference to an array of all
+values found for it.
+
+The I<error handler> is the same as for C<parse_json>. An invalid pointer
+is reported as C<UJ_E_INV_PATH> with its index as position. Parts of the
+string which are skipped are checked as by C<parse_json> unless the
+I<flags> argument is C<UJ_PATH_NO_VALIDATE>. They're then only scanned for
+the ends of strings, arrays and objects.
+
+=item * C<parse_json_seq>
+
+Parses a sequence of JSON values, eg, newline-delimited JSON, and invokes
+the I<value handler> for each of them with the Perl data structure as first
+argument and the position of the value in the input string as
+second. Values may be separated by whitespace. Returns the number of
+values which were found.
+
+The I<error handler> is the same as for C<parse_json>. By default, parsing
+stops at the first error and C<undef> is returned if the error handler
+returns. If the I<flags> argument is C<UJ_SEQ_RESYNC>, parsing continues
+after the next linefeed following the error position instead. This skips
+the rest of a malformed record in newline-delimited JSON.
+
+=item * C<parse_json_events>
+
+Parses a JSON string without creating a Perl data structure. Instead, the
+handlers in the hash passed as second argument are invoked for the
+syntactical elements of the text as they're encountered. The hash keys are
+the event names described in L<uni-json-parser-events(3)>, ie,
+C<start_object>, C<key>, C<end_object>, C<start_array>, C<end_array>,
+C<string>, C<number>, C<boolean> and C<null>, and, optionally, C<on_error>
+for an error handler as for C<parse_json>. Events without a handler are
+ignored.
+
+The C<key> and C<string> handlers are invoked with a chunk of the string
+and a flag which is true for the last chunk, the C<number> handler with the
+text of the number and the C<boolean> handler with a boolean value.
+
+A handler must return a true value for parsing to continue. Returns 1 if
+the string was parsed completely, 0 if a handler stopped parsing and
+C<undef> after an error if the error handler returned.
+
+=item * C<is_valid_json>
+
+Checks if a string is valid JSON without creating any Perl values. The
+checks are the same as for C<parse_json> except that nesting is limited
+to 65536 levels even if the I<max nesting> parameter permits more. Deeper
+texts are reported as C<UJ_E_TOO_DEEP>. Returns true if the string is
+valid and false otherwise. In list context, the error code and position
+are returned after false for an invalid string.
+
+=item * C<max_nesting>
+
+Returns the current value of the global I<max nesting> parameter (default 0xffffffff, ie
+unlimited) used by the functions above. Parser objects have their own.
+
+=item * C<set_max_nesting>
+
+Change the I<max nesting> parameter. JSON constructs which are more deeply nested than this value
+permits will cause an error when trying to parse them. This can be used to limit the maximum
+depth to which the parser will descend into nested structures to guard against DoS-attacks
+when processing data from untrusted sources.
+
+=item * C<json_serialize>
+
+Serialize a Perl object to a JSON string. The optional second argument can be one of
+C<UJ_FMT_FAST>, C<UJ_FMT_DET> or C<UJ_FMT_PRETTY> to select I<fast>, I<deterministic>
+or I<pretty-printed> output format, with I<fast> being the default if no second argument
+was provided.
+
+The first two affect only serialization of objects/
+hashes. When using the I<fast> format, key-value pairs will be serialized in
+the order they're returned by the L<perlapi(1)> equivalent of C<each> (C<hv_iternext>). In
+particular, this means the order of keys in the ouput will be random for each individual
+object and very likely different for different objects containing the same keys. For the
+I<deterministic> output format, keys will appear sorted by locale-blind codepoint
+comparisons.
+
+The I<pretty-printed> output format will include redundant whitespace in arrays and
+objects to make the resulting text easier to read for humans. For objects, it uses the same
+key-sorting algorithm as the I<deterministic> format.
+
+B<Example Output>
+
+The output of C<< json_serialize([{a => b, c => d}, {a => b, c => d}]) >> can either be
+C<[{"c":"d","a":"b"},{"c":"d","a":"b"}]> or C<[{"a":"b","c":"d"},{"c":"d","a":"b"}]> (or
+any other possible combination).
+
+For C<< json_serialize([{a => b, c => d}, {a => b, c => d}], UJ_FMT_DET) >>, it will always
+be C<[{"a":"b","c":"d"},{"a":"b","c":"d"}]>.
+
+Using C<< json_serialize([{a => b, c => d}, {a => b, c => d}], UJ_FMT_PRETTY) >> will produce
+
+C<[
+        {
+                "a" : "b",
+                "c" : "d"},
+        {
+                "a" : "b",
+                "c" : "d"}]>
+
+using tabs (ASCII 09) for indentation. This is to avoid creating extremely huge output strings
+containing mostly space characters when serializing large structures.
+
+Numbers are serialized from their integer or floating point value without
+converting them to strings, hence, serializing doesn't add string values
+to numeric scalars. Floating point numbers are output as the shortest
+decimal which converts back to the same value, eg, C<0.1> and not
+C<0.10000000000000001>. Infinities and NaNs are serialized as C<null>.
+
+=item * C<json_serialize_fd>
+
+Serialize a Perl object like C<json_serialize> but write the JSON text directly to a
+file handle or a file descriptor number passed as second argument instead of
+returning it as string. The optional third argument selects the format. Buffered
+output of the file handle is flushed first.
+
+Output is gathered in a list of memory areas written with C<writev(2)>. Long string
+values are written from the string buffers of the Perl scalars instead of being copied
+first. Partial writes are continued. If the descriptor is non-blocking, the routine
+waits until it becomes writable when a write would have blocked.
+
+Returns true on success or C<undef> with C<$!> set if writing failed.
+
+=back
+
+=head2 Serializing in Chunks
+
+A C<JSON::Uni::Pull> object serializes a Perl object in chunks requested by the
+caller, eg, when writing to a non-blocking socket, without producing the complete
+JSON text first.
+
+=over
+
+=item * C<< JSON::Uni::Pull->new >>
+
+Creates a new pull object for the first argument. The optional second argument
+selects the format, like for C<json_serialize>.
+
+=item * C<< $pull->next >>
+
+Returns the next chunk of at most the number of bytes given as argument, 65536
+if there's none. Returns C<undef> after all output was returned. Chunks are
+byte strings containing UTF-8 which may end in the middle of a character.
+
+=back
+
+The serialized object must not be modified before all output was returned.
+
+=head2 Parsing Chunked Input
+
+A C<JSON::Uni::Feed> object parses a JSON text which becomes available in
+chunks, eg, when reading it from a non-blocking socket, without having to
+accumulate the complete text first. The value being parsed is built as
+parsing progresses.
+
+=over
+
+=item * C<< JSON::Uni::Feed->new >>
+
+Creates a new feed object. The optional argument is an error handler with
+the same semantics as the one for C<parse_json>.
+
+=item * C<< $feed->feed >>
+
+Parses the next chunk of input. Returns the number of bytes which were
+consumed. This will be the length of the chunk unless a budget was set. In
+case of an error, the error handler is invoked. Error positions are
+relative to the start of the complete input. If the error handler returns,
+C<undef> is returned.
+
+=item * C<< $feed->budget >>
+
+Limits the number of bytes a single C<feed> call will consume to the
+argument. The remaining bytes of the chunk must be passed to C<feed>
+again. A budget of 0 means I<unlimited>, which is the default.
+
+=item * C<< $feed->finish >>
+
+Signals that there's no more input and returns the parsed value. Errors
+caused by input which ended prematurely are reported here.
+
+=back
+
+After an error or after C<finish> was called, the feed object can't be used
+anymore.
+
+=head2 Parser Objects
+
+A C<JSON::Uni::Parser> object carries its own settings and reuses the
+memory the parser needs internally for every text it parses. Unlike
+C<set_max_nesting>, changing the settings of a parser object doesn't
+affect any other parser.
+
+=over
+
+=item * C<< JSON::Uni::Parser->new >>
+
+Creates a new parser object. The optional arguments are the I<max
+nesting> parameter, unlimited by default, and flags. C<UJ_P_ITER>
+selects the parser used by C<parse_json_iter> and C<UJ_P_TAPE> the one
+used by C<parse_json_tape>. The latter takes precedence if both are set.
+A parser object with C<UJ_P_TAPE> keeps the memory for the index of the
+largest text it parsed so far. With C<UJ_P_IN_SITU>, strings with escapes
+may be decoded in the string passed to C<parse>, which is then modified
+even if parsing fails. The two-stage parser doesn't do this.
+
+=item * C<< $parser->parse >>
+
+Parses a JSON string as C<parse_json>.
+
+=item * C<< $parser->max_nesting >>, C<< $parser->set_max_nesting >>
+
+Get or set the I<max nesting> parameter of the parser.
+
+=item * C<< $parser->flags >>, C<< $parser->set_flags >>
+
+Get or set the flags of the parser.
+
+=back
+
+=head2 Default Parser Error Handling
+
+In case of a parsing error, when the optional second argument to C<parse_json> wasn't provided,
+the parser will C<die> with a message including the standard message for error which occurred, the
+numeric error code and the position in the input string where the error was
+encountered.
+
+=head1 SEE ALSO
+
+L<uni-json(3)>, L<uni-json-parser-bindings(3)>, L<uni-json-parser-events(3)>, L<uni-json-serializer-bindings(3)>
+
+=cut
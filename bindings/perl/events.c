@@ -0,0 +1,210 @@
+/*
+  uni-json parser event bindings for Perl
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed
+*/
+
+/*  includes */
+#define PERL_NO_GET_CONTEXT
+#include "EXTERN.h"
+#include "perl.h"
+
+#include <uni_json_p_events.h>
+#include <uni_json_parser.h>
+
+/*  constants */
+enum {
+    H_START_OBJECT,
+    H_KEY,
+    H_END_OBJECT,
+    H_START_ARRAY,
+    H_END_ARRAY,
+    H_STRING,
+    H_NUMBER,
+    H_BOOLEAN,
+    H_NULL,
+    H_ERROR,
+
+    N_HANDLERS
+};
+
+/*  prototypes */
+int perl_uj_parse_events(uint8_t *, size_t, HV *);
+
+static void on_error(unsigned, size_t, void *);
+
+static int start_object(void *);
+static int key(uint8_t *, size_t, unsigned, void *);
+static int end_object(void *);
+
+static int start_array(void *);
+static int end_array(void *);
+
+static int string(uint8_t *, size_t, unsigned, void *);
+static int number(uint8_t *, size_t, unsigned, void *);
+static int boolean(int, void *);
+static int null(void *);
+
+/*  variables */
+static char *handler_names[] = {
+    [H_START_OBJECT] =		"start_object",
+    [H_KEY] =			"key",
+    [H_END_OBJECT] =		"end_object",
+    [H_START_ARRAY] =		"start_array",
+    [H_END_ARRAY] =		"end_array",
+    [H_STRING] =		"string",
+    [H_NUMBER] =		"number",
+    [H_BOOLEAN] =		"boolean",
+    [H_NULL] =			"null",
+    [H_ERROR] =			"on_error"
+};
+
+static struct uni_json_p_events default_perl_uj_event_bindings = {
+    .on_error =			on_error,
+
+    .start_object =		start_object,
+    .key =			key,
+    .end_object =		end_object,
+
+    .start_array =		start_array,
+    .end_array =		end_array,
+
+    .string =			string,
+    .number =			number,
+    .boolean =			boolean,
+    .null =			null
+};
+
+/*  routines */
+int perl_uj_parse_events(uint8_t *data, size_t len, HV *hv)
+{
+    /*
+      Parse data with the event handlers in hv. Event routines for
+      which no Perl handler exists are cleared so that the parser
+      skips them.
+    */
+    dTHX;
+    struct uni_json_p_events ours, *evs;
+    SV *hs[N_HANDLERS], **psv;
+    unsigned i;
+
+    evs = &ours;
+    *evs = default_perl_uj_event_bindings;
+
+    for (i = 0; i < N_HANDLERS; ++i) {
+        psv = hv_fetch(hv, handler_names[i], strlen(handler_names[i]), 0);
+        hs[i] = psv && SvOK(*psv) ? *psv : NULL;
+    }
+
+#define clear_unused(h, m) if (!hs[h]) evs->m = NULL
+
+    clear_unused(H_START_OBJECT, start_object);
+    clear_unused(H_KEY, key);
+    clear_unused(H_END_OBJECT, end_object);
+    clear_unused(H_START_ARRAY, start_array);
+    clear_unused(H_END_ARRAY, end_array);
+    clear_unused(H_STRING, string);
+    clear_unused(H_NUMBER, number);
+    clear_unused(H_BOOLEAN, boolean);
+    clear_unused(H_NULL, null);
+
+#undef clear_unused
+
+    return uni_json_parse_events(data, len, evs, hs);
+}
+
+static int invoke(SV *h, SV *a0, SV *a1)
+{
+    /*
+      Invoke a Perl event handler with up to two arguments. Returns
+      its return value as boolean.
+    */
+    dTHX;
+    dSP;
+    int rc, n;
+
+    ENTER;
+    SAVETMPS;
+
+    PUSHMARK(SP);
+    EXTEND(SP, 2);
+    if (a0) PUSHs(sv_2mortal(a0));
+    if (a1) PUSHs(sv_2mortal(a1));
+    PUTBACK;
+
+    n = call_sv(h, G_SCALAR);
+
+    SPAGAIN;
+    rc = n && SvTRUE(TOPs);
+    if (n) (void)POPs;
+    PUTBACK;
+
+    FREETMPS;
+    LEAVE;
+
+    return rc;
+}
+
+static void on_error(unsigned code, size_t pos, void *p)
+{
+    dTHX;
+    SV *h;
+
+    h = ((SV **)p)[H_ERROR];
+    if (!h) croak_nocontext("%s (%u) at %zu", uni_json_ec_2_msg(code), code, pos);
+
+    invoke(h, newSVuv(code), newSVuv(pos));
+}
+
+static int start_object(void *p)
+{
+    return invoke(((SV **)p)[H_START_OBJECT], NULL, NULL);
+}
+
+static int key(uint8_t *data, size_t len, unsigned flags, void *p)
+{
+    dTHX;
+    return invoke(((SV **)p)[H_KEY], newSVpvn_utf8(data, len, 1),
+                  flags & UJ_EV_LAST ? &PL_sv_yes : &PL_sv_no);
+}
+
+static int end_object(void *p)
+{
+    return invoke(((SV **)p)[H_END_OBJECT], NULL, NULL);
+}
+
+static int start_array(void *p)
+{
+    return invoke(((SV **)p)[H_START_ARRAY], NULL, NULL);
+}
+
+static int end_array(void *p)
+{
+    return invoke(((SV **)p)[H_END_ARRAY], NULL, NULL);
+}
+
+static int string(uint8_t *data, size_t len, unsigned flags, void *p)
+{
+    dTHX;
+    return invoke(((SV **)p)[H_STRING], newSVpvn_utf8(data, len, 1),
+                  flags & UJ_EV_LAST ? &PL_sv_yes : &PL_sv_no);
+}
+
+static int number(uint8_t *data, size_t len, unsigned, void *p)
+{
+    dTHX;
+    return invoke(((SV **)p)[H_NUMBER], newSVpvn(data, len), NULL);
+}
+
+static int boolean(int true_false, void *p)
+{
+    dTHX;
+    return invoke(((SV **)p)[H_BOOLEAN], true_false ? &PL_sv_yes : &PL_sv_no, NULL);
+}
+
+static int null(void *p)
+{
+    return invoke(((SV **)p)[H_NULL], NULL, NULL);
+}
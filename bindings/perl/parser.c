@@ -20,15 +20,26 @@ static void on_error(unsigned, size_t, void *);
 static void *make_bool(int);
 static void *make_null(void);
 static void *make_number(uint8_t *, size_t, unsigned);
+static void *make_int64(int64_t);
+static void *make_uint64(uint64_t);
+static void *make_double(double);
 
 static void *make_string(void);
+static void *make_string_span(uint8_t *, size_t);
+static void *dup_string(void *);
 static int add_2_string(uint8_t *, size_t, void *);
+static void mark_ascii(void *);
 
 static void *make_av(void);
+static void *make_av_sized(size_t);
 static int add_2_av(void *, void *);
+static int add_n_2_av(void **, size_t, void *);
 
 static void *make_hv(void);
+static void *make_hv_sized(size_t);
 static int add_2_hv(void *, void *, void *);
+static int add_raw_2_hv(uint8_t *, size_t, uint32_t, void *, void *);
+static uint32_t hash_key(uint8_t *, size_t);
 
 static void free_obj(void *);
 
@@ -42,17 +53,46 @@ struct uni_json_p_binding default_perl_uj_parser_bindings = {
     .make_number =		make_number,
     .free_number =		free_obj,
 
+    /*
+      The native number routines are only used if the Perl types
+      can hold the values, otherwise, make_number converts the
+      text as before.
+    */
+#if IVSIZE >= 8
+    .make_int64 =		make_int64,
+    .make_uint64 =		make_uint64,
+#endif
+#if NVSIZE == 8
+    .make_double =		make_double,
+#endif
+
     .make_string =		make_string,
     .free_string =		free_obj,
     .add_2_string =		add_2_string,
+    .make_string_span =		make_string_span,
+    .dup_string =		dup_string,
+    .span_flags =		UJ_SPAN_INTERN_KEYS,
+    .mark_ascii =		mark_ascii,
 
     .make_array =		make_av,
     .free_array =		free_obj,
     .add_2_array =		add_2_av,
+    .make_array_sized =		make_av_sized,
+    .add_n_2_array =		add_n_2_av,
 
+    /*
+      Objects use raw keys instead of batch adds as this avoids
+      creating SVs for keys.
+    */
     .make_object =		make_hv,
     .free_object =		free_obj,
-    .add_2_object =		add_2_hv
+    .add_2_object =		add_2_hv,
+    .make_object_sized =	make_hv_sized,
+    .add_raw_2_object =		add_raw_2_hv,
+    .hash_key =			hash_key,
+
+    .alloc =			Perl_safesysmalloc,
+    .dealloc =			Perl_safesysfree
 };
 
 /*  routines */
@@ -106,12 +146,46 @@ static void *make_number(uint8_t *data, size_t len, unsigned flags)
     return newSVnv(my_atof(tmp));
 }
 
+static void *make_int64(int64_t v)
+{
+    dTHX;
+    return newSViv(v);
+}
+
+static void *make_uint64(uint64_t v)
+{
+    dTHX;
+    return newSVuv(v);
+}
+
+static void *make_double(double v)
+{
+    dTHX;
+    return newSVnv(v);
+}
+
 static void *make_string(void)
 {
     dTHX;
     return newSVpvn_utf8("", 0, 1);
 }
 
+static void *make_string_span(uint8_t *data, size_t len)
+{
+    dTHX;
+    return newSVpvn_utf8(data, len, 1);
+}
+
+static void *dup_string(void *str)
+{
+    /*
+      Only used for keys. These are freed after they were used to
+      store a value in a hash, hence, sharing them is safe.
+    */
+    dTHX;
+    return SvREFCNT_inc_simple_NN((SV *)str);
+}
+
 static int add_2_string(uint8_t *data, size_t len, void *str)
 {
     dTHX;
@@ -119,12 +193,32 @@ static int add_2_string(uint8_t *data, size_t len, void *str)
     return 1;
 }
 
+static void mark_ascii(void *str)
+{
+    /*
+      ASCII strings don't need the UTF-8 flag. Without it, length,
+      substr and the like don't have to count characters.
+    */
+    dTHX;
+    SvUTF8_off((SV *)str);
+}
+
 static void *make_av(void)
 {
     dTHX;
     return newRV_noinc((SV *)newAV());
 }
 
+static void *make_av_sized(size_t n)
+{
+    dTHX;
+    AV *av;
+
+    av = newAV();
+    if (n) av_extend(av, n - 1);
+    return newRV_noinc((SV *)av);
+}
+
 static int add_2_av(void *v, void *ary)
 {
     dTHX;
@@ -132,12 +226,37 @@ static int add_2_av(void *v, void *ary)
     return 1;
 }
 
+static int add_n_2_av(void **values, size_t n, void *ary)
+{
+    /*
+      The array was created by make_av_sized and is thus empty
+      and large enough.
+    */
+    dTHX;
+    AV *av;
+
+    av = (AV *)SvRV((SV *)ary);
+    Copy(values, AvARRAY(av), n, SV *);
+    AvFILLp(av) = n - 1;
+    return 1;
+}
+
 static void *make_hv(void)
 {
     dTHX;
     return newRV_noinc((SV *)newHV());
 }
 
+static void *make_hv_sized(size_t n)
+{
+    dTHX;
+    HV *hv;
+
+    hv = newHV();
+    if (n > 8) hv_ksplit(hv, n);
+    return newRV_noinc((SV *)hv);
+}
+
 static int add_2_hv(void *key, void *value, void *obj)
 {
     dTHX;
@@ -150,6 +269,31 @@ static int add_2_hv(void *key, void *value, void *obj)
     return 1;
 }
 
+static int add_raw_2_hv(uint8_t *key, size_t len, uint32_t hash, void *value, void *obj)
+{
+    /*
+      A negative length marks the key as UTF-8. If it can be
+      downgraded, hv_common recalculates the hash.
+    */
+    dTHX;
+    void *rc;
+
+    if (len > I32_MAX) return 0;
+
+    rc = hv_common_key_len((HV *)SvRV((SV *)obj), (char *)key, -(I32)len,
+                           HV_FETCH_ISSTORE, value, hash);
+    return rc != NULL;
+}
+
+static uint32_t hash_key(uint8_t *key, size_t len)
+{
+    dTHX;
+    U32 hash;
+
+    PERL_HASH(hash, (char *)key, len);
+    return hash;
+}
+
 static void free_obj(void *obj)
 {
     dTHX;
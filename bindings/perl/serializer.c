@@ -25,6 +25,11 @@ struct aiter {
     SV **p, **e;
 };
 
+struct oiter {
+    HV *hv;
+    AV *keep;                   /* converted keys */
+};
+
 /*  prototypes */
 static void output(uint8_t *data, size_t len, void *sink);
 static int type_of(void *p);
@@ -33,12 +38,17 @@ static void *start_object_traversal(void *);
 static size_t max_kv_pairs(void *);
 static int next_kv_pair(void *, struct uj_kv_pair *);
 
+static void *start_object_traversal_pull(void *);
+static int next_kv_pair_pull(void *, struct uj_kv_pair *);
+static void end_object_traversal_pull(void *);
+
 static void *start_array_traversal(void *);
 static void *next_value(void *);
 static void end_array_traversal(void *);
 
 
 static void get_num_data(void *num, struct uj_data *data);
+static int get_num_value(void *num, union uj_num *nv);
 static void get_string_data(void *str, struct uj_data *data);
 static int get_bool_value(void *boolean);
 
@@ -58,6 +68,32 @@ struct uni_json_s_binding default_perl_uj_serializer_bindings = {
     .end_array_traversal =	end_array_traversal,
 
     .get_num_data =		get_num_data,
+    .get_num_value =		get_num_value,
+    .get_string_data =		get_string_data,
+    .get_bool_value =		get_bool_value
+};
+
+/*
+  Pull serialization runs across several XS calls and mortal
+  copies of converted keys would be freed before they're output.
+*/
+struct uni_json_s_binding default_perl_uj_pull_bindings = {
+    .output =			output,
+    .type_of =			type_of,
+    .alloc =			safemalloc,
+    .dealloc =			safefree,
+
+    .start_object_traversal =	start_object_traversal_pull,
+    .max_kv_pairs =		max_kv_pairs,
+    .next_kv_pair =		next_kv_pair_pull,
+    .end_object_traversal =	end_object_traversal_pull,
+
+    .start_array_traversal =	start_array_traversal,
+    .next_value =		next_value,
+    .end_array_traversal =	end_array_traversal,
+
+    .get_num_data =		get_num_data,
+    .get_num_value =		get_num_value,
     .get_string_data =		get_string_data,
     .get_bool_value =		get_bool_value
 };
@@ -116,8 +152,12 @@ static size_t max_kv_pairs(void *obj)
     return HvTOTALKEYS((HV *)SvRV((SV *)obj));
 }
 
-static void key_from_he(HE *he, struct uj_data *key)
+static SV *key_from_he(HE *he, struct uj_data *key)
 {
+    /*
+      Returns the new SV holding the UTF-8 version of a key which
+      had to be converted, NULL otherwise.
+    */
     dTHX;
     STRLEN len, ndx;
     SV *sv;
@@ -132,8 +172,7 @@ static void key_from_he(HE *he, struct uj_data *key)
                 key->s = SvPVutf8(sv, len);
                 key->len = len;
 
-                sv_2mortal(sv);
-                return;
+                return sv;
             }
 
             ++ndx;
@@ -141,6 +180,7 @@ static void key_from_he(HE *he, struct uj_data *key)
     }
 
     key->len = len;
+    return NULL;
 }
 
 static int next_kv_pair(void *oiter, struct uj_kv_pair *kvp)
@@ -148,18 +188,63 @@ static int next_kv_pair(void *oiter, struct uj_kv_pair *kvp)
     dTHX;
     HV *hv;
     HE *he;
-    STRLEN len;
+    SV *sv;
 
     hv = oiter;
     he = hv_iternext(hv);
     if (!he) return 0;
 
-    key_from_he(he, &kvp->key);
+    sv = key_from_he(he, &kvp->key);
+    if (sv) sv_2mortal(sv);
     kvp->val = HeVAL(he);
 
     return 1;
 }
 
+static void *start_object_traversal_pull(void *obj)
+{
+    dTHX;
+    struct oiter *oiter;
+
+    oiter = safemalloc(sizeof(*oiter));
+    oiter->hv = (HV *)SvRV((SV *)obj);
+    oiter->keep = NULL;
+
+    hv_iterinit(oiter->hv);
+    return oiter;
+}
+
+static int next_kv_pair_pull(void *p, struct uj_kv_pair *kvp)
+{
+    dTHX;
+    struct oiter *oiter;
+    HE *he;
+    SV *sv;
+
+    oiter = p;
+    he = hv_iternext(oiter->hv);
+    if (!he) return 0;
+
+    sv = key_from_he(he, &kvp->key);
+    if (sv) {
+        if (!oiter->keep) oiter->keep = newAV();
+        av_push(oiter->keep, sv);
+    }
+    kvp->val = HeVAL(he);
+
+    return 1;
+}
+
+static void end_object_traversal_pull(void *p)
+{
+    dTHX;
+    struct oiter *oiter;
+
+    oiter = p;
+    if (oiter->keep) SvREFCNT_dec((SV *)oiter->keep);
+    Safefree(oiter);
+}
+
 static void *start_array_traversal(void *ary)
 {
     dTHX;
@@ -205,6 +290,39 @@ static void get_num_data(void *num, struct uj_data *data)
     data->len = len;
 }
 
+static int get_num_value(void *num, union uj_num *nv)
+{
+    /*
+      Return the value of numbers perl already converted to a
+      native one instead of stringifying them with SvPV, which
+      would attach a string buffer to the scalar. NVs which aren't
+      doubles are passed on as text.
+    */
+    dTHX;
+    SV *sv;
+
+    sv = num;
+
+    if (SvIOK(sv)) {
+        if (SvIsUV(sv)) {
+            nv->u = SvUVX(sv);
+            return UJ_NUM_UINT64;
+        }
+
+        nv->i = SvIVX(sv);
+        return UJ_NUM_INT64;
+    }
+
+#if NVSIZE == 8
+    if (SvNOK(sv)) {
+        nv->d = SvNVX(sv);
+        return UJ_NUM_DOUBLE;
+    }
+#endif
+
+    return UJ_NUM_DATA;
+}
+
 static void get_string_data(void *str, struct uj_data *data)
 {
     dTHX;
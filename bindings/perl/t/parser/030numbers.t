@@ -3,7 +3,7 @@
 # test parsing of numbers
 #
 
-use Test::More tests => 13;
+use Test::More tests => 19;
 use JSON::Uni 'parse_json';
 
 my $x;
@@ -54,3 +54,22 @@ eval {
     parse_json('123e');
 };
 isnt($@, '', 'e with nothing following errors');
+
+$x = parse_json('18446744073709551615');
+is($x, 18446744073709551615, 'parsing largest 64-bit unsigned integer works');
+
+$x = parse_json('-9223372036854775808');
+is($x, -9223372036854775808, 'parsing smallest 64-bit integer works');
+
+$x = parse_json('18446744073709551616');
+is($x, 18446744073709551616, 'integer too large for 64 bits becomes a double');
+
+$x = [map { parse_json($_) } '0.1', '2.2250738585072011e-308', '9007199254740993', '1.7976931348623157e308'];
+is_deeply($x, [0.1, 2.2250738585072011e-308, 9007199254740993, 1.7976931348623157e308],
+          'doubles are rounded correctly');
+
+$x = parse_json('4.9406564584124654e-324');
+is($x, 4.9406564584124654e-324, 'parsing subnormal double works');
+
+$x = parse_json('[1e400, -1e400, 1e-400]');
+is_deeply($x, [9**9**9, -9**9**9, 0], 'out of range exponents become inf or 0');
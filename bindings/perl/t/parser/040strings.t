@@ -3,8 +3,8 @@
 # test parsing of strings
 #
 
-use Test::More tests => 34;
-use JSON::Uni 'parse_json';
+use Test::More tests => 51;
+use JSON::Uni qw(parse_json parse_json_iter parse_json_tape UJ_E_INV_CHAR UJ_E_INV_UTF8);
 
 my $x;
 
@@ -95,6 +95,11 @@ eval {
 };
 isnt($@, '', 'encoded minimum surrogate errors');
 
+eval {
+    parse_json("\"\xed\xa0\x80\"");
+};
+isnt($@, '', 'encoded 0xd800 errors');
+
 eval {
     parse_json("\"\xed\xbf\xbf\"");
 };
@@ -169,3 +174,87 @@ isnt($@, '', 'low surrogate on its own errors');
 
 $x = parse_json('"a\\ud801\\udc01b"');
 is($x, "a\N{U+10401}b", 'surrogate escape pair works');
+
+#*  long strings
+#
+my $long = join('', map { chr(32 + $_ % 95) } 0 .. 299);
+$long =~ tr/"\\//d;
+
+$x = parse_json("\"$long\"");
+is($x, $long, 'long plain string works');
+
+$x = parse_json("\"$long\\n$long\"");
+is($x, "$long\n$long", 'escape between long runs works');
+
+$x = parse_json("\"$long\xc2\xa3$long\"");
+is($x, "$long\N{U+a3}$long", 'UTF-8 sequence between long runs works');
+
+eval {
+    parse_json("\"" . substr($long, 0, 70) . "\x01$long\"", sub { die([@_]) });
+};
+is_deeply($@, [UJ_E_INV_CHAR, 71], 'position of control char in long string');
+
+eval {
+    parse_json("\"" . substr($long, 0, 127) . "\x1f\"", sub { die([@_]) });
+};
+is_deeply($@, [UJ_E_INV_CHAR, 128], 'position of control char at end of long string');
+
+eval {
+    parse_json("\"" . substr($long, 0, 100) . "\xc2\xc0$long\"", sub { die([@_]) });
+};
+is_deeply($@, [UJ_E_INV_UTF8, 101], 'position of invalid UTF-8 in long string');
+
+eval {
+    parse_json("\"$long");
+};
+isnt($@, '', 'unterminated long string errors');
+
+#*  long non-ASCII strings
+#
+# These exercise the block-wise UTF-8 validation.
+#
+my $multi = "\xd0\x9f\xd1\x80\xd0\xb8 \xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e \xf0\x9f\x98\x80 x" x 20;
+
+$x = parse_json("\"$multi\"");
+is($x, "\N{U+41f}\N{U+440}\N{U+438} \N{U+65e5}\N{U+672c}\N{U+8a9e} \N{U+1f600} x" x 20,
+   'long multilingual string works');
+
+eval {
+    parse_json("\"$multi\xef\xbf\xbe$multi\"", sub { die([@_]) });
+};
+is_deeply($@, [UJ_E_INV_UTF8, length($multi) + 1], 'position of non-char in long string');
+
+eval {
+    parse_json("\"$multi\xed\xa0\x80$multi\"", sub { die([@_]) });
+};
+is_deeply($@, [UJ_E_INV_UTF8, length($multi) + 1], 'position of surrogate in long string');
+
+eval {
+    parse_json("\"$multi\xf0\x9f\x98\"", sub { die([@_]) });
+};
+is_deeply($@, [UJ_E_INV_UTF8, length($multi) + 1], 'position of truncated sequence in long string');
+
+#*  UTF-8 flag
+#
+my @texts = ('"abc"', '""', '"a\\nb\\u0041"', '"' . ('x' x 100) . '\\t"', "\"\xc3\xa4\"", '"\\u2193"', '"a\\ud83d\\ude00"',
+             '"a' . ('x' x 100) . "\xe2\x86\x93\"");
+is_deeply([map { utf8::is_utf8(parse_json("[$_]")->[0]) ? 1 : 0 } @texts], [0, 0, 0, 0, 1, 1, 1, 1],
+          'only non-ASCII strings have the UTF-8 flag');
+
+is_deeply([map { my $t = $_; map { utf8::is_utf8($_->("[$t]")->[0]) ? 1 : 0 } \&parse_json_iter, \&parse_json_tape } @texts],
+          [0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1],
+          'same for the iterative and two-stage parsers');
+
+#*  escape-dense strings
+#
+is_deeply(parse_json('["\\u00e4\\u07ff\\u0800\\u0fff\\u1000", "\\u0080x\\u00A9"]'),
+          ["\N{U+e4}\N{U+7ff}\N{U+800}\N{U+fff}\N{U+1000}", "\N{U+80}x\N{U+a9}"],
+          'escapes of 2 and 3 byte sequences work');
+
+$x = join('', map { sprintf('\\u%04x', 0x410 + $_ % 32) } 0 .. 299);
+is(parse_json("[\"$x\"]")->[0], join('', map { chr(0x410 + $_ % 32) } 0 .. 299),
+   'long runs of \\u escapes work');
+
+$x = 'C:\\\\Users\\\\' . join('\\\\', map { "dir$_" } 1 .. 100) . '\\\\' . ('x' x 300) . '\\t' . 'y' x 20;
+is(parse_json("[\"$x\"]")->[0], 'C:\\Users\\' . join('\\', map { "dir$_" } 1 .. 100) . '\\' . ('x' x 300) . "\t" . 'y' x 20,
+   'long strings with many escapes work');
@@ -3,7 +3,7 @@
 # test parsing of arrays
 #
 
-use Test::More tests => 7;
+use Test::More tests => 9;
 use JSON::Uni 'parse_json';
 
 my $x;
@@ -36,3 +36,13 @@ eval {
     parse_json('[456,]');
 };
 isnt($@, '', 'missing value in array errors');
+
+#*  many values
+#
+$x = parse_json('[' . join(',', map { "[$_, [" . join(',', 1 .. $_ % 100) . ']]' } 1 .. 1000) . ']');
+is_deeply($x, [map { [$_, [1 .. $_ % 100]] } 1 .. 1000], 'large nested arrays work');
+
+eval {
+    parse_json('[' . join(',', map { "[$_, \"x\"]" } 1 .. 1000) . ', [1, 2,]]');
+};
+isnt($@, '', 'error after many values errors');
@@ -3,7 +3,7 @@
 # test parsing of objects
 #
 
-use Test::More tests => 9;
+use Test::More tests => 15;
 use JSON::Uni 'parse_json';
 
 my $x;
@@ -46,3 +46,32 @@ eval {
     parse_json('{ "key" : "blubb", }');
 };
 isnt($@, '', 'missing key errors');
+
+#*  repeated keys
+#
+$x = parse_json('[{"id" : 1, "status" : "ok"}, {"id" : 2, "status" : "ok"}, {"status" : "failed", "id" : 3}]');
+is_deeply($x, [{id => 1, status => 'ok'}, {id => 2, status => 'ok'}, {status => 'failed', id => 3}],
+          'parsing objects with repeated keys works');
+
+$x = parse_json('[{"a\\u2193" : 1, "bä" : 2}, {"a\\u2193" : 3, "bä" : 4, "' . ('k' x 100) . '" : 5}]');
+is_deeply($x, [{"a\N{U+2193}" => 1, "b\N{U+e4}" => 2}, {"a\N{U+2193}" => 3, "b\N{U+e4}" => 4, 'k' x 100 => 5}],
+          'repeated keys with escapes, non-ASCII chars or long keys work');
+
+$x = parse_json('[' . join(',', map { qq({"k$_" : $_, "k" : $_}) } 1 .. 1000) . ']');
+is_deeply($x, [map { {"k$_" => $_, k => $_} } 1 .. 1000], 'many different keys work');
+
+#*  many pairs
+#
+$x = parse_json('{' . join(',', map { qq("k$_" : {"v" : [$_], "w" : "$_"}) } 1 .. 1000) . '}');
+is_deeply($x, {map { ("k$_" => {v => [$_], w => "$_"}) } 1 .. 1000}, 'large nested objects work');
+
+eval {
+    parse_json('{' . join(',', map { qq("k$_" : "$_") } 1 .. 1000) . ', "x" : {"y" : }}');
+};
+isnt($@, '', 'error after many pairs errors');
+
+#*  key lookups
+#
+$x = parse_json("{\"\xe2\x86\x93\" : 1, \"\xc3\xa4\" : 2, \"a\" : 3, \"\" : 4, \"b\\u2193\" : 5, \"a\" : 6}");
+is_deeply([map { $x->{$_} } "\N{U+2193}", "\N{U+e4}", 'a', '', "b\N{U+2193}", 'c'], [1, 2, 6, 4, 5, undef],
+          'keys can be looked up');
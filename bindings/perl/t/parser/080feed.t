@@ -0,0 +1,125 @@
+# -*- perl -*-
+#
+# test parsing chunked input with the push parser
+#
+
+use Test::More tests => 13;
+use JSON::Uni qw(parse_json set_max_nesting json_serialize UJ_FMT_DET UJ_E_EOS UJ_E_INV_UTF8);
+
+#*  helpers
+#
+sub parse_whole
+{
+    my $r;
+
+    $r = eval { [parse_json($_[0], sub { die([@_]) })] };
+    return $r // $@;
+}
+
+sub parse_split
+{
+    my ($text, @at) = @_;
+    my ($feed, $pos, $r);
+
+    $r = eval {
+        $feed = JSON::Uni::Feed->new(sub { die([@_]) });
+
+        $pos = 0;
+        for (@at, length($text)) {
+            $feed->feed(substr($text, $pos, $_ - $pos));
+            $pos = $_;
+        }
+
+        [$feed->finish()];
+    };
+
+    return $r // $@;
+}
+
+sub all_splits
+{
+    my $text = $_[0];
+    my ($want, $len, @bad);
+
+    $want = json_serialize(parse_whole($text), UJ_FMT_DET);
+    $len = length($text);
+
+    for (1 .. $len - 1) {
+        push(@bad, "$text at $_")
+            unless json_serialize(parse_split($text, $_), UJ_FMT_DET) eq $want;
+    }
+
+    push(@bad, "$text bytewise")
+        unless json_serialize(parse_split($text, 1 .. $len - 1), UJ_FMT_DET) eq $want;
+    return @bad;
+}
+
+#*  tests
+#
+my (@texts, $x, $feed, $used);
+
+$x = parse_split('[1, "abc", {"a" : null}]', 3, 11, 17);
+is_deeply($x, [[1, 'abc', {a => undef}]], 'parsing chunked input works');
+
+@texts = (
+    '123', '-0.5e+10', 'true', ' false ', 'null',
+    '"abc\\"\\\\\\/\\b\\f\\n\\r\\t"', "\"\xc2\xa3\xe2\x86\x93\xf0\x9f\x8e\xb2x\"",
+    '"\\u00e4\\ud83c\\udfb2\\u2193"',
+    '[ [], {}, [1, [2, [3]]], {"a": {"b": [true, false, null]}} ]',
+    '{"k1" : "v1", "k2" : [1.5, -2, 3e4], "k3" : {}}',
+);
+is_deeply([map { all_splits($_) } @texts], [], 'results same as parse_json at all split points');
+
+@texts = (
+    '', ' ', ']', '[', '[1,', '[1 2]', '[}', '{]', '{,', '{1:2}', '{"a" 1}', '{"a":}',
+    '{"a":1,}', '{"a":1,2:3}', '{"a"', '{"a":1', '[1,]', '1 2', '"abc', 'tru', 'nul]',
+    '[1e]', '1e', '-', '[-]', '01', '[1x]', '1x', '1"', '"\\x"', '"\\u12"', '"\\u12g4"',
+    '"\\ud800x"', '"\\ud800\\u0041"', '"\\udc00"', '"\\u00', "\"\xc2\"", "\"\xc2",
+    "\"ab\xe2\x86\"", "\"\xed\xa0\x80\"", "\"\xef\xbf\xbe\"", "\"\x01\"", '@', '[:]',
+);
+is_deeply([map { all_splits($_) } @texts], [], 'errors same as parse_json at all split points');
+
+$x = parse_split('"abc', 2);
+is_deeply($x, [UJ_E_EOS, 4], 'unterminated string reported by finish');
+
+$x = parse_split("\"abc\xe2\x86\xff\"", 5, 6);
+is_deeply($x, [UJ_E_INV_UTF8, 4], 'error position of split UTF-8 sequence');
+
+set_max_nesting(2);
+is_deeply([map { all_splits($_) } '[[1]]', '[[[1]]]', '{"a":[{}]}'], [],
+          'nesting limit same as parse_json at all split points');
+set_max_nesting(-1);
+
+#*  budget
+#
+$feed = JSON::Uni::Feed->new();
+$feed->budget(4);
+$used = $feed->feed('[1, 2, 3]');
+is($used, 4, 'feed consumes no more than the budget');
+
+$used = $feed->feed(substr('[1, 2, 3]', 4));
+is($used, 4, 'budget applies to every call');
+
+$used = $feed->feed(']');
+is($used, 1, 'feed consumes less than the budget if there is less input');
+
+$x = $feed->finish();
+is_deeply($x, [1, 2, 3], 'value parsed with a budget is correct');
+
+#*  misc
+#
+eval {
+    $feed = JSON::Uni::Feed->new();
+    $feed->feed('[1, 2');
+    $feed->feed(' x');
+};
+like($@, qr/invalid char in value/, 'default error handler dies');
+
+$feed = JSON::Uni::Feed->new();
+$feed->feed('{"a" : [1, 2, "abc');
+undef($feed);
+pass('destroying an unfinished feed works');
+
+@texts = ('["abc", "a\\nb"]', "[\"\xe2\x86\x93\"]", '["a\\u2193"]', "[\"ab\xc3\xa4\"]");
+is_deeply([map { my $t = $_; map { utf8::is_utf8(parse_split($t, $_)->[0][0]) ? 1 : 0 } 3, 5 } @texts],
+          [0, 0, 1, 1, 1, 1, 1, 1], 'only non-ASCII strings have the UTF-8 flag');
@@ -0,0 +1,40 @@
+# -*- perl -*-
+#
+# test parsing sequences of values
+#
+
+use Test::More tests => 9;
+use JSON::Uni qw(parse_json_seq UJ_SEQ_RESYNC UJ_E_INV UJ_E_INV_LIT UJ_E_NO_VAL);
+
+my (@vals, @errs, $n);
+
+sub on_value { push(@vals, [@_]) }
+sub on_error { push(@errs, [@_]) }
+
+$n = parse_json_seq(qq({"a" : 1}\n[2, 3]\n"abc"\n), \&on_value);
+is($n, 3, 'number of values returned');
+is_deeply(\@vals, [[{a => 1}, 0], [[2, 3], 10], ['abc', 17]], 'values and positions passed to handler');
+
+@vals = ();
+$n = parse_json_seq(' 1 true[]{}"x"null ', \&on_value);
+is_deeply(\@vals, [[1, 1], [1, 3], [[], 7], [{}, 9], ['x', 11], [undef, 14]],
+          'values need not be separated by linefeeds');
+
+@vals = ();
+$n = parse_json_seq(" \n\t ", \&on_value);
+ok($n == 0 && !@vals, 'whitespace only means no values');
+
+@vals = ();
+$n = parse_json_seq(qq(1\n[tru, 3]\n2\n), \&on_value, \&on_error);
+ok(!defined($n) && @vals == 1, 'parsing stops at errors by default');
+is_deeply(\@errs, [[UJ_E_INV_LIT, 3]], 'error reported');
+
+@vals = @errs = ();
+$n = parse_json_seq(qq(1\n[tru, 3]\n2\n@\n]\n3), \&on_value, \&on_error, UJ_SEQ_RESYNC);
+ok($n == 3 && @vals == 3 && $vals[2][1] == 17, 'parsing resumes after next linefeed with UJ_SEQ_RESYNC');
+is_deeply(\@errs, [[UJ_E_INV_LIT, 3], [UJ_E_INV, 13], [UJ_E_NO_VAL, 15]], 'all errors reported');
+
+eval {
+    parse_json_seq(qq({"a" : 1}\n{"a" : 2}), sub { die("stop\n") if $_[1] });
+};
+is($@, "stop\n", 'dying in value handler works');
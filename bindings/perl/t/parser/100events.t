@@ -0,0 +1,56 @@
+# -*- perl -*-
+#
+# test the event parser
+#
+
+use Test::More tests => 9;
+use JSON::Uni qw(parse_json_events UJ_E_INV_KEY UJ_E_NO_VAL UJ_E_GARBAGE);
+
+my (@evs, %handlers, $rc);
+
+for my $ev (qw(start_object end_object start_array end_array null)) {
+    $handlers{$ev} = sub { push(@evs, [$ev]); 1 };
+}
+
+for my $ev (qw(key string number boolean)) {
+    $handlers{$ev} = sub { push(@evs, [$ev, @_]); 1 };
+}
+
+$rc = parse_json_events('{"a" : [1, -2.5, true, false, null, "x"], "b" : {}}', \%handlers);
+is($rc, 1, 'parsing completely returns 1');
+is_deeply(\@evs, [['start_object'],
+                  ['key', 'a', 1],
+                  ['start_array'], ['number', 1], ['number', -2.5],
+                  ['boolean', 1], ['boolean', ''], ['null'], ['string', 'x', 1],
+                  ['end_array'],
+                  ['key', 'b', 1],
+                  ['start_object'], ['end_object'],
+                  ['end_object']],
+          'events generated in order');
+
+@evs = ();
+parse_json_events('["ab\\ncd\\u2193"]', { string => $handlers{string} });
+is_deeply(\@evs, [['string', "ab\ncd\N{U+2193}", 1]], 'strings with escapes passed as one chunk');
+
+@evs = ();
+parse_json_events('["' . 'ab\\n' x 100 . '"]', { string => $handlers{string} });
+is(join('', map { $_->[1] } @evs), "ab\n" x 100, 'long strings with escapes passed in chunks');
+
+@evs = ();
+$rc = parse_json_events('[1, [2, 3], 4]', { number => sub { push(@evs, $_[0]); $_[0] != 2 } });
+ok($rc == 0 && "@evs" eq '1 2', 'handler returning false stops parsing');
+
+@evs = ();
+$rc = parse_json_events('[1, [2, 3], 4]', {});
+is($rc, 1, 'parsing without handlers works');
+
+$rc = parse_json_events('{1 : 2}', { on_error => sub { @evs = @_ } });
+ok(!defined($rc) && "@evs" eq UJ_E_INV_KEY . ' 1', 'invalid key errors');
+
+$rc = parse_json_events('[1,]', { on_error => sub { @evs = @_ } });
+is("@evs", UJ_E_NO_VAL . ' 3', 'missing value errors');
+
+eval {
+    parse_json_events('1 2', {});
+};
+like($@, qr/garbage/, 'default error handler dies');
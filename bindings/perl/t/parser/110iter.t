@@ -0,0 +1,52 @@
+# -*- perl -*-
+#
+# test the iterative parser
+#
+
+use Test::More tests => 5;
+use JSON::Uni qw(parse_json parse_json_iter set_max_nesting);
+
+#*  helpers
+#
+sub result
+{
+    my ($parse, $text) = @_;
+    my $r;
+
+    $r = eval { [$parse->($text, sub { die([@_]) })] };
+    return $r // $@;
+}
+
+#*  tests
+#
+my (@texts, $x, $depth);
+
+@texts = (
+    '123', '"abc"', 'true', ' null ', '[]', '{}', '[1, [2, [3, {}]], []]',
+    '{"a" : {"b" : [true, false, null]}, "c" : "d"}',
+    '', ' ', ']', '[', '[1,', '[1 2]', '[}', '{]', '{,', '{1:2}', '{[1]:2}', '{"a" 1}',
+    '{"a":}', '{"a":1,}', '{"a":1,2:3}', '{"a":1', '[1,]', '1 2', '[1x]', '[[[]]] x',
+);
+is_deeply([map { result(\&parse_json_iter, $_) } @texts],
+          [map { result(\&parse_json, $_) } @texts],
+          'results and errors same as parse_json');
+
+$depth = 100000;
+$x = parse_json_iter('[' x $depth . ']' x $depth);
+$depth = 0;
+$x = $x->[0], ++$depth while @$x;
+is($depth, 99999, 'parsing deeply nested arrays works');
+
+$x = result(\&parse_json_iter, '{"a":' x 1000 . '[1,2' . '}' x 1000);
+is_deeply($x, [JSON::Uni::UJ_E_INV_IN, 5004], 'error in deeply nested structure');
+
+set_max_nesting(2);
+@texts = ('[[1]]', '[[[1]]]', '{"a":[{}]}');
+is_deeply([map { result(\&parse_json_iter, $_) } @texts],
+          [map { result(\&parse_json, $_) } @texts],
+          'nesting limit same as parse_json');
+set_max_nesting(-1);
+
+$x = parse_json_iter('[' x 100 . '"abc"' . ']' x 100);
+$x = $x->[0] while ref($x);
+is($x, 'abc', 'values at depth are correct');
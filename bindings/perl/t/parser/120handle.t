@@ -0,0 +1,37 @@
+# -*- perl -*-
+#
+# test parser objects
+#
+
+use Test::More tests => 7;
+use JSON::Uni qw(parse_json max_nesting UJ_E_TOO_DEEP UJ_E_INV_IN UJ_P_ITER);
+
+my ($p, $q, $x);
+
+$p = JSON::Uni::Parser->new();
+$x = $p->parse('{"a" : [1, "b", null], "c" : {"a" : true}}');
+is_deeply($x, {a => [1, 'b', undef], c => {a => 1}}, 'parsing with a parser object works');
+
+$x = [map { $p->parse($_) } '{"k" : 1}', '{"k" : 2}', '[{"k" : 3}]'];
+is_deeply($x, [{k => 1}, {k => 2}, [{k => 3}]], 'parser object can be reused');
+
+$q = JSON::Uni::Parser->new(2);
+is_deeply([$p->max_nesting(), $q->max_nesting(), max_nesting()], [0xffffffff, 2, 0xffffffff],
+          'nesting limits are per parser');
+
+$x = [eval { $q->parse('[[[1]]]', sub { die([@_]) }) } // $@];
+is_deeply($x, [[UJ_E_TOO_DEEP, 2]], 'nesting limit of a parser is enforced');
+
+$q->set_max_nesting(3);
+$x = $q->parse('[[[1]]]');
+is_deeply($x, [[[1]]], 'nesting limit of a parser can be changed');
+
+eval {
+    $p->parse('[1, 2 x');
+};
+like($@, qr/invalid char in value/, 'default error handler dies');
+
+$p->set_flags(UJ_P_ITER);
+$x = $p->parse('[' x 1000 . '{"a" : "b"}' . ']' x 1000);
+$x = $x->[0] while ref($x) eq 'ARRAY';
+is_deeply([$p->flags(), $x], [UJ_P_ITER, {a => 'b'}], 'parser object with iterative parser works');
@@ -0,0 +1,60 @@
+# -*- perl -*-
+#
+# test the two-stage parser
+#
+
+use Test::More tests => 6;
+use JSON::Uni qw(parse_json parse_json_tape set_max_nesting UJ_P_TAPE UJ_P_IN_SITU);
+
+#*  helpers
+#
+sub result
+{
+    my ($parse, $text) = @_;
+    my $r;
+
+    $r = eval { [$parse->($text, sub { die([@_]) })] };
+    return $r // $@;
+}
+
+#*  tests
+#
+my (@texts, $long, $parser, $x);
+
+$long = '"' . 'a' x 61 . '\\\\\\"' . 'b' x 60 . '\\\\' . '"';
+@texts = (
+    '123', '"abc"', 'true', ' null ', '[]', '{}', '[1, [2, [3, {}]], []]',
+    '{"a" : {"b" : [true, false, null]}, "c" : "d"}',
+    '', ' ', ']', '[', '[1,', '[1 2]', '[}', '{]', '{,', '{1:2}', '{[1]:2}', '{"a" 1}',
+    '{"a":}', '{"a":1,}', '{"a":1,2:3}', '{"a":1', '[1,]', '1 2', '[1x]', '[[[]]] x',
+    '[truex]', '[1"a"]', '{"a":1"b":2}', '"abc', '["a]', '[1]]', '[[1]',
+    $long, "[$long, {$long : [$long]}]", "[$long", '[' . '1, ' x 40 . '"\\"]"]',
+);
+is_deeply([map { result(\&parse_json_tape, $_) } @texts],
+          [map { result(\&parse_json, $_) } @texts],
+          'results and errors same as parse_json');
+
+$x = parse_json_tape('[' . join(',', 1 .. 1000) . ']');
+is(scalar(@$x), 1000, 'large array');
+
+set_max_nesting(2);
+@texts = ('[[1]]', '[[[1]]]', '{"a":[{}]}');
+is_deeply([map { result(\&parse_json_tape, $_) } @texts],
+          [map { result(\&parse_json, $_) } @texts],
+          'nesting limit same as parse_json');
+set_max_nesting(-1);
+
+$parser = JSON::Uni::Parser->new(-1, UJ_P_TAPE);
+is_deeply([map { result(sub { $parser->parse(@_) }, $_) } '[1,{"a":[2]}]', '[1,', '{"b":[' . '3,' x 100 . '4]}'],
+          [map { result(\&parse_json, $_) } '[1,{"a":[2]}]', '[1,', '{"b":[' . '3,' x 100 . '4]}'],
+          'parser object reuses tape');
+
+$parser->set_max_nesting(1);
+is_deeply(result(sub { $parser->parse(@_) }, '[[1]]'), [JSON::Uni::UJ_E_TOO_DEEP, 1],
+          'parser object nesting limit');
+
+$parser = JSON::Uni::Parser->new(-1, UJ_P_TAPE | UJ_P_IN_SITU);
+@texts = ('"\\""1.5e-3', ' "\\t"tru', '["a\\nb", 1x]', '["a\\u2193b"]');
+is_deeply([map { result(sub { $parser->parse(@_) }, $_) } @texts],
+          [map { result(\&parse_json, $_) } @texts],
+          'errors after in-situ unescaping same as parse_json');
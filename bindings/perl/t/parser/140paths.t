@@ -0,0 +1,56 @@
+# -*- perl -*-
+#
+# test path-projected parsing
+#
+
+use Test::More tests => 7;
+use JSON::Uni qw(parse_json parse_json_paths UJ_PATH_NO_VALIDATE UJ_E_INV_PATH);
+
+#*  helpers
+#
+sub errors
+{
+    my ($parse, $text) = @_;
+    my $r;
+
+    $r = eval { $parse->($text, sub { die([@_]) }); [] };
+    return $r // $@;
+}
+
+#*  tests
+#
+my ($doc, @texts, @x);
+
+$doc = '{"user" : {"id" : 12, "name" : "x", "a/b" : 1, "m~n" : 2, "\\u2193" : 3},
+         "items" : [{"price" : 1.5, "tags" : ["a", "b"]}, {"price" : 2, "s" : "\\"]}"}, {"x" : null}],
+         "" : 7}';
+
+@x = parse_json_paths($doc, ['/user/id', '/user/a~1b', '/user/m~0n', "/user/\x{2193}", '/items/1/s', '/', '/nope', '/items/3']);
+is_deeply(\@x, [12, 1, 2, 3, '"]}', 7, undef, undef], 'simple paths');
+
+@x = parse_json_paths($doc, ['/items/*/price', '/items/0/tags/*', '/*/id']);
+is_deeply(\@x, [[1.5, 2], ['a', 'b'], [12]], 'wildcards');
+
+@x = parse_json_paths($doc, ['', '/items/0', '/items/0/tags']);
+is_deeply(\@x, [parse_json($doc), parse_json($doc)->{items}[0], ['a', 'b']], 'nested paths');
+
+@texts = (
+    '', ' ', ']', '[1 2]', '{"a":[1,2x]}', '{"b":{"c":tru}}', '{"a":1,"b":[1,}', '{1:2}', '{"a":1} x',
+    '["\\x"]', "[\"\x01\"]", '{"a":"b",}', '[[[[', '{"b":"', '{"b":0012}',
+);
+is_deeply([map { errors(sub { parse_json_paths($_[0], ['/a', '/*/zz'], $_[1]) }, $_) } @texts],
+          [map { errors(\&parse_json, $_) } @texts],
+          'errors same as parse_json');
+
+@x = parse_json_paths('{"b":{"c":tru, "d":"\\x"}, "a":[1]}', ['/a'], undef, UJ_PATH_NO_VALIDATE);
+is_deeply(\@x, [[1]], 'skipped values not validated');
+
+is_deeply(errors(sub { parse_json_paths($_[0], ['/a', 'a'], $_[1]) }, '{}'), [UJ_E_INV_PATH, 1],
+          'invalid pointer');
+
+$doc = "{\"\xc3\xa9t\xc3\xa9\" : 1, \"\\u00e9\" : 2}";
+@texts = ("/\xe9t\xe9", "/\xe9");
+@x = parse_json_paths($doc, [@texts]);
+utf8::upgrade($_) for @texts;
+push(@x, parse_json_paths($doc, [@texts]));
+is_deeply(\@x, [1, 2, 1, 2], 'non-ASCII paths');
@@ -0,0 +1,51 @@
+# -*- perl -*-
+#
+# test validation without parsing
+#
+
+use Test::More tests => 5;
+use JSON::Uni qw(parse_json is_valid_json set_max_nesting UJ_E_TOO_DEEP);
+
+#*  helpers
+#
+sub result
+{
+    my ($text) = @_;
+    my $r;
+
+    $r = eval { parse_json($text, sub { die([0, @_]) }); [1] };
+    return $r // $@;
+}
+
+sub valid
+{
+    my ($ok, @err) = is_valid_json($_[0]);
+    return [$ok ? 1 : 0, @err];
+}
+
+#*  tests
+#
+my @texts;
+
+@texts = (
+    '123', '"abc"', 'true', ' null ', '[]', '{}', '[1, [2, [3, {}]], []]',
+    '{"a" : {"b" : [true, false, null]}, "c" : "d\\u2193\\n"}', "[\"\xe2\x86\x93\"]",
+    '', ' ', ']', '[', '[1,', '[1 2]', '[}', '{]', '{,', '{1:2}', '{[1]:2}', '{[1}:2}', '{"a" 1}',
+    '{"a":}', '{"a":1,}', '{"a":1,2:3}', '{"a":1', '[1,]', '1 2', '[1x]', '[[[]]] x',
+    '[01]', '[1.]', '[tru]', '["\\x"]', "[\"\x01\"]", "[\"\xff\"]", '{"a":[{"b":{}}, {"c":[]}]}',
+);
+is_deeply([map { valid($_) } @texts], [map { result($_) } @texts],
+          'results same as parse_json');
+
+ok(!is_valid_json('{"a":1') && is_valid_json('{"a":1}'), 'scalar context');
+
+set_max_nesting(2);
+@texts = ('[[1]]', '[[[1]]]', '{"a":[{}]}');
+is_deeply([map { valid($_) } @texts], [map { result($_) } @texts],
+          'nesting limit same as parse_json');
+set_max_nesting(-1);
+
+is_deeply(valid('[' x 100000 . ']' x 100000), [0, UJ_E_TOO_DEEP, 65536],
+          'nesting depth is bounded');
+
+is_deeply(valid('[' x 65536 . ']' x 65536), [1], 'maximum nesting depth');
@@ -3,7 +3,7 @@
 # test string serialization
 #
 
-use Test::More tests => 3;
+use Test::More tests => 4;
 use JSON::Uni	'json_serialize';
 
 $x = json_serialize('abc');
@@ -14,3 +14,15 @@ is($x, '"ab\u0001\u0005de"', 'string with control chars serializes correctly');
 
 $x = json_serialize("\tbla\n\tblubb\n");
 is($x, '"\tbla\n\tblubb\n"', 'short escape sequences work');
+
+my %short = ("\b" => '\b', "\t" => '\t', "\n" => '\n', "\f" => '\f', "\r" => '\r',
+             '"' => '\"', '\\' => '\\\\');
+my ($s, $exp) = ('', '');
+for (0 .. 299) {
+    my $c = $_ % 7 ? 'x' x ($_ % 70) : '';
+    my $e = chr($_ % 3 ? $_ % 32 : ($_ & 1 ? 34 : 92));
+    $s .= $c.$e;
+    $exp .= $c.($short{$e} // sprintf('\u%04x', ord($e)));
+}
+$x = json_serialize($s);
+is($x, "\"$exp\"", 'escapes between runs of different lengths serialize correctly');
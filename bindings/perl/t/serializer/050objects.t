@@ -3,7 +3,7 @@
 # test object serialization
 #
 
-use Test::More tests => 6;
+use Test::More tests => 8;
 use JSON::Uni	qw(parse_json json_serialize UJ_FMT_PRETTY UJ_FMT_DET);
 
 my ($x, $y);
@@ -45,3 +45,11 @@ is($y, 1, 'pretty-printing a complex object worked 50 times in a row');
 
 $x = json_serialize({z => 0, b => 1, k => 2}, UJ_FMT_DET);
 is($x, '{"b":1,"k":2,"z":0}', 'deterministic serializer works');
+
+$d = [ { map { ($_ => [$_]) } 'a' .. 'e' } ];
+$d = { y => 1, x => $d } for 1 .. 40;
+$x = json_serialize($d, UJ_FMT_PRETTY);
+is_deeply(parse_json($x), $d, 'deeply nested pretty-printed objects round-trip');
+
+($y) = sort { $b <=> $a } map { length } $x =~ /\n(\t*)/g;
+is($y, 43, 'deeply nested objects are indented correctly');
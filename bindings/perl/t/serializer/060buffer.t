@@ -0,0 +1,23 @@
+# -*- perl -*-
+#
+# test serialization of output larger than the internal buffer
+#
+
+use Test::More tests => 3;
+use JSON::Uni	qw(json_serialize parse_json);
+
+
+my ($x, $exp, $long);
+
+$x = json_serialize([1 .. 5000]);
+$exp = '['.join(',', 1 .. 5000).']';
+is($x, $exp, 'array larger than the output buffer serializes correctly');
+
+$long = ('abc"def\\' x 1000)."\n";
+$x = json_serialize(['x', $long, 'y']);
+$exp = '["x","'.('abc\\"def\\\\' x 1000).'\\n","y"]';
+is($x, $exp, 'long string bypassing the output buffer serializes correctly');
+
+my $v = { map { ("k$_" => [$_, { a => "v$_" }]) } 1 .. 500 };
+$x = json_serialize($v, 2);
+is_deeply(parse_json($x), $v, 'large pretty-printed object round-trips');
@@ -0,0 +1,36 @@
+# -*- perl -*-
+#
+# test serialization of native numbers
+#
+
+use Test::More tests => 6;
+use B;
+use JSON::Uni	qw(json_serialize parse_json);
+
+
+my ($x, @nums, $n);
+
+$x = json_serialize([0, -1, 9223372036854775807, -9223372036854775808, 18446744073709551615]);
+is($x, '[0,-1,9223372036854775807,-9223372036854775808,18446744073709551615]',
+   'integers serialize correctly');
+
+$x = json_serialize([0.1, 0.3, 123.45, 1/3, 2.5e-5, -0.5]);
+is($x, '[0.1,0.3,123.45,0.3333333333333333,0.000025,-0.5]',
+   'doubles serialize as shortest decimals');
+
+$x = json_serialize([1e21, 1e-7, 5e-324, 1.7976931348623157e308]);
+is($x, '[1e+21,1e-7,5e-324,1.7976931348623157e+308]',
+   'very large and small doubles use e notation');
+
+srand(1);
+@nums = map { (rand() - 0.5) * 10 ** int(rand(600) - 300) } 1 .. 1000;
+$x = parse_json(json_serialize(\@nums));
+is(scalar(grep { $x->[$_] != $nums[$_] } 0 .. $#nums), 0, 'doubles round-trip');
+
+$n = 1.25;
+json_serialize([$n]);
+ok(!(B::svref_2object(\$n)->FLAGS & B::SVf_POK), 'serializing a number leaves it without string value');
+
+$n = "17";
+$n + 0;
+is(json_serialize([$n]), '[17]', 'string used as number serializes as number');
@@ -0,0 +1,45 @@
+# -*- perl -*-
+#
+# test serialization to file descriptors
+#
+
+use Test::More tests => 4;
+use Fcntl;
+use JSON::Uni	qw(json_serialize json_serialize_fd UJ_FMT_DET);
+
+
+my ($v, $fh, $json, $pid, $rd, $wr, $got);
+
+$v = {
+    short => [map { "s$_" } 1 .. 5000],
+    long => [map { ("x" x (200 + $_)).qq(\n"\\).("y" x 1000) } 1 .. 300],
+    num => [map { $_ / 7 } 1 .. 1000]
+};
+$json = json_serialize($v, UJ_FMT_DET);
+
+open($fh, '+>', undef);
+print $fh 'pre:';
+ok(json_serialize_fd($v, $fh, UJ_FMT_DET), 'serializing to a file handle succeeds');
+
+seek($fh, 0, 0);
+$got = do { local $/; <$fh> };
+is($got, "pre:$json", 'file contains buffered data followed by the JSON text');
+
+pipe($rd, $wr);
+$pid = fork();
+if (!$pid) {
+    close($wr);
+    sleep(1);
+    $got = do { local $/; <$rd> };
+    exit($got eq $json ? 0 : 1);
+}
+
+close($rd);
+fcntl($wr, F_SETFL, fcntl($wr, F_GETFL, 0) | O_NONBLOCK);
+json_serialize_fd($v, fileno($wr), UJ_FMT_DET);
+close($wr);
+waitpid($pid, 0);
+is($?, 0, 'non-blocking pipe receives the complete JSON text');
+
+close($fh);
+ok(!defined(json_serialize_fd([1], $fh)) && $!, 'error is reported');
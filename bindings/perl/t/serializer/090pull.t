@@ -0,0 +1,43 @@
+# -*- perl -*-
+#
+# test pull serialization
+#
+
+use Test::More tests => 5;
+use JSON::Uni	qw(json_serialize);
+
+sub pull_all
+{
+    my ($v, $fmt, $max) = @_;
+    my ($pull, $out, $chunk);
+
+    $pull = JSON::Uni::Pull->new($v, $fmt);
+    $out = '';
+    $out .= $chunk while defined($chunk = $pull->next($max));
+
+    return $out;
+}
+
+sub expected
+{
+    my $x = json_serialize(@_);
+
+    utf8::encode($x);
+    return $x;
+}
+
+my ($v, $pull);
+
+$v = {
+      list => [1, 2.5, -3, "x\n\"y\"", undef, [], {}],
+      "\xe9t\xe9" => { nested => [ [ [ 'deep' ] ] ] },
+      long => 'abc\\' x 500,
+};
+
+is(pull_all($v, 0, 65536), expected($v, 0), 'pulled output equals serialized output');
+is(pull_all($v, 1, 1), expected($v, 1), 'single byte chunks, sorted keys');
+is(pull_all($v, 2, 7), expected($v, 2), 'small chunks, pretty-printed');
+
+$pull = JSON::Uni::Pull->new([1 .. 3]);
+is($pull->next, '[1,2,3]', 'whole output in one chunk');
+ok(!defined($pull->next), 'undef after the end of the output');
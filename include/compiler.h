@@ -9,5 +9,7 @@
 #define uni_json_compiler_h
 
 #define _hidden_ __attribute__ ((visibility ("hidden")))
+#define _init_ __attribute__ ((constructor))
+#define _target_(isa) __attribute__ ((target (isa)))
 
 #endif
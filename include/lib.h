@@ -20,4 +20,9 @@ struct uni_json_p_binding;
 void free_obj(int type, void *obj, struct uni_json_p_binding *binds) _hidden_;
 int skip_one_of(struct pstate *pstate, uint8_t *set) _hidden_;
 
+void start_batch(struct pstate *pstate) _hidden_;
+void end_batch(struct pstate *pstate, struct uni_json_p_binding *binds) _hidden_;
+int push_value(struct pstate *pstate, struct uni_json_p_binding *binds, void *v) _hidden_;
+void drop_values(struct pstate *pstate, struct uni_json_p_binding *binds, size_t base) _hidden_;
+
 #endif
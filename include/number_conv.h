@@ -0,0 +1,29 @@
+/*
+  conversion of numbers to native types
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+*/
+#ifndef uni_json_number_conv_h
+#define uni_json_number_conv_h
+
+/*  includes */
+#include <inttypes.h>
+#include <stddef.h>
+#include "compiler.h"
+
+/*  constants */
+enum {
+    POW5_MIN_Q =	-342,   /* smallest power of 10 in pow5_table */
+    POW5_MAX_Q =	324     /* largest ditto */
+};
+
+/*  variables */
+extern uint64_t pow5_table[][2] _hidden_;
+
+/*  routines */
+int conv_uint(uint8_t *p, size_t len, uint64_t *pv) _hidden_;
+double conv_double(uint8_t *p, size_t len) _hidden_;
+
+#endif
@@ -0,0 +1,26 @@
+/*
+  formatting of native numbers
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+*/
+#ifndef uni_json_number_fmt_h
+#define uni_json_number_fmt_h
+
+/*  includes */
+#include <inttypes.h>
+#include <stddef.h>
+#include "compiler.h"
+
+/*  constants */
+enum {
+    FMT_NUM_MAX =	32      /* buffer size sufficient for any formatted number */
+};
+
+/*  routines */
+size_t fmt_uint(uint64_t v, uint8_t *buf) _hidden_;
+size_t fmt_int(int64_t v, uint8_t *buf) _hidden_;
+size_t fmt_double(double v, uint8_t *buf) _hidden_;
+
+#endif
@@ -9,6 +9,7 @@
 #define uni_json_parser_literals_h
 
 /*  includes */
+#include <inttypes.h>
 #include "compiler.h"
 
 /*  types */
@@ -16,6 +17,8 @@ struct uni_json_p_binding;
 struct pstate;
 
 /*  routines */
+int skip_literal(struct pstate *pstate, uint8_t *want) _hidden_;
+
 void *parse_false(struct pstate *pstate, struct uni_json_p_binding *binds) _hidden_;
 void *parse_null(struct pstate *pstate, struct uni_json_p_binding *binds) _hidden_;
 void *parse_true(struct pstate *pstate, struct uni_json_p_binding *binds) _hidden_;
@@ -16,6 +16,7 @@ struct pstate;
 struct uni_json_p_binding;
 
 /*  routines */
+int skip_number(struct pstate *pstate, unsigned *pflags) _hidden_;
 void *parse_number(struct pstate *pstate, struct uni_json_p_binding *binds) _hidden_;
 
 #endif
@@ -0,0 +1,27 @@
+/*
+  skip values without creating them
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+*/
+#ifndef uni_json_parser_skip_h
+#define uni_json_parser_skip_h
+
+/*  includes */
+#include "compiler.h"
+
+/*  constants */
+enum {
+    SKIP_NONE,                  /* no value, cf no_value in uni_json_parser.c */
+    SKIP_OK                     /* value was skipped */
+};
+
+/*  types */
+struct pstate;
+
+/*  routines */
+int skip_value(struct pstate *pstate) _hidden_;
+int skip_value_fast(struct pstate *pstate) _hidden_;
+
+#endif
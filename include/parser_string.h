@@ -9,13 +9,49 @@
 #define uni_json_parser_string_h
 
 /*  includes */
+#include <inttypes.h>
 #include "compiler.h"
 
+/*  constants */
+enum {
+    N_INTERN =		256     /* size of the intern table, must be a power of 2 */
+};
+
+enum {
+    STAGE_SIZE =	256     /* decoded text buffered by parse_string_content */
+};
+
 /*  types */
 struct pstate;
 struct uni_json_p_binding;
 
+struct intern_slot {
+    uint8_t *data;
+    uint32_t len, hash;
+    void *str;
+};
+
+struct raw_key {
+    uint8_t *data;
+    size_t len;
+    uint32_t hash;
+    int esc;                    /* key contains escapes */
+};
+
 /*  routines */
 void *parse_string(struct pstate *pstate, struct uni_json_p_binding *binds) _hidden_;
 
+uint8_t *skip_utf8(uint8_t *p, uint8_t *e) _hidden_;
+int parse_string_content(struct pstate *pstate, struct uni_json_p_binding *binds,
+                         void *str) _hidden_;
+int parse_esc(struct pstate *pstate, struct uni_json_p_binding *binds, void *str) _hidden_;
+int parse_raw_key(struct pstate *pstate, struct uni_json_p_binding *binds,
+                  struct raw_key *rk) _hidden_;
+
+void start_intern(struct pstate *pstate, struct uni_json_p_binding *binds,
+                  struct intern_slot *slots) _hidden_;
+void reuse_intern(struct pstate *pstate, struct uni_json_p_binding *binds,
+                  struct intern_slot *slots) _hidden_;
+void end_intern(struct pstate *pstate, struct uni_json_p_binding *binds) _hidden_;
+
 #endif
@@ -0,0 +1,36 @@
+/*
+  parse complete JSON texts
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+*/
+#ifndef uni_json_parser_text_h
+#define uni_json_parser_text_h
+
+/*  includes */
+#include <inttypes.h>
+#include "compiler.h"
+
+/*  constants */
+enum {
+    INIT_FRAMES =	32      /* frames provided by callers of parse_text_iter */
+};
+
+/*  types */
+struct pstate;
+struct uni_json_p_binding;
+
+struct iter_frame {
+    void *ctr;                  /* array or object */
+    void *key;                  /* key of the member being parsed */
+    uint8_t *pos;               /* start of this key */
+    int state;
+};
+
+/*  routines */
+void *parse_text(struct pstate *pstate, struct uni_json_p_binding *binds) _hidden_;
+void *parse_text_iter(struct pstate *pstate, struct uni_json_p_binding *binds,
+                      struct iter_frame **frames, unsigned *n_frames) _hidden_;
+
+#endif
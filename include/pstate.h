@@ -10,12 +10,26 @@
 
 /*  includes */
 #include <inttypes.h>
+#include <stddef.h>
 
 /*  types */
+struct intern_slot;
+
 struct pstate {
     uint8_t *p, *e;
     int last_type;
-    unsigned level;
+    unsigned level, max_nesting;
+
+    /*  string interning, cf parser_string.c */
+    struct intern_slot *intern;
+    int key;                    /* parsing an object key */
+
+    int ascii;                  /* string had only ASCII chars, cf parser_string.c */
+
+    /*  value stack for batch adds, cf lib.c */
+    void **vs;
+    uint8_t *vs_types;
+    size_t vs_top, vs_size;
 
     struct {
         unsigned code;
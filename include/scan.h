@@ -0,0 +1,79 @@
+/*
+  block-wise scanning of string data
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+*/
+#ifndef uni_json_scan_h
+#define uni_json_scan_h
+
+/*  includes */
+#include <inttypes.h>
+#include "compiler.h"
+
+/*  constants */
+enum {
+    BLOCK_LEN =		64      /* bytes per block for classify_block */
+};
+
+/*  types */
+struct block_masks {
+    /*  bit n set if byte n of the block is ... */
+    uint64_t quote;             /* " */
+    uint64_t bslash;            /* \ */
+    uint64_t ws;                /* JSON whitespace */
+    uint64_t op;                /* one of [ ] { } , : */
+};
+
+/*  variables */
+extern uint8_t *(*skip_plain)(uint8_t *p, uint8_t *e) _hidden_;
+extern uint8_t *(*skip_no_esc)(uint8_t *p, uint8_t *e) _hidden_;
+extern int (*valid_utf8)(uint8_t *p, uint8_t *e) _hidden_;
+extern void (*classify_block)(uint8_t *p, struct block_masks *m) _hidden_;
+
+/*  routines */
+static inline uint64_t prefix_xor(uint64_t x)
+{
+    /*
+      Bit n of the result is the xor of bits 0 to n of x, ie, set
+      for the bytes between an opening and a closing quote.
+    */
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+static inline uint64_t find_escaped(uint64_t bslash, uint64_t *carry)
+{
+    /*
+      Return a mask of the bytes following an odd number of
+      backslashes. Runs of backslashes are rare, hence, it's
+      sufficient to loop over them. *carry is 1 if the first byte
+      of the next block is escaped.
+    */
+    uint64_t esc, bit;
+
+    esc = *carry;
+    *carry = 0;
+
+    while (bslash) {
+        bit = bslash & -bslash;
+        bslash ^= bit;
+
+        if (esc & bit) continue;
+
+        if (bit >> 63)
+            *carry = 1;
+        else
+            esc |= bit << 1;
+    }
+
+    return esc;
+}
+
+#endif
@@ -0,0 +1,51 @@
+/*
+  serializer internals shared by the push and pull serializers
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+*/
+#ifndef uni_json_ser_common_h
+#define uni_json_ser_common_h
+
+/*  includes */
+#include <inttypes.h>
+#include <stddef.h>
+#include "compiler.h"
+
+/*  constants */
+enum {
+    SCALAR_RUN =	16      /* bytes checked before using skip_no_esc */
+};
+
+/*  types */
+struct uj_kv_pair;
+struct uni_json_s_binding;
+
+struct esc {
+    uint8_t len;
+    uint8_t s[7];
+};
+
+struct kvp_heap {
+    struct uj_kv_pair *h;
+    size_t last;
+};
+
+/*  reusable storage for a kvp_heap */
+struct kvp_buf {
+    struct uj_kv_pair *kvps;
+    size_t size;
+};
+
+/*  variables */
+extern struct esc escs[256] _hidden_;
+
+/*  routines */
+struct uj_kv_pair *kvp_buf_get(struct kvp_buf *kb, size_t max_kvps,
+                               struct uni_json_s_binding *binds) _hidden_;
+void build_kvph(void *oiter, struct uj_kv_pair *kvps, struct kvp_heap *kvph,
+                struct uni_json_s_binding *binds) _hidden_;
+void rm_kvph_root(struct kvp_heap *kvph) _hidden_;
+
+#endif
@@ -0,0 +1,64 @@
+/*
+  structural index (tape)
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+*/
+#ifndef uni_json_tape_h
+#define uni_json_tape_h
+
+/*  includes */
+#include <inttypes.h>
+#include <stddef.h>
+#include "compiler.h"
+
+/*  constants */
+#define MAX_TAPE_LEN	(UINT32_MAX - 1)        /* positions must fit into 32 bits */
+
+/*  types */
+struct pstate;
+struct uni_json_p_binding;
+
+struct tape_ent {
+    uint32_t pos;               /* position in the text */
+
+    /*
+      For [ and {, index of the matching close char. For ] and },
+      number of values or key-value pairs in the container.
+    */
+    uint32_t n;
+};
+
+struct tape_frame {
+    void *ctr, *key;
+    int open;                   /* [ or { */
+};
+
+struct uni_json_tape {
+    struct uni_json_p_binding *binds;
+    uint8_t *data;
+    size_t len;
+
+    /*
+      ents has room for cap entries and stack, used while matching
+      brackets, for stack_size open ones. Both grow as needed and
+      are kept for the next text.
+    */
+    struct tape_ent *ents;
+    size_t n_ents, cap;
+    uint32_t *stack;
+    unsigned stack_size;
+    int bad;                    /* brackets don't match */
+
+    unsigned depth;             /* max nesting depth */
+    struct tape_frame *frames;
+    unsigned n_frames;
+};
+
+/*  routines */
+int tape_index(struct uni_json_tape *tape, uint8_t *data, size_t len) _hidden_;
+void *tape_walk(struct uni_json_tape *tape, struct pstate *pstate) _hidden_;
+void tape_release(struct uni_json_tape *tape) _hidden_;
+
+#endif
@@ -18,6 +18,12 @@ enum {
     UJ_NF_INT = 2               /* number is an integer */
 };
 
+enum {
+    UJ_SPAN_IN_SITU = 1,        /* unescape strings in the input buffer */
+    UJ_SPAN_INTERN_KEYS = 2,    /* reuse strings for repeated keys */
+    UJ_SPAN_INTERN_VALUES = 4   /* ditto for short string values */
+};
+
 /*  types */
 /**  parser bindings */
 struct uni_json_p_binding {
@@ -48,6 +54,51 @@ struct uni_json_p_binding {
 
     void *(*make_number)(uint8_t *data, size_t len, unsigned flags);
     void (*free_number)(void *num);
+
+    /*
+      Everything below is optional. The library reads all
+      members of this struct, hence, bindings must be compiled
+      with the header of the library version they're used with.
+      Changing the struct changes the major version (soname).
+    */
+
+    /*  parser state memory */
+    void *(*alloc)(size_t len);
+    void (*dealloc)(void *p);
+
+    /*  complete strings */
+    void *(*make_string_span)(uint8_t *data, size_t len);
+    void *(*dup_string)(void *str);
+    unsigned span_flags;
+
+    /*  native numbers */
+    void *(*make_int64)(int64_t v);
+    void *(*make_uint64)(uint64_t v);
+    void *(*make_double)(double v);
+
+    /*  containers of known size (two-stage parser and batch adds) */
+    void *(*make_object_sized)(size_t n);
+    void *(*make_array_sized)(size_t n);
+
+    /*
+      batch adds (recursive parser only): all children of a
+      container are added in one call when it's complete, kvs
+      alternates keys and values and n counts pairs
+    */
+    int (*add_n_2_object)(void **kvs, size_t n, void *obj);
+    int (*add_n_2_array)(void **values, size_t n, void *ary);
+
+    /*
+      raw keys (recursive parser only): keys are passed as bytes
+      with their hash instead of as strings, hash_key replaces
+      uni_json_key_hash with key_hash_seed if set
+    */
+    int (*add_raw_2_object)(uint8_t *key, size_t len, uint32_t hash, void *value, void *obj);
+    uint32_t (*hash_key)(uint8_t *key, size_t len);
+    uint64_t key_hash_seed;
+
+    /*  ASCII-only strings */
+    void (*mark_ascii)(void *str);
 };
 
 #endif
@@ -0,0 +1,51 @@
+/*
+  parser event bindings
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+*/
+#ifndef uni_json_p_events_h
+#define uni_json_p_events_h
+
+/*  includes */
+#include <inttypes.h>
+#include <stddef.h>
+
+/**  constants */
+enum {
+    UJ_EV_LAST = 1              /* last chunk of a string or key */
+};
+
+/*  types */
+/**  event bindings */
+struct uni_json_p_events {
+    /*  error handler */
+    void (*on_error)(unsigned code, size_t pos, void *p);
+
+    /*
+      All event routines return 1 to continue parsing and 0 to
+      stop. Routines which aren't needed can be NULL.
+    */
+
+    /*  objects */
+    int (*start_object)(void *p);
+    int (*key)(uint8_t *data, size_t len, unsigned flags, void *p);
+    int (*end_object)(void *p);
+
+    /*  arrays */
+    int (*start_array)(void *p);
+    int (*end_array)(void *p);
+
+    /*  simple types */
+    int (*string)(uint8_t *data, size_t len, unsigned flags, void *p);
+    int (*number)(uint8_t *data, size_t len, unsigned flags, void *p);
+    int (*boolean)(int true_false, void *p);
+    int (*null)(void *p);
+};
+
+/*  routines */
+int uni_json_parse_events(uint8_t *data, size_t len,
+                          struct uni_json_p_events *evs, void *p);
+
+#endif
@@ -28,18 +28,76 @@ enum {
     UJ_E_INV_ESC,                /* illegal escape sequence */
     UJ_E_INV_KEY,                /* object key is no string */
     UJ_E_NO_KEY,                 /* missing key in object */
-    UJ_E_TOO_DEEP                /* too many levels of nesting */
+    UJ_E_TOO_DEEP,               /* too many levels of nesting */
+    UJ_E_NO_MEM,                 /* failed to allocate memory */
+    UJ_E_INV_PATH                /* invalid JSON pointer */
+};
+
+/*  uni_json_parse_seq flags */
+enum {
+    UJ_SEQ_RESYNC = 1            /* continue after next linefeed after errors */
+};
+
+/*  uni_json_parse_paths flags */
+enum {
+    UJ_PATH_NO_VALIDATE = 1      /* don't validate skipped values */
+};
+
+/*  uni_json_parser flags */
+enum {
+    UJ_P_ITER = 1,               /* use the iterative parser */
+    UJ_P_TAPE = 2                /* use the two-stage parser */
 };
 
 /*   types */
 struct uni_json_p_binding;
+struct uni_json_feed;
+struct uni_json_parser;
+struct uni_json_tape;
 
 /*  variables */
 extern unsigned uni_json_max_nesting;
 
 /*  routines */
 char *uni_json_ec_2_msg(unsigned ec);
+uint32_t uni_json_key_hash(uint8_t *data, size_t len, uint64_t seed);
 void *uni_json_parse(uint8_t *data, size_t len,
                      struct uni_json_p_binding *binds, void *err_p);
+void *uni_json_parse_iter(uint8_t *data, size_t len,
+                          struct uni_json_p_binding *binds, void *err_p);
+int uni_json_parse_seq(uint8_t *data, size_t len, struct uni_json_p_binding *binds,
+                       int (*on_value)(void *val, size_t pos, void *cb_p),
+                       void *cb_p, unsigned flags);
+
+int uni_json_validate(uint8_t *data, size_t len, unsigned *err_code, size_t *err_pos);
+int uni_json_parse_paths(uint8_t *data, size_t len, struct uni_json_p_binding *binds,
+                         char **paths, unsigned n_paths,
+                         int (*on_value)(unsigned path, void *val, size_t pos, void *cb_p),
+                         void *cb_p, unsigned flags);
+
+/**  two-stage parser */
+void *uni_json_parse_tape(uint8_t *data, size_t len,
+                          struct uni_json_p_binding *binds, void *err_p);
+struct uni_json_tape *uni_json_tape_build(uint8_t *data, size_t len,
+                                          struct uni_json_p_binding *binds);
+void *uni_json_tape_parse(struct uni_json_tape *tape, void *err_p);
+void uni_json_tape_free(struct uni_json_tape *tape);
+
+/**  parser handles */
+struct uni_json_parser *uni_json_parser_new(struct uni_json_p_binding *binds);
+void uni_json_parser_free(struct uni_json_parser *parser);
+unsigned uni_json_parser_max_nesting(struct uni_json_parser *parser);
+void uni_json_parser_set_max_nesting(struct uni_json_parser *parser, unsigned max);
+unsigned uni_json_parser_flags(struct uni_json_parser *parser);
+void uni_json_parser_set_flags(struct uni_json_parser *parser, unsigned flags);
+void *uni_json_parser_parse(struct uni_json_parser *parser, uint8_t *data, size_t len,
+                            void *err_p);
+
+/**  push parser */
+struct uni_json_feed *uni_json_feed_start(struct uni_json_p_binding *binds, void *err_p);
+void uni_json_feed_budget(struct uni_json_feed *feed, size_t budget);
+int uni_json_feed(struct uni_json_feed *feed, uint8_t *data, size_t len, size_t *used);
+void *uni_json_feed_finish(struct uni_json_feed *feed);
+void uni_json_feed_abort(struct uni_json_feed *feed);
 
 #endif
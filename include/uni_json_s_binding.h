@@ -12,6 +12,14 @@
 #include <inttypes.h>
 #include <stddef.h>
 
+/*  constants */
+enum {
+    UJ_NUM_DATA,                /* use get_num_data */
+    UJ_NUM_INT64,
+    UJ_NUM_UINT64,
+    UJ_NUM_DOUBLE
+};
+
 /*  types */
 /**  auxiliary */
 struct uj_data {
@@ -24,6 +32,12 @@ struct uj_kv_pair {
     void *val;
 };
 
+union uj_num {
+    int64_t i;
+    uint64_t u;
+    double d;
+};
+
 /**  serializer bindings */
 struct uni_json_s_binding {
     /*  general */
@@ -52,6 +66,9 @@ struct uni_json_s_binding {
 
     /*  bool */
     int (*get_bool_value)(void *boolean);
+
+    /*  native numbers (optional) */
+    int (*get_num_value)(void *num, union uj_num *nv);
 };
 
 #endif
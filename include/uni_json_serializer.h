@@ -19,11 +19,33 @@ enum {
     UJ_FMT_PRETTY               /* use indentation for human-readable output */
 };
 
+enum {
+    UJ_FD_REF_DATA = 1          /* binding data stays valid until uni_json_serialize_fd returns */
+};
+
 /*   types */
 struct uni_json_s_binding;
+struct uni_json_serializer;
+struct uni_json_pull;
 
 /*  routines */
 void uni_json_serialize(void *val, void *sink, struct uni_json_s_binding *binds,
                         int fmt);
+int uni_json_serialize_fd(void *val, int fd, struct uni_json_s_binding *binds, int fmt,
+                          unsigned flags);
+
+/**  serializer handles */
+struct uni_json_serializer *uni_json_serializer_new(struct uni_json_s_binding *binds,
+                                                   void *sink, size_t buf_size);
+void uni_json_serializer_write(struct uni_json_serializer *ser, void *val, int fmt);
+void uni_json_serializer_output(struct uni_json_serializer *ser, uint8_t *data, size_t len);
+void uni_json_serializer_flush(struct uni_json_serializer *ser);
+void uni_json_serializer_finish(struct uni_json_serializer *ser);
+
+/**  pull serialization */
+struct uni_json_pull *uni_json_pull_start(struct uni_json_s_binding *binds, void *val,
+                                          int fmt);
+int uni_json_pull(struct uni_json_pull *pull, uint8_t *buf, size_t len, size_t *used);
+void uni_json_pull_free(struct uni_json_pull *pull);
 
 #endif
@@ -7,12 +7,19 @@
 */
 
 /*  includes */
+#include <string.h>
+
 #include "uni_json_p_binding.h"
 #include "uni_json_parser.h"
 #include "uni_json_types.h"
 #include "pstate.h"
 #include "lib.h"
 
+/*  constants */
+enum {
+    INIT_VS =		64          /* value stack entries */
+};
+
 /*  variables */
 static size_t dtor_ofs[] = {
 #define binds_ofs(m) offsetof(struct uni_json_p_binding, m)
@@ -74,3 +81,89 @@ int skip_one_of(struct pstate *pstate, uint8_t *set)
     pstate->err.pos = p;
     return -1;
 }
+
+/**  value stack */
+/*
+  With batch adds, the children of containers which are being
+  parsed are kept on a stack of values, together with their
+  types for freeing them after an error. The stack is allocated
+  when first needed and kept until end_batch.
+*/
+void start_batch(struct pstate *pstate)
+{
+    pstate->vs = NULL;
+    pstate->vs_types = NULL;
+    pstate->vs_top = pstate->vs_size = 0;
+}
+
+void end_batch(struct pstate *pstate, struct uni_json_p_binding *binds)
+{
+    if (pstate->vs) binds->dealloc(pstate->vs);
+    start_batch(pstate);
+}
+
+static int grow_vs(struct pstate *pstate, struct uni_json_p_binding *binds)
+{
+    /*
+      Double the size of the stack. Values and types are stored
+      in a single block, the types after the values.
+    */
+    uint8_t *types;
+    void **vs;
+    size_t size;
+
+    if (!binds->alloc) return -1;
+
+    size = pstate->vs_size ? pstate->vs_size * 2 : INIT_VS;
+    vs = binds->alloc(size * (sizeof(*vs) + 1));
+    if (!vs) return -1;
+    types = (uint8_t *)(vs + size);
+
+    if (pstate->vs) {
+        memcpy(vs, pstate->vs, pstate->vs_top * sizeof(*vs));
+        memcpy(types, pstate->vs_types, pstate->vs_top);
+        binds->dealloc(pstate->vs);
+    }
+
+    pstate->vs = vs;
+    pstate->vs_types = types;
+    pstate->vs_size = size;
+    return 0;
+}
+
+int push_value(struct pstate *pstate, struct uni_json_p_binding *binds, void *v)
+{
+    /*
+      Push a value of type pstate->last_type onto the stack. The
+      value is freed if this fails.
+    */
+    size_t top;
+
+    top = pstate->vs_top;
+    if (top == pstate->vs_size && grow_vs(pstate, binds) == -1) {
+        free_obj(pstate->last_type, v, binds);
+
+        pstate->err.code = UJ_E_NO_MEM;
+        pstate->err.pos = pstate->p;
+        return -1;
+    }
+
+    pstate->vs[top] = v;
+    pstate->vs_types[top] = pstate->last_type;
+    pstate->vs_top = top + 1;
+    return 0;
+}
+
+void drop_values(struct pstate *pstate, struct uni_json_p_binding *binds, size_t base)
+{
+    /*  free all values from base up */
+    size_t top;
+
+    top = pstate->vs_top;
+    while (top > base) {
+        --top;
+        free_obj(pstate->vs_types[top], pstate->vs[top], binds);
+    }
+
+    pstate->vs_top = base;
+}
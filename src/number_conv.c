@@ -0,0 +1,319 @@
+/*
+  conversion of numbers to native types
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+*/
+
+/*  includes */
+#define _GNU_SOURCE
+#include <alloca.h>
+#include <locale.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "number_conv.h"
+
+/*  constants */
+enum {
+    MAX_DIGITS =	19,     /* max number of digits which always fit into an uint64_t */
+    MAX_EXP =		100000, /* exponents larger than this are all the same */
+
+    /*  IEEE754 double */
+    MANT_BITS =		52,
+    EXP_MAX =		0x7ff,
+    EXP_BIAS =		1023,
+
+    /*  range of exact powers of 10 and integers (Clinger's fast path) */
+    EXACT_POW10 =	22
+};
+
+#define EXACT_INT (1ULL << 53)
+
+/*  variables */
+static double pow10s[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/*
+  Locale used for the slow path of conv_double. This makes strtod
+  independent of the decimal point character of the current locale.
+*/
+static locale_t c_locale;
+
+/*  routines */
+static void _init_ make_c_locale(void)
+{
+    c_locale = newlocale(LC_ALL_MASK, "C", (locale_t)0);
+}
+
+/**  digits */
+static inline int is_digit(unsigned c)
+{
+    return c - '0' < 10;
+}
+
+static inline uint64_t load8(uint8_t *p)
+{
+    uint64_t v;
+
+    memcpy(&v, p, 8);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+static inline uint32_t digits8(uint64_t v)
+{
+    /*
+      Convert 8 ASCII digits in a little-endian word to their value
+      with three multiplications: First, pairs of adjacent digits
+      are combined, then pairs of the resulting 2-digit numbers
+      and finally, both 4-digit numbers.
+    */
+    v -= 0x3030303030303030;
+    v = v * 10 + (v >> 8);
+    v = ((v & 0x000000ff000000ff) * (100 + (1000000ULL << 32))
+         + ((v >> 16) & 0x000000ff000000ff) * (1 + (10000ULL << 32))) >> 32;
+
+    return v;
+}
+
+static uint64_t accumulate(uint64_t v, uint8_t *p, size_t len)
+{
+    /*
+      Add len digits starting at p to v. The caller must ensure
+      that the result fits into an uint64_t.
+    */
+    while (len >= 8) {
+        v = v * 100000000 + digits8(load8(p));
+
+        p += 8;
+        len -= 8;
+    }
+
+    while (len) {
+        v = v * 10 + *p++ - '0';
+        --len;
+    }
+
+    return v;
+}
+
+int conv_uint(uint8_t *p, size_t len, uint64_t *pv)
+{
+    /*
+      Convert a string of len digits without leading zeros to an
+      uint64_t. Returns 0 on success and -1 if the value was too
+      large.
+    */
+    uint64_t v;
+
+    if (len <= MAX_DIGITS) {
+        *pv = accumulate(0, p, len);
+        return 0;
+    }
+
+    if (len > MAX_DIGITS + 1) return -1;
+
+    v = accumulate(0, p, MAX_DIGITS);
+    if (__builtin_mul_overflow(v, 10, &v)
+        || __builtin_add_overflow(v, p[MAX_DIGITS] - '0', &v))
+        return -1;
+
+    *pv = v;
+    return 0;
+}
+
+/**  doubles */
+static inline uint64_t inf_bits(void)
+{
+    return (uint64_t)EXP_MAX << MANT_BITS;
+}
+
+static int eisel_lemire(uint64_t w, int64_t q, uint64_t *pbits)
+{
+    /*
+      Compute the double closest to w * 10^q with the algorithm
+      described in
+
+      Daniel Lemire, Number Parsing at a Gigabyte per Second,
+      Software: Practice and Experience 51 (8), 2021
+
+      Returns 0 and the bits of the (positive) double on success
+      and -1 if the result couldn't be determined this way.
+    */
+    unsigned __int128 prod;
+    uint64_t hi, lo, lo2, m, *pow5;
+    int lz, upper, shift;
+    int64_t e2;
+
+    if (w == 0 || q < POW5_MIN_Q) {
+        *pbits = 0;
+        return 0;
+    }
+
+    if (q > POW5_MAX_Q) {
+        *pbits = inf_bits();
+        return 0;
+    }
+
+    /*  normalize w and multiply with the truncated 5^q */
+    lz = __builtin_clzll(w);
+    w <<= lz;
+
+    pow5 = pow5_table[q - POW5_MIN_Q];
+    prod = (unsigned __int128)w * pow5[0];
+    hi = prod >> 64;
+    lo = prod;
+
+    /*
+      If the bits below the 55 which are needed might be affected
+      by the truncation of 5^q, use the next 64 bits of it, too.
+    */
+    if ((hi & 0x1ff) == 0x1ff) {
+        lo2 = ((unsigned __int128)w * pow5[1]) >> 64;
+        lo += lo2;
+        if (lo2 > lo) ++hi;
+    }
+
+    if (lo == UINT64_MAX && (q < -27 || q > 55)) return -1;
+
+    upper = hi >> 63;
+    shift = upper + 64 - MANT_BITS - 3;
+    m = hi >> shift;
+    e2 = ((217706 * q) >> 16) + 63 + upper - lz + EXP_BIAS;
+
+    /*  subnormal */
+    if (e2 <= 0) {
+        if (-e2 + 1 >= 64) {
+            *pbits = 0;
+            return 0;
+        }
+
+        m >>= -e2 + 1;
+        m += m & 1;
+        m >>= 1;
+
+        *pbits = m;
+        return 0;
+    }
+
+    /*  exactly halfway between two doubles: round to even */
+    if (lo <= 1 && q >= -4 && q <= 23 && (m & 3) == 1
+        && m << shift == hi)
+        m &= ~1ULL;
+
+    m += m & 1;
+    m >>= 1;
+    if (m >= 2ULL << MANT_BITS) {
+        m = 1ULL << MANT_BITS;
+        ++e2;
+    }
+
+    if (e2 >= EXP_MAX) {
+        *pbits = inf_bits();
+        return 0;
+    }
+
+    *pbits = (uint64_t)e2 << MANT_BITS | (m & ~(1ULL << MANT_BITS));
+    return 0;
+}
+
+static double slow_double(uint8_t *p, size_t len)
+{
+    char *tmp;
+
+    tmp = alloca(len + 1);
+    memcpy(tmp, p, len);
+    tmp[len] = 0;
+
+    if (c_locale) return strtod_l(tmp, NULL, c_locale);
+    return strtod(tmp, NULL);
+}
+
+double conv_double(uint8_t *p, size_t len)
+{
+    /*
+      Convert a number in JSON syntax to the closest double.
+    */
+    uint8_t *s, *e, *i0, *i1, *f0, *f1, *d;
+    uint64_t w, bits;
+    int64_t q, x;
+    size_t nd;
+    double v;
+    int neg, x_neg;
+
+    s = p;
+    e = p + len;
+
+    neg = *p == '-';
+    p += neg;
+
+    /*  integral and fractional digits */
+    i0 = p;
+    while (p < e && is_digit(*p)) ++p;
+    i1 = p;
+
+    f0 = f1 = p;
+    if (p < e && *p == '.') {
+        f0 = ++p;
+        while (p < e && is_digit(*p)) ++p;
+        f1 = p;
+    }
+
+    /*  exponent */
+    x = 0;
+    if (p < e) {
+        ++p;
+
+        x_neg = *p == '-';
+        if (*p == '-' || *p == '+') ++p;
+
+        while (p < e) {
+            if (x < MAX_EXP) x = x * 10 + *p - '0';
+            ++p;
+        }
+
+        if (x_neg) x = -x;
+    }
+
+    /*  significant digits */
+    d = i0;
+    while (d < i1 && *d == '0') ++d;
+    if (d == i1) {
+        d = f0;
+        while (d < f1 && *d == '0') ++d;
+        nd = f1 - d;
+    } else
+        nd = (i1 - d) + (f1 - f0);
+
+    if (nd > MAX_DIGITS) return slow_double(s, len);
+
+    if (d < i1) {
+        w = accumulate(0, d, i1 - d);
+        w = accumulate(w, f0, f1 - f0);
+    } else
+        w = accumulate(0, d, f1 - d);
+    q = x - (f1 - f0);
+
+    /*
+      Clinger's fast path: if w and 10^|q| are both exactly
+      representable, a single IEEE multiplication or division
+      is correctly rounded.
+    */
+    if (w <= EXACT_INT && q >= -EXACT_POW10 && q <= EXACT_POW10) {
+        v = w;
+        v = q < 0 ? v / pow10s[-q] : v * pow10s[q];
+        return neg ? -v : v;
+    }
+
+    if (eisel_lemire(w, q, &bits) == -1) return slow_double(s, len);
+
+    if (neg) bits |= 1ULL << 63;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
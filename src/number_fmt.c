@@ -0,0 +1,268 @@
+/*
+  formatting of native numbers
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+*/
+
+/*  includes */
+#include <string.h>
+
+#include "number_conv.h"
+#include "number_fmt.h"
+
+/*  constants */
+enum {
+    /*  IEEE754 double */
+    MANT_BITS =		52,
+    EXP_MAX =		0x7ff,
+    EXP_BIAS =		1023,
+
+    /*  range of decimal exponents formatted without e notation */
+    MIN_PLAIN_EXP =	-6,
+    MAX_PLAIN_EXP =	21
+};
+
+/*  types */
+struct decimal {
+    uint64_t s;                 /* significand */
+    int k;                      /* exponent, value is s * 10^k */
+};
+
+/*  variables */
+static char digit_pairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/*  routines */
+/**  integers */
+size_t fmt_uint(uint64_t v, uint8_t *buf)
+{
+    /*
+      Write the decimal representation of v to buf, two digits at
+      a time starting with the least significant ones. Returns the
+      length.
+    */
+    uint8_t tmp[20], *p;
+    size_t len;
+
+    p = tmp + sizeof(tmp);
+    while (v >= 100) {
+        p -= 2;
+        memcpy(p, digit_pairs + 2 * (v % 100), 2);
+        v /= 100;
+    }
+
+    if (v >= 10) {
+        p -= 2;
+        memcpy(p, digit_pairs + 2 * v, 2);
+    } else
+        *--p = '0' + v;
+
+    len = tmp + sizeof(tmp) - p;
+    memcpy(buf, p, len);
+    return len;
+}
+
+size_t fmt_int(int64_t v, uint8_t *buf)
+{
+    if (v >= 0) return fmt_uint(v, buf);
+
+    *buf = '-';
+    return fmt_uint(-(uint64_t)v, buf + 1) + 1;
+}
+
+/**  doubles */
+static inline void pow10_approx(int e, uint64_t *hi, uint64_t *lo)
+{
+    /*
+      Return floor(10^e / 2^r) + 1 with r chosen such that the
+      result has 128 significant bits. 10^e and 5^e differ only in
+      the binary exponent, hence, this is the pow5_table entry for
+      e plus 1 where the entry is rounded down or exact (e < -27 or
+      e >= 0).
+    */
+    uint64_t *p5;
+
+    p5 = pow5_table[e - POW5_MIN_Q];
+    *hi = p5[0];
+    *lo = p5[1];
+
+    if ((e < -27 || e >= 0) && !++*lo) ++*hi;
+}
+
+static inline uint64_t round_to_odd(uint64_t g_hi, uint64_t g_lo, uint64_t cp)
+{
+    /*
+      The upper 64 bits of the 192-bit product of g and cp, with
+      the lowest bit set if any of the discarded bits are. g is too
+      large by less than 1, hence, the lowest 64 bits are ignored
+      and a middle word of 1 still counts as 0.
+    */
+    unsigned __int128 y;
+    uint64_t x1, z;
+
+    x1 = ((unsigned __int128)g_lo * cp) >> 64;
+    y = (unsigned __int128)g_hi * cp;
+    z = (uint64_t)y + x1;
+
+    return ((uint64_t)(y >> 64) + (z < x1)) | (z > 1);
+}
+
+static void to_decimal(uint64_t bits, struct decimal *d)
+{
+    /*
+      Determine the shortest decimal which rounds to the positive,
+      finite, non-zero double with the given bits, and of these the
+      one closest to it, with the algorithm described in
+
+      Raffaello Giulietti, The Schubfach way to render doubles, 2020
+
+      The double is c * 2^q. It's surrounded by an interval whose
+      bounds are halfway to the neighbouring doubles, all of
+      whose values round to it. The bounds and the value are scaled
+      by 4 * 10^-k for a k such that at most two decimals with one
+      digit less than the scaled value lie in the interval. If one
+      does, it's the result. Otherwise, the result is the scaled
+      value rounded to an integer.
+    */
+    uint64_t m, c, vbl, vb, vbr, lower, upper, s, g_hi, g_lo;
+    int e, q, k, h, closer, even, u_in, w_in;
+
+    m = bits & ((1ULL << MANT_BITS) - 1);
+    e = bits >> MANT_BITS;
+
+    if (e) {
+        c = m | 1ULL << MANT_BITS;
+        q = e - EXP_BIAS - MANT_BITS;
+
+        /*  integers < 2^53 */
+        if (q <= 0 && q > -MANT_BITS - 1 && !(c & ((1ULL << -q) - 1))) {
+            d->s = c >> -q;
+            d->k = 0;
+            return;
+        }
+    } else {
+        c = m;
+        q = 1 - EXP_BIAS - MANT_BITS;
+    }
+
+    /*
+      The lower bound is closer if c is a power of 2 which isn't
+      the smallest normal double.
+    */
+    closer = !m && e > 1;
+    even = !(c & 1);
+
+    /*  floor(log10(2^q)) or floor(log10(3/4 * 2^q)) */
+    k = (q * 1262611 - (closer ? 524031 : 0)) >> 22;
+    h = q + ((-k * 1741647) >> 19) + 1;
+    pow10_approx(-k, &g_hi, &g_lo);
+
+    vbl = round_to_odd(g_hi, g_lo, (4 * c - 2 + closer) << h);
+    vb = round_to_odd(g_hi, g_lo, 4 * c << h);
+    vbr = round_to_odd(g_hi, g_lo, (4 * c + 2) << h);
+
+    /*  bounds are included if c is even (round to even) */
+    lower = vbl + !even;
+    upper = vbr - !even;
+
+    s = vb / 4;
+    if (s >= 10) {
+        u_in = lower <= 40 * (s / 10);
+        w_in = 40 * (s / 10) + 40 <= upper;
+        if (u_in != w_in) {
+            d->s = s / 10 + w_in;
+            d->k = k + 1;
+            return;
+        }
+    }
+
+    u_in = lower <= 4 * s;
+    w_in = 4 * s + 4 <= upper;
+    if (u_in != w_in) {
+        d->s = s + w_in;
+        d->k = k;
+        return;
+    }
+
+    d->s = s + (vb > 4 * s + 2 || (vb == 4 * s + 2 && (s & 1)));
+    d->k = k;
+}
+
+size_t fmt_double(double v, uint8_t *buf)
+{
+    /*
+      Write the shortest decimal representation of the finite
+      double v which converts back to v to buf. Like JavaScript,
+      e notation is only used for very small and very large
+      values. Returns the length.
+    */
+    struct decimal d;
+    uint8_t digits[20], *p;
+    uint64_t bits;
+    int n, dp;
+
+    memcpy(&bits, &v, sizeof(bits));
+
+    p = buf;
+    if (bits >> 63) *p++ = '-';
+
+    bits &= ~(1ULL << 63);
+    if (!bits) {
+        *p++ = '0';
+        return p - buf;
+    }
+
+    to_decimal(bits, &d);
+    while (d.s % 10 == 0) {
+        d.s /= 10;
+        ++d.k;
+    }
+
+    n = fmt_uint(d.s, digits);
+    dp = n + d.k;               /* position of the decimal point */
+
+    if (d.k >= 0 && dp <= MAX_PLAIN_EXP) {
+        /*  integer */
+        memcpy(p, digits, n);
+        p += n;
+        memset(p, '0', d.k);
+        p += d.k;
+    } else if (dp > 0 && dp <= MAX_PLAIN_EXP) {
+        memcpy(p, digits, dp);
+        p += dp;
+        *p++ = '.';
+        memcpy(p, digits + dp, n - dp);
+        p += n - dp;
+    } else if (dp > MIN_PLAIN_EXP && dp <= 0) {
+        *p++ = '0';
+        *p++ = '.';
+        memset(p, '0', -dp);
+        p -= dp;
+        memcpy(p, digits, n);
+        p += n;
+    } else {
+        *p++ = *digits;
+        if (n > 1) {
+            *p++ = '.';
+            memcpy(p, digits + 1, n - 1);
+            p += n - 1;
+        }
+
+        *p++ = 'e';
+        *p++ = dp > 0 ? '+' : '-';
+        p += fmt_uint(dp > 0 ? dp - 1 : 1 - dp, p);
+    }
+
+    return p - buf;
+}
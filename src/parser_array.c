@@ -60,25 +60,93 @@ static int parse_array_content(struct pstate *pstate, struct uni_json_p_binding
     return 0;
 }
 
+static void *parse_array_batch(struct pstate *pstate, struct uni_json_p_binding *binds)
+{
+    /*
+      Like parse_array_content but collects the values on the
+      value stack and adds them to a new array in one call when
+      the array is complete.
+    */
+    size_t base, n;
+    void *ary, *v;
+    int rc;
+
+    base = pstate->vs_top;
+
+    v = parse_value(pstate, binds);
+    if (!v) return NULL;
+
+    if ((int *)v == &no_value) {
+        rc = skip_one_of(pstate, "]");
+        if (rc == -1) return NULL;
+    } else
+        do {
+            rc = push_value(pstate, binds, v);
+            if (rc == -1) goto fail;
+
+            rc = skip_one_of(pstate, ",]");
+            if (rc == -1) goto fail;
+
+            if (rc == ',') {
+                v = parse_value(pstate, binds);
+                if (!v) goto fail;
+
+                if ((int *)v == &no_value) {
+                    pstate->err.code = UJ_E_NO_VAL;
+                    pstate->err.pos = pstate->p;
+                    goto fail;
+                }
+            }
+        } while (rc == ',');
+
+    n = pstate->vs_top - base;
+    ary = binds->make_array_sized ? binds->make_array_sized(n) : binds->make_array();
+    if (n) {
+        rc = binds->add_n_2_array(pstate->vs + base, n, ary);
+        if (!rc) {
+            binds->free_array(ary);
+
+            pstate->err.code = UJ_E_ADD;
+            pstate->err.pos = pstate->p;
+            goto fail;
+        }
+
+        pstate->vs_top = base;
+    }
+
+    return ary;
+
+fail:
+    drop_values(pstate, binds, base);
+    return NULL;
+}
+
 void *parse_array(struct pstate *pstate, struct uni_json_p_binding *binds)
 {
     void *ary;
     int rc;
 
     ++pstate->level;
-    if (pstate->level > uni_json_max_nesting) {
+    if (pstate->level > pstate->max_nesting) {
         pstate->err.code = UJ_E_TOO_DEEP;
         pstate->err.pos = pstate->p;
         return NULL;
     }
 
-    ary = binds->make_array();
     ++pstate->p;
-
-    rc = parse_array_content(pstate, binds, ary);
-    if (rc == -1) {
-        binds->free_array(ary);
-        return NULL;
+    pstate->key = 0;
+
+    if (binds->add_n_2_array) {
+        ary = parse_array_batch(pstate, binds);
+        if (!ary) return NULL;
+    } else {
+        ary = binds->make_array();
+
+        rc = parse_array_content(pstate, binds, ary);
+        if (rc == -1) {
+            binds->free_array(ary);
+            return NULL;
+        }
     }
 
     pstate->last_type = UJ_T_ARY;
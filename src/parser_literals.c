@@ -11,9 +11,10 @@
 #include "uni_json_p_binding.h"
 #include "uni_json_parser.h"
 #include "uni_json_types.h"
+#include "parser_literals.h"
 
 /*  routines */
-static int skip_literal(struct pstate *pstate, uint8_t *want)
+int skip_literal(struct pstate *pstate, uint8_t *want)
 {
     /*
       Consume a literal value.
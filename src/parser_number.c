@@ -13,6 +13,7 @@
 #include "uni_json_p_binding.h"
 #include "uni_json_types.h"
 #include "pstate.h"
+#include "number_conv.h"
 #include "parser_number.h"
 
 /*  routines */
@@ -41,13 +42,20 @@ static int skip_digits(struct pstate *pstate)
     return 0;
 }
 
-void *parse_number(struct pstate *pstate, struct uni_json_p_binding *binds)
+int skip_number(struct pstate *pstate, unsigned *pflags)
 {
-    uint8_t *s, *dig_0;
+    /*
+      Consume a number. The UJ_NF_ flags describing it are returned
+      via *pflags.
+
+      Returns 0 on success and -1 after setting an error state
+      otherwise.
+    */
+    uint8_t *dig_0;
     unsigned flags;
     int rc;
 
-    dig_0 = s = pstate->p;
+    dig_0 = pstate->p;
     flags = UJ_NF_INT;
 
     /*  handle leading - */
@@ -59,11 +67,11 @@ void *parse_number(struct pstate *pstate, struct uni_json_p_binding *binds)
 
     /* handle integral part */
     rc = skip_digits(pstate);
-    if (rc == -1) return NULL;
+    if (rc == -1) return -1;
     if (*dig_0 == '0' && pstate->p - dig_0 > 1) {
         pstate->err.code = UJ_E_LEADZ;
         pstate->err.pos = dig_0;
-        return NULL;
+        return -1;
     }
 
     if (pstate->p < pstate->e) {
@@ -73,7 +81,7 @@ void *parse_number(struct pstate *pstate, struct uni_json_p_binding *binds)
             flags &= ~UJ_NF_INT;
 
             rc = skip_digits(pstate);
-            if (rc == -1) return NULL;
+            if (rc == -1) return -1;
             if (pstate->p == pstate->e) goto done;
         }
 
@@ -87,7 +95,7 @@ void *parse_number(struct pstate *pstate, struct uni_json_p_binding *binds)
             if (pstate->p == pstate->e) {
                 pstate->err.code = UJ_E_EOS;
                 pstate->err.pos = pstate->p - 1;
-                return NULL;
+                return -1;
             }
 
             switch (*pstate->p) {
@@ -97,11 +105,61 @@ void *parse_number(struct pstate *pstate, struct uni_json_p_binding *binds)
             }
 
             rc = skip_digits(pstate);
-            if (rc == -1) return NULL;
+            if (rc == -1) return -1;
         }
     }
 
 done:
+    *pflags = flags;
+    return 0;
+}
+
+static void *make_native(uint8_t *s, size_t len, unsigned flags,
+                         struct uni_json_p_binding *binds)
+{
+    /*
+      Create a number with one of the native number binding
+      routines if possible. Integers which don't fit into 64 bits
+      are treated as doubles.
+
+      Returns NULL if the binding doesn't support the type.
+    */
+    uint64_t u;
+    int neg, rc;
+
+    if (flags & UJ_NF_INT) {
+        neg = flags & UJ_NF_NEG ? 1 : 0;
+        rc = conv_uint(s + neg, len - neg, &u);
+        if (rc == 0) {
+            if (!neg) {
+                if (binds->make_uint64) return binds->make_uint64(u);
+            } else if (u <= (uint64_t)INT64_MAX + 1) {
+                if (binds->make_int64) return binds->make_int64(-(int64_t)(u - 1) - 1);
+            }
+        }
+    }
+
+    if (binds->make_double) return binds->make_double(conv_double(s, len));
+    return NULL;
+}
+
+void *parse_number(struct pstate *pstate, struct uni_json_p_binding *binds)
+{
+    uint8_t *s;
+    unsigned flags;
+    void *num;
+    int rc;
+
+    s = pstate->p;
+    rc = skip_number(pstate, &flags);
+    if (rc == -1) return NULL;
+
     pstate->last_type = UJ_T_NUM;
+
+    if (binds->make_double || binds->make_int64 || binds->make_uint64) {
+        num = make_native(s, pstate->p - s, flags, binds);
+        if (num) return num;
+    }
+
     return binds->make_number(s, pstate->p - s, flags);
 }
@@ -13,21 +13,61 @@
 #include "pstate.h"
 #include "lib.h"
 #include "parser_object.h"
+#include "parser_string.h"
 
 /*  extern declarations */
 extern int no_value;
 void *parse_value(struct pstate *, struct uni_json_p_binding *);
 
 /*  routines */
+static uint8_t *skip_ws(uint8_t *p, uint8_t *e)
+{
+    while (p < e && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p;
+    return p;
+}
+
+static void *parse_key(struct pstate *pstate, struct uni_json_p_binding *binds,
+                       struct raw_key *rk)
+{
+    /*
+      Parse a key. If rk isn't NULL, a string key without escapes
+      is parsed into it and rk returned. Everything else is parsed
+      like any other value.
+    */
+    void *k;
+    int rc;
+
+    if (rk) {
+        pstate->p = skip_ws(pstate->p, pstate->e);
+        if (pstate->p < pstate->e && *pstate->p == '"') {
+            rc = parse_raw_key(pstate, binds, rk);
+            if (rc == -1) return NULL;
+
+            if (rc) {
+                pstate->p = skip_ws(pstate->p, pstate->e);
+                return rk;
+            }
+        }
+    }
+
+    pstate->key = 1;
+    k = parse_value(pstate, binds);
+    pstate->key = 0;
+    return k;
+}
+
 static int parse_object_content(struct pstate *pstate, struct uni_json_p_binding *binds,
                                 void *obj)
 {
+    struct raw_key raw, *rk;
     void *k, *v;
     uint8_t *pos;
     int c, rc;
 
+    rk = binds->add_raw_2_object ? &raw : NULL;
+
     pos = pstate->p;
-    k = parse_value(pstate, binds);
+    k = parse_key(pstate, binds, rk);
     if (!k) return -1;
 
     if ((int *)k == &no_value) {
@@ -45,13 +85,13 @@ static int parse_object_content(struct pstate *pstate, struct uni_json_p_binding
 
             c = skip_one_of(pstate, ":");
             if (c == -1) {
-                binds->free_string(k);
+                if (k != rk) binds->free_string(k);
                 return -1;
             }
 
             v = parse_value(pstate, binds);
             if (!v || (int *)v == &no_value) {
-                binds->free_string(k);
+                if (k != rk) binds->free_string(k);
 
                 if ((int *)v == &no_value) {
                     pstate->err.code = UJ_E_NO_VAL;
@@ -61,9 +101,12 @@ static int parse_object_content(struct pstate *pstate, struct uni_json_p_binding
                 return -1;
             }
 
-            rc = binds->add_2_object(k, v, obj);
+            if (k == rk)
+                rc = binds->add_raw_2_object(rk->data, rk->len, rk->hash, v, obj);
+            else
+                rc = binds->add_2_object(k, v, obj);
             if (!rc) {
-                binds->free_string(k);
+                if (k != rk) binds->free_string(k);
                 free_obj(pstate->last_type, v, binds);
 
                 pstate->err.code = UJ_E_ADD;
@@ -76,7 +119,7 @@ static int parse_object_content(struct pstate *pstate, struct uni_json_p_binding
 
             if (c == ',') {
                 pos = pstate->p;
-                k = parse_value(pstate, binds);
+                k = parse_key(pstate, binds, rk);
                 if (!k) return -1;
 
                 if ((int *)k == &no_value) {
@@ -91,25 +134,124 @@ static int parse_object_content(struct pstate *pstate, struct uni_json_p_binding
     return 0;
 }
 
+static void *parse_object_batch(struct pstate *pstate, struct uni_json_p_binding *binds)
+{
+    /*
+      Like parse_object_content but collects keys and values on
+      the value stack and adds them to a new object in one call
+      when the object is complete.
+    */
+    void *obj, *k, *v;
+    size_t base, n;
+    uint8_t *pos;
+    int c, rc;
+
+    base = pstate->vs_top;
+
+    pos = pstate->p;
+    pstate->key = 1;
+    k = parse_value(pstate, binds);
+    pstate->key = 0;
+    if (!k) return NULL;
+
+    if ((int *)k == &no_value) {
+        c = skip_one_of(pstate, "}");
+        if (c == -1) return NULL;
+    } else {
+        do {
+            if (pstate->last_type != UJ_T_STR) {
+                free_obj(pstate->last_type, k, binds);
+
+                pstate->err.code = UJ_E_INV_KEY;
+                pstate->err.pos = pos;
+                goto fail;
+            }
+
+            rc = push_value(pstate, binds, k);
+            if (rc == -1) goto fail;
+
+            c = skip_one_of(pstate, ":");
+            if (c == -1) goto fail;
+
+            v = parse_value(pstate, binds);
+            if (!v) goto fail;
+
+            if ((int *)v == &no_value) {
+                pstate->err.code = UJ_E_NO_VAL;
+                pstate->err.pos = pstate->p;
+                goto fail;
+            }
+
+            rc = push_value(pstate, binds, v);
+            if (rc == -1) goto fail;
+
+            c = skip_one_of(pstate, ",}");
+            if (c == -1) goto fail;
+
+            if (c == ',') {
+                pos = pstate->p;
+                pstate->key = 1;
+                k = parse_value(pstate, binds);
+                pstate->key = 0;
+                if (!k) goto fail;
+
+                if ((int *)k == &no_value) {
+                    pstate->err.code = UJ_E_NO_KEY;
+                    pstate->err.pos = pstate->p;
+                    goto fail;
+                }
+            }
+        } while (c == ',');
+    }
+
+    n = (pstate->vs_top - base) / 2;
+    obj = binds->make_object_sized ? binds->make_object_sized(n) : binds->make_object();
+    if (n) {
+        rc = binds->add_n_2_object(pstate->vs + base, n, obj);
+        if (!rc) {
+            binds->free_object(obj);
+
+            pstate->err.code = UJ_E_ADD;
+            pstate->err.pos = pstate->p;
+            goto fail;
+        }
+
+        pstate->vs_top = base;
+    }
+
+    return obj;
+
+fail:
+    drop_values(pstate, binds, base);
+    return NULL;
+}
+
 void *parse_object(struct pstate *pstate, struct uni_json_p_binding *binds)
 {
     void *obj;
     int rc;
 
     ++pstate->level;
-    if (pstate->level > uni_json_max_nesting) {
+    if (pstate->level > pstate->max_nesting) {
         pstate->err.code = UJ_E_TOO_DEEP;
         pstate->err.pos = pstate->p;
         return NULL;
     }
 
-    obj = binds->make_object();
     ++pstate->p;
+    pstate->key = 0;
 
-    rc = parse_object_content(pstate, binds, obj);
-    if (rc == -1) {
-        binds->free_array(obj);
-        return NULL;
+    if (binds->add_n_2_object) {
+        obj = parse_object_batch(pstate, binds);
+        if (!obj) return NULL;
+    } else {
+        obj = binds->make_object();
+
+        rc = parse_object_content(pstate, binds, obj);
+        if (rc == -1) {
+            binds->free_array(obj);
+            return NULL;
+        }
     }
 
     pstate->last_type = UJ_T_OBJ;
@@ -0,0 +1,418 @@
+/*
+  skip values without creating them
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+*/
+
+/*  includes */
+#include <stddef.h>
+#include <string.h>
+
+#include "uni_json_p_binding.h"
+#include "uni_json_parser.h"
+#include "uni_json_types.h"
+#include "pstate.h"
+#include "lib.h"
+#include "scan.h"
+#include "parser_literals.h"
+#include "parser_number.h"
+#include "parser_string.h"
+#include "parser_skip.h"
+
+/*  types */
+typedef int skip_func(struct pstate *);
+
+/*  prototypes */
+static int whitespace(struct pstate *);
+static int close_char(struct pstate *);
+static int skip_false(struct pstate *);
+static int skip_null(struct pstate *);
+static int skip_true(struct pstate *);
+static int skip_num(struct pstate *);
+static int skip_string(struct pstate *);
+static int skip_array(struct pstate *);
+static int skip_object(struct pstate *);
+
+static int discard(uint8_t *, size_t, void *);
+
+/*  variables */
+static skip_func *skip_map[256] = {
+    /*
+      Same as tok_map in uni_json_parser.c but for the skipping
+      functions.
+    */
+    ['\t'] =		whitespace,
+    ['\r'] =		whitespace,
+    ['\n'] =		whitespace,
+    [' '] =		whitespace,
+
+    [']'] =		close_char,
+    ['}'] =		close_char,
+
+    ['f'] =		skip_false,
+    ['n'] =		skip_null,
+    ['t'] =		skip_true,
+
+    ['-'] =		skip_num,
+    ['0' ... '9'] =	skip_num,
+
+    ['"'] =		skip_string,
+
+    ['['] =		skip_array,
+    ['{'] =		skip_object
+};
+
+/*
+  The string parser adds data to strings with the add_2_string
+  binding routine. This one throws it away.
+*/
+static struct uni_json_p_binding discard_binds = {
+    .add_2_string =	discard
+};
+
+/*  routines */
+/**  helpers */
+static int whitespace(struct pstate *)
+{
+    /* dummy routine to mark whitespace in skip_map */
+    return -1;
+}
+
+static int close_char(struct pstate *)
+{
+    return SKIP_NONE;
+}
+
+static int discard(uint8_t *, size_t, void *)
+{
+    return 1;
+}
+
+static uint8_t *skip_ws(uint8_t *p, uint8_t *e)
+{
+    while (p < e && skip_map[*p] == whitespace) ++p;
+    return p;
+}
+
+static inline int fail(struct pstate *pstate, unsigned code, uint8_t *pos)
+{
+    pstate->err.code = code;
+    pstate->err.pos = pos;
+    return -1;
+}
+
+/**  simple values */
+static int skip_lit(struct pstate *pstate, uint8_t *want, int type)
+{
+    int rc;
+
+    rc = skip_literal(pstate, want);
+    if (rc == -1) return -1;
+
+    pstate->last_type = type;
+    return SKIP_OK;
+}
+
+static int skip_false(struct pstate *pstate)
+{
+    return skip_lit(pstate, "false", UJ_T_BOOL);
+}
+
+static int skip_null(struct pstate *pstate)
+{
+    return skip_lit(pstate, "null", UJ_T_NULL);
+}
+
+static int skip_true(struct pstate *pstate)
+{
+    return skip_lit(pstate, "true", UJ_T_BOOL);
+}
+
+static int skip_num(struct pstate *pstate)
+{
+    unsigned flags;
+    int rc;
+
+    rc = skip_number(pstate, &flags);
+    if (rc == -1) return -1;
+
+    pstate->last_type = UJ_T_NUM;
+    return SKIP_OK;
+}
+
+static int skip_string(struct pstate *pstate)
+{
+    int rc;
+
+    ++pstate->p;
+    rc = parse_string_content(pstate, &discard_binds, NULL);
+    if (rc == -1) return -1;
+
+    pstate->last_type = UJ_T_STR;
+    return SKIP_OK;
+}
+
+/**  structures */
+static int skip_array(struct pstate *pstate)
+{
+    /*  same checks in the same order as parse_array */
+    int rc;
+
+    ++pstate->level;
+    if (pstate->level > pstate->max_nesting)
+        return fail(pstate, UJ_E_TOO_DEEP, pstate->p);
+
+    ++pstate->p;
+
+    rc = skip_value(pstate);
+    if (rc == -1) return -1;
+
+    if (rc == SKIP_NONE) {
+        rc = skip_one_of(pstate, "]");
+        if (rc == -1) return -1;
+    } else
+        do {
+            rc = skip_one_of(pstate, ",]");
+            if (rc == -1) return -1;
+
+            if (rc == ',') {
+                rc = skip_value(pstate);
+                if (rc == -1) return -1;
+                if (rc == SKIP_NONE) return fail(pstate, UJ_E_NO_VAL, pstate->p);
+
+                rc = ',';
+            }
+        } while (rc == ',');
+
+    pstate->last_type = UJ_T_ARY;
+    --pstate->level;
+    return SKIP_OK;
+}
+
+static int skip_key(struct pstate *pstate)
+{
+    uint8_t *pos;
+    int rc;
+
+    pos = pstate->p;
+    rc = skip_value(pstate);
+    if (rc == SKIP_OK && pstate->last_type != UJ_T_STR)
+        return fail(pstate, UJ_E_INV_KEY, pos);
+
+    return rc;
+}
+
+static int skip_object(struct pstate *pstate)
+{
+    /*  same checks in the same order as parse_object */
+    int c, rc;
+
+    ++pstate->level;
+    if (pstate->level > pstate->max_nesting)
+        return fail(pstate, UJ_E_TOO_DEEP, pstate->p);
+
+    ++pstate->p;
+
+    rc = skip_key(pstate);
+    if (rc == -1) return -1;
+
+    if (rc == SKIP_NONE) {
+        c = skip_one_of(pstate, "}");
+        if (c == -1) return -1;
+    } else
+        do {
+            c = skip_one_of(pstate, ":");
+            if (c == -1) return -1;
+
+            rc = skip_value(pstate);
+            if (rc == -1) return -1;
+            if (rc == SKIP_NONE) return fail(pstate, UJ_E_NO_VAL, pstate->p);
+
+            c = skip_one_of(pstate, ",}");
+            if (c == -1) return -1;
+
+            if (c == ',') {
+                rc = skip_key(pstate);
+                if (rc == -1) return -1;
+                if (rc == SKIP_NONE) return fail(pstate, UJ_E_NO_KEY, pstate->p);
+            }
+        } while (c == ',');
+
+    pstate->last_type = UJ_T_OBJ;
+    --pstate->level;
+    return SKIP_OK;
+}
+
+/**  without validation */
+static inline int delimiter(unsigned c)
+{
+    /*  chars which can end a number or literal */
+    switch (c) {
+    case '\t':
+    case '\r':
+    case '\n':
+    case ' ':
+    case ',':
+    case ':':
+    case '[':
+    case ']':
+    case '{':
+    case '}':
+    case '"':
+        return 1;
+    }
+
+    return 0;
+}
+
+static uint8_t *skip_string_fast(uint8_t *p, uint8_t *e)
+{
+    /*
+      Return a pointer to the byte after the closing quote of the
+      string starting at p or NULL if there is none.
+    */
+    ++p;
+    while (p = skip_no_esc(p, e), p < e) {
+        switch (*p) {
+        case '"':
+            return p + 1;
+
+        case '\\':
+            p += 2;
+            break;
+
+        default:
+            ++p;
+        }
+    }
+
+    return NULL;
+}
+
+static uint8_t *skip_ctr_fast(uint8_t *p, uint8_t *e)
+{
+    /*
+      Return a pointer to the byte after the close char matching
+      the open char at p or NULL if there is none. Works on blocks
+      of BLOCK_LEN bytes, like stage 1 of the two-stage parser,
+      and only looks at the brackets outside of strings.
+    */
+    uint8_t last[BLOCK_LEN], *b;
+    uint64_t esc_carry, in_str, prev_in_str, quote, ops;
+    struct block_masks m;
+    unsigned depth;
+    int c;
+
+    esc_carry = prev_in_str = 0;
+    depth = 0;
+
+    while (p < e) {
+        b = p;
+        if (e - p < BLOCK_LEN) {
+            memset(last, ' ', sizeof(last));
+            memcpy(last, p, e - p);
+            b = last;
+        }
+
+        classify_block(b, &m);
+
+        quote = m.quote & ~find_escaped(m.bslash, &esc_carry);
+        in_str = prefix_xor(quote) ^ prev_in_str;
+        prev_in_str = (uint64_t)((int64_t)in_str >> 63);
+
+        ops = m.op & ~in_str;
+        while (ops) {
+            c = b[__builtin_ctzll(ops)];
+            switch (c) {
+            case '[':
+            case '{':
+                ++depth;
+                break;
+
+            case ']':
+            case '}':
+                if (!--depth) return p + __builtin_ctzll(ops) + 1;
+            }
+
+            ops &= ops - 1;
+        }
+
+        p += BLOCK_LEN;
+    }
+
+    return NULL;
+}
+
+/**  API */
+int skip_value(struct pstate *pstate)
+{
+    /*
+      Skip a JSON value and surrounding whitespace like
+      parse_value parses it, with the same checks but without
+      calling any binding routines. Sets pstate->last_type.
+
+      Returns SKIP_OK if a value was skipped, SKIP_NONE if there
+      was none and -1 in case of an error.
+    */
+    skip_func *skip;
+    uint8_t *p, *e;
+    int rc;
+
+    e = pstate->e;
+    p = pstate->p = skip_ws(pstate->p, e);
+    if (p == e) return SKIP_NONE;
+
+    skip = skip_map[*p];
+    if (!skip) return fail(pstate, UJ_E_INV, p);
+
+    rc = skip(pstate);
+    if (rc != SKIP_OK) return rc;
+
+    pstate->p = skip_ws(pstate->p, e);
+    return SKIP_OK;
+}
+
+int skip_value_fast(struct pstate *pstate)
+{
+    /*
+      Skip a JSON value and surrounding whitespace without
+      validating it. Only the boundaries of strings, arrays and
+      objects are located. Other values end at the next
+      whitespace or structural char. Doesn't set
+      pstate->last_type.
+
+      Returns the same as skip_value. Errors are reported at the
+      end of the text if a string, array or object isn't closed.
+    */
+    skip_func *skip;
+    uint8_t *p, *e;
+
+    e = pstate->e;
+    p = pstate->p = skip_ws(pstate->p, e);
+    if (p == e) return SKIP_NONE;
+
+    skip = skip_map[*p];
+    if (!skip) return fail(pstate, UJ_E_INV, p);
+    if (skip == close_char) return SKIP_NONE;
+
+    switch (*p) {
+    case '"':
+        p = skip_string_fast(p, e);
+        break;
+
+    case '[':
+    case '{':
+        p = skip_ctr_fast(p, e);
+        break;
+
+    default:
+        do ++p; while (p < e && !delimiter(*p));
+    }
+
+    if (!p) return fail(pstate, UJ_E_EOS, e);
+
+    pstate->p = skip_ws(p, e);
+    return SKIP_OK;
+}
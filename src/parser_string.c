@@ -9,16 +9,24 @@
 /*  includes */
 #include <stddef.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "uni_json_parser.h"
 #include "uni_json_p_binding.h"
 #include "uni_json_types.h"
 #include "pstate.h"
+#include "scan.h"
 #include "parser_string.h"
 
 /*  constants */
 enum {
-    MIN_LEGAL =		32              /* minimum char code which may appear unescaped in a string */
+    MIN_LEGAL =		32,             /* minimum char code which may appear unescaped in a string */
+    MAX_UTF8_LEN =	4               /* max length of an UTF-8 sequence */
+};
+
+enum {
+    MAX_INTERN_KEY =	64,     /* max length of an interned key */
+    MAX_INTERN_VAL =	16      /* ditto for a string value */
 };
 
 enum {
@@ -35,7 +43,7 @@ enum {
       encoding form (as surrogate pairs) and do not directly represent
       characters.
     */
-    UTF8_SURR_MIN =	0xedad80, /* 0xd800 as 3-byte UTF-8 sequence */
+    UTF8_SURR_MIN =	0xeda080, /* 0xd800 as 3-byte UTF-8 sequence */
     UTF8_SURR_MAX =	0xedbfbf,  /* ditto for 0xdfff */
 
     /*
@@ -60,6 +68,17 @@ enum {
 };
 
 /*  types */
+struct stage {
+    uint8_t *w;
+    uint8_t buf[STAGE_SIZE];
+};
+
+struct span {
+    struct uni_json_p_binding *binds;
+    uint8_t *s, *w;             /* start and end of the string data */
+    void *str;                  /* string if data had to be copied */
+};
+
 struct utf8_seq {
     unsigned ovmask0, ovmask1; /* bitmasks for detecting overlong encodings */
 };
@@ -110,7 +129,7 @@ static inline int no_val_byte(unsigned c)
     return (c & 0xc0) != 0x80;
 }
 
-static uint8_t *skip_utf8(uint8_t *p, uint8_t *e)
+uint8_t *skip_utf8(uint8_t *p, uint8_t *e)
 {
     /*
       Validate and consume an UTF-8 sequence.
@@ -222,32 +241,101 @@ static inline unsigned from_hex(unsigned c)
     return -1;
 }
 
-static uint32_t parse_4dg_hex(uint8_t *p, uint8_t *e)
+static inline uint32_t hex4(uint8_t *p)
 {
-#define un1 (unsigned)-1
+    /*
+      Convert 4 hex digits at p at once, with each digit in one
+      byte of a 32-bit word. Returns (uint32_t)-1 if one of them
+      isn't a hex digit.
 
+      A byte b < 0x80 is >= lo if b + (0x80 - lo) has the high bit
+      set and <= hi if b + (0x7f - hi) hasn't. As both sums are
+      < 0x100, there are no carries between bytes.
+    */
+    uint32_t w, lw, dgs, lts, nibs;
+
+    w = p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+    if (w & 0x80808080) return -1;
+
+    lw = w | 0x20202020;        /* ASCII 'tolower' */
+    dgs = (w + 0x50505050) & ~(w + 0x46464646) & 0x80808080;
+    lts = (lw + 0x1f1f1f1f) & ~(lw + 0x19191919) & 0x80808080;
+    if ((dgs | lts) != 0x80808080) return -1;
+
+    /*  '0' - '9' & 0xf are 0 - 9, 'a' - 'f' & 0xf 1 - 6 */
+    nibs = (w & 0x0f0f0f0f) + (lts >> 7) * 9;
+    return (nibs & 0xff) << 12 | (nibs >> 8 & 0xff) << 8 | (nibs >> 16 & 0xff) << 4
+        | nibs >> 24;
+}
+
+static uint32_t parse_4dg_hex(struct pstate *pstate, uint8_t *p)
+{
+    /*
+      Parse 4 hex digits starting at p. Returns their value or
+      (uint32_t)-1 after setting an error state if there weren't
+      4 hex digits.
+    */
+    uint8_t *e;
     uint32_t x;
-    unsigned dg;
+    unsigned dg, n;
 
-    if (e - p < 4) return -1;
+    /*  the digits are only looked at individually to find errors */
+    e = pstate->e;
+    if (e - p >= 4) {
+        x = hex4(p);
+        if (x != (uint32_t)-1) return x;
+    }
 
-    dg = from_hex(*p++);
-    if (dg == un1) return -1;
-    x = dg << 12;
+    x = 0;
+    n = 4;
+    do {
+        if (p == e) {
+            pstate->err.code = UJ_E_EOS;
+            pstate->err.pos = p;
+            return -1;
+        }
 
-    dg = from_hex(*p++);
-    if (dg == un1) return -1;
-    x |= dg << 8;
+        dg = from_hex(*p);
+        if (dg == (unsigned)-1) {
+            pstate->err.code = UJ_E_INV_ESC;
+            pstate->err.pos = p;
+            return -1;
+        }
 
-    dg = from_hex(*p++);
-    if (dg == un1) return -1;
-    x |= dg << 4;
+        x = (x << 4) | dg;
+        ++p;
+    } while (--n);
 
-    dg = from_hex(*p);
-    if (dg == un1) return -1;
-    return x | dg;
+    return x;
+}
 
-#undef un1
+static int skip_u(struct pstate *pstate, uint8_t *p)
+{
+    /*
+      Check for the \u starting the second half of a surrogate
+      pair at p. Returns 0 if it was found, otherwise, -1 after
+      setting an error state.
+    */
+    uint8_t *want;
+
+    want = "\\u";
+    do {
+        if (p == pstate->e) {
+            pstate->err.code = UJ_E_EOS;
+            pstate->err.pos = p;
+            return -1;
+        }
+
+        if (*p != *want) {
+            pstate->err.code = UJ_E_INV_ESC;
+            pstate->err.pos = p;
+            return -1;
+        }
+
+        ++p;
+    } while (*++want);
+
+    return 0;
 }
 
 static uint32_t parse_u_esc(struct pstate *pstate)
@@ -257,15 +345,16 @@ static uint32_t parse_u_esc(struct pstate *pstate)
       with codepoints above 0xffff encoded as two \u sequences
       representing the corresponding UTF-16 surrogate pair.
 
-      Returns the encoded codepoint or (uint32_t)-1 on error.
+      Returns the encoded codepoint or (uint32_t)-1 after setting
+      an error state. The error code is UJ_E_EOS if the sequence was
+      incomplete because the data ended.
     */
     uint32_t v0, v1;
-    uint8_t *p, *e;
+    uint8_t *p;
 
     p = pstate->p;
-    e = pstate->e;
 
-    v0 = parse_4dg_hex(p, e);
+    v0 = parse_4dg_hex(pstate, p);
     if (v0 == (uint32_t)-1) return -1;
 
     /*
@@ -291,15 +380,15 @@ static uint32_t parse_u_esc(struct pstate *pstate)
       0x1000 + ((a & 0x3ff) << 10 | (b & 0x3ff))
     */
     if (v0 >= SURR_FROM && v0 <= SURR_TO) {
-        if (v0 >= SURR_LO) return -1;
+        if (v0 >= SURR_LO) goto inv;
 
         p += 4;
-        if (e - p < 2 || *p++ != '\\' || *p++ != 'u')
-            return -1;
+        if (skip_u(pstate, p) == -1) return -1;
+        p += 2;
 
-        v1 = parse_4dg_hex(p, e);
-        if (v1 == (uint32_t)-1
-            || v1 < SURR_LO || v1 > SURR_TO) return -1;
+        v1 = parse_4dg_hex(pstate, p);
+        if (v1 == (uint32_t)-1) return -1;
+        if (v1 < SURR_LO || v1 > SURR_TO) goto inv;
         v0 &= 0x3ff;
         v0 = (v0 << 10) | (v1 & 0x3ff);
         v0 += 0x10000;
@@ -307,12 +396,17 @@ static uint32_t parse_u_esc(struct pstate *pstate)
 
     pstate->p = p + 4;
     return v0;
+
+inv:
+    pstate->err.code = UJ_E_INV_ESC;
+    pstate->err.pos = p;
+    return -1;
 }
 
 static inline unsigned utf8_seq_len(uint32_t c)
 {
-    if (c < 0x100) return 1;
-    if (c < 0x1000) return 2;
+    if (c < 0x80) return 1;
+    if (c < 0x800) return 2;
     if (c < 0x10000) return 3;
     return 4;
 }
@@ -352,21 +446,25 @@ static unsigned utf8_encode(uint32_t c, uint8_t *utf)
     return len;
 }
 
-static int parse_esc(struct pstate *pstate, struct uni_json_p_binding *binds,
-                     void *str)
+static int decode_esc(struct pstate *pstate, uint8_t *utf)
 {
     /*
-      Consume an escape sequence. The escaped codepoint is added to the
-      string passed as str as UTF-8.
-
-      Returns 0 on success. Returns -1 and set an error state in case
-      of an error.
+      Consume an escape sequence and store the escaped codepoint
+      as UTF-8 at utf (4 bytes). pstate->ascii is cleared if it's
+      not an ASCII character.
+
+      Returns the length of the UTF-8 sequence. Returns -1 and
+      sets an error state in case of an error. The error code is
+      UJ_E_EOS if the data ended before the escape sequence was
+      complete.
     */
     uint32_t chr;
-    uint8_t utf[4];
-    int rc;
 
-    if (pstate->p == pstate->e) return -1;
+    if (pstate->p == pstate->e) {
+        pstate->err.code = UJ_E_EOS;
+        pstate->err.pos = pstate->p;
+        return -1;
+    }
 
     chr = escs[*pstate->p++];
     switch (chr) {
@@ -388,7 +486,25 @@ static int parse_esc(struct pstate *pstate, struct uni_json_p_binding *binds,
         return -1;
     }
 
-    rc = utf8_encode(chr, utf);
+    if (chr >= 0x80) pstate->ascii = 0;
+    return utf8_encode(chr, utf);
+}
+
+int parse_esc(struct pstate *pstate, struct uni_json_p_binding *binds,
+              void *str)
+{
+    /*
+      Consume an escape sequence and add the escaped codepoint to
+      the string passed as str.
+
+      Returns 0 on success and -1 after an error as decode_esc.
+    */
+    uint8_t utf[4];
+    int rc;
+
+    rc = decode_esc(pstate, utf);
+    if (rc == -1) return -1;
+
     rc = binds->add_2_string(utf, rc, str);
     if (!rc) {
         pstate->err.code = UJ_E_ADD;
@@ -400,32 +516,104 @@ static int parse_esc(struct pstate *pstate, struct uni_json_p_binding *binds,
 }
 
 /**  string handling proper */
-static int parse_string_content(struct pstate *pstate, struct uni_json_p_binding *binds,
-                                void *str)
+static int add_text(struct pstate *pstate, struct uni_json_p_binding *binds, void *str,
+                    uint8_t *data, size_t len)
 {
-    uint8_t *p, *pp, *e, *s;
+    int rc;
+
+    rc = binds->add_2_string(data, len, str);
+    if (!rc) {
+        pstate->err.code = UJ_E_ADD;
+        pstate->err.pos = pstate->p;
+        return -1;
+    }
+
+    return 0;
+}
+
+static int flush_stage(struct pstate *pstate, struct uni_json_p_binding *binds, void *str,
+                       struct stage *st)
+{
+    uint8_t *w;
+
+    w = st->w;
+    if (w == st->buf) return 0;
+
+    st->w = st->buf;
+    return add_text(pstate, binds, str, st->buf, w - st->buf);
+}
+
+static int stage_text(struct pstate *pstate, struct uni_json_p_binding *binds, void *str,
+                      struct stage *st, uint8_t *s, uint8_t *p)
+{
+    /*
+      Append the text from s to p to the stage, flushing it first
+      if the text doesn't fit. Text which doesn't fit into an
+      empty stage is passed on directly.
+    */
+    size_t len;
+
+    len = p - s;
+    if (len > (size_t)(st->buf + STAGE_SIZE - st->w)) {
+        if (flush_stage(pstate, binds, str, st) == -1) return -1;
+        if (len > STAGE_SIZE) return add_text(pstate, binds, str, s, len);
+    }
+
+    memcpy(st->w, s, len);
+    st->w += len;
+    return 0;
+}
+
+int parse_string_content(struct pstate *pstate, struct uni_json_p_binding *binds,
+                         void *str)
+{
+    /*
+      Parse the string content at the current position, passing
+      it to binds->add_2_string in chunks. pstate->ascii tells
+      whether the string had only ASCII characters afterwards.
+
+      Strings without escapes are passed on as a single chunk of
+      the input. Otherwise, the decoded text is collected in a
+      local buffer which is passed on when it's full and at the
+      end of the string. Chunks are thus only valid during the
+      add_2_string call.
+    */
+    struct stage st;
+    uint8_t *p, *pp, *e, *s, *bad;
     unsigned c;
     int rc;
 
     s = p = pstate->p;
     e = pstate->e;
+    bad = p;
+    st.w = st.buf;
+    pstate->ascii = 1;
 
-    while (p < e && (c = *p, c != '"')) {
+    /*
+      Plain characters are skipped in blocks by skip_plain. Only
+      the (comparatively rare) bytes it stops at need to be looked
+      at individually.
+    */
+    while (p = skip_plain(p, e), p < e && (c = *p, c != '"')) {
         if (c == '\\') {
-            if (p > s) {
-                rc = binds->add_2_string(s, p - s, str);
-                if (!rc) {
-                    pstate->err.code = UJ_E_ADD;
-                    pstate->err.pos = p;
+            pstate->p = p;
+            if (p > s && stage_text(pstate, binds, str, &st, s, p) == -1) return -1;
+
+            /*  runs of escapes are decoded in one go */
+            do {
+                if (st.buf + STAGE_SIZE - st.w < MAX_UTF8_LEN
+                    && flush_stage(pstate, binds, str, &st) == -1)
                     return -1;
-                }
-            }
 
-            pstate->p = p + 1;
-            rc = parse_esc(pstate, binds, str);
-            if (rc == -1) return -1;
+                pstate->p = p + 1;
+                rc = decode_esc(pstate, st.w);
+                if (rc == -1) return -1;
 
-            s = p = pstate->p;
+                st.w += rc;
+                p = pstate->p;
+            } while (p < e && *p == '\\');
+
+            s = p;
             continue;
         }
 
@@ -435,17 +623,33 @@ static int parse_string_content(struct pstate *pstate, struct uni_json_p_binding
             return -1;
         }
 
-        if (c & 0x80) {
-            pp = skip_utf8(p, e);
-            if (!pp) {
-                pstate->err.code = UJ_E_INV_UTF8;
-                pstate->err.pos = p;
-                return -1;
+        pstate->ascii = 0;
+
+        /*
+          Non-ASCII text is validated up to the next char which isn't
+          allowed in a string unescaped in one go. Only if this fails,
+          the offending sequence is located by validating each
+          individual sequence in this part of the string with
+          skip_utf8.
+        */
+        if (p >= bad) {
+            pp = skip_no_esc(p, e);
+            if (valid_utf8(p, pp)) {
+                p = pp;
+                continue;
             }
 
-            p = pp;
-        } else
-            ++p;
+            bad = pp;
+        }
+
+        pp = skip_utf8(p, e);
+        if (!pp) {
+            pstate->err.code = UJ_E_INV_UTF8;
+            pstate->err.pos = p;
+            return -1;
+        }
+
+        p = pp;
     }
 
     if (p == e) {
@@ -454,17 +658,304 @@ static int parse_string_content(struct pstate *pstate, struct uni_json_p_binding
         return -1;
     }
 
-    if (p > s) {
-        rc = binds->add_2_string(s, p - s, str);
-        if (!rc) {
-            pstate->err.code = UJ_E_ADD;
-            pstate->err.pos = p;
-            return -1;
+    pstate->p = p;
+    if (st.w > st.buf) {
+        if (p > s && stage_text(pstate, binds, str, &st, s, p) == -1) return -1;
+        if (flush_stage(pstate, binds, str, &st) == -1) return -1;
+    } else if (p > s && add_text(pstate, binds, str, s, p - s) == -1)
+        return -1;
+
+    pstate->p = p + 1;
+    return 0;
+}
+
+/**  raw keys */
+uint32_t uni_json_key_hash(uint8_t *data, size_t len, uint64_t seed)
+{
+    /*
+      Seeded hash for object keys. Processes 8 bytes at a time like
+      intern_hash but mixes more thoroughly, so that every bit of
+      the result depends on the seed and on every input bit.
+    */
+    uint64_t h, w;
+
+    h = seed ^ (len * 0x9e3779b97f4a7c15);
+    while (len >= 8) {
+        memcpy(&w, data, 8);
+        h = (h ^ w) * 0xff51afd7ed558ccd;
+        h ^= h >> 29;
+
+        data += 8;
+        len -= 8;
+    }
+
+    if (len) {
+        w = 0;
+        memcpy(&w, data, len);
+        h = (h ^ w) * 0xff51afd7ed558ccd;
+        h ^= h >> 29;
+    }
+
+    /*  murmur3 finalizer */
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53;
+    h ^= h >> 33;
+
+    return h;
+}
+
+static int add_2_raw_key(uint8_t *data, size_t len, void *p)
+{
+    /*
+      add_2_string routine used by parse_raw_key. Keys are passed
+      on where they are in the input, hence, only the text before
+      the first escape can be used.
+    */
+    struct raw_key *rk;
+
+    rk = p;
+    if (data != rk->data) {
+        rk->esc = 1;
+        return 0;
+    }
+
+    rk->len = len;
+    return 1;
+}
+
+static struct uni_json_p_binding raw_key_binds = {
+    .add_2_string =	add_2_raw_key
+};
+
+int parse_raw_key(struct pstate *pstate, struct uni_json_p_binding *binds,
+                  struct raw_key *rk)
+{
+    /*
+      Parse the key string at the current position into rk and
+      hash it.
+
+      Returns 1 on success. Returns 0 without changing the position
+      if the key contains escapes, -1 with an error state
+      otherwise.
+    */
+    uint8_t *start;
+    int rc;
+
+    start = pstate->p;
+    pstate->p = rk->data = start + 1;
+    rk->len = 0;
+    rk->esc = 0;
+
+    rc = parse_string_content(pstate, &raw_key_binds, rk);
+    if (rc == -1) {
+        if (!rk->esc) return -1;
+
+        pstate->p = start;
+        return 0;
+    }
+
+    rk->hash = binds->hash_key ? binds->hash_key(rk->data, rk->len)
+        : uni_json_key_hash(rk->data, rk->len, binds->key_hash_seed);
+
+    pstate->last_type = UJ_T_STR;
+    return 1;
+}
+
+/**  interning */
+static uint32_t intern_hash(uint8_t *p, size_t len)
+{
+    /*
+      Simple multiplicative hash processing 8 bytes at a
+      time. Only used for short strings.
+    */
+    uint64_t h, w;
+
+    h = len;
+    while (len >= 8) {
+        memcpy(&w, p, 8);
+        h = (h ^ w) * 0x9e3779b97f4a7c15;
+
+        p += 8;
+        len -= 8;
+    }
+
+    if (len) {
+        w = 0;
+        memcpy(&w, p, len);
+        h = (h ^ w) * 0x9e3779b97f4a7c15;
+    }
+
+    return h >> 32;
+}
+
+void reuse_intern(struct pstate *pstate, struct uni_json_p_binding *binds,
+                  struct intern_slot *slots)
+{
+    /*
+      Enable interning for a parse if the bindings ask for it,
+      using slots (N_INTERN entries) as intern table. The table
+      must be empty, ie, either cleared or left behind by
+      end_intern.
+    */
+    pstate->key = 0;
+    pstate->intern = NULL;
+
+    if (!binds->make_string_span || !binds->dup_string) return;
+    if (!(binds->span_flags & (UJ_SPAN_INTERN_KEYS | UJ_SPAN_INTERN_VALUES))) return;
+
+    pstate->intern = slots;
+}
+
+void start_intern(struct pstate *pstate, struct uni_json_p_binding *binds,
+                  struct intern_slot *slots)
+{
+    /*  same as reuse_intern for an uninitialized table */
+    reuse_intern(pstate, binds, slots);
+    if (pstate->intern) memset(slots, 0, sizeof(*slots) * N_INTERN);
+}
+
+void end_intern(struct pstate *pstate, struct uni_json_p_binding *binds)
+{
+    struct intern_slot *slot, *end;
+
+    slot = pstate->intern;
+    if (!slot) return;
+
+    end = slot + N_INTERN;
+    do {
+        if (slot->str) {
+            binds->free_string(slot->str);
+            slot->str = NULL;
         }
+    } while (++slot < end);
+}
+
+static void *parse_interned(struct pstate *pstate, struct uni_json_p_binding *binds)
+{
+    /*
+      Parse a short, plain ASCII string by looking it up in the
+      intern table. The table is direct-mapped, ie, a string
+      replaces whatever else was stored in its slot.
+
+      Returns NULL without changing the position if the string is
+      not a candidate for interning.
+    */
+    struct intern_slot *slot;
+    uint8_t *s, *p, *e;
+    size_t len, max;
+    uint32_t h;
+    void *str;
+
+    if (pstate->key) {
+        if (!(binds->span_flags & UJ_SPAN_INTERN_KEYS)) return NULL;
+        max = MAX_INTERN_KEY;
+    } else {
+        if (!(binds->span_flags & UJ_SPAN_INTERN_VALUES)) return NULL;
+        max = MAX_INTERN_VAL;
     }
 
+    s = pstate->p;
+    e = pstate->e;
+    if ((size_t)(e - s) > max) e = s + max + 1;
+
+    p = skip_plain(s, e);
+    if (p == e || *p != '"') return NULL;
+
     pstate->p = p + 1;
-    return 0;
+    pstate->last_type = UJ_T_STR;
+
+    len = p - s;
+    h = intern_hash(s, len);
+    slot = pstate->intern + (h & (N_INTERN - 1));
+    if (slot->str && slot->hash == h && slot->len == len && memcmp(slot->data, s, len) == 0)
+        return binds->dup_string(slot->str);
+
+    str = binds->make_string_span(s, len);
+    if (binds->mark_ascii) binds->mark_ascii(str);
+    if (slot->str) binds->free_string(slot->str);
+
+    slot->data = s;
+    slot->len = len;
+    slot->hash = h;
+    slot->str = binds->dup_string(str);
+
+    return str;
+}
+
+/**  string spans */
+static int add_2_span(uint8_t *data, size_t len, void *str)
+{
+    /*
+      add_2_string routine used by parse_string_span. Unless
+      in-situ unescaping was requested, only the first chunk of a
+      string can be passed on as a span. The data is then copied to
+      a string created with make_string instead.
+    */
+    struct uni_json_p_binding *binds;
+    struct span *span;
+
+    span = str;
+    binds = span->binds;
+    if (span->str) return binds->add_2_string(data, len, span->str);
+
+    if (binds->span_flags & UJ_SPAN_IN_SITU) {
+        /*
+          The decoded text is never longer than the text it was
+          decoded from, hence, it's still behind the current
+          position.
+        */
+        if (data != span->w) memmove(span->w, data, len);
+        span->w += len;
+        return 1;
+    }
+
+    if (data == span->s && span->w == span->s) {
+        span->w += len;
+        return 1;
+    }
+
+    span->str = binds->make_string();
+    if (span->w > span->s
+        && !binds->add_2_string(span->s, span->w - span->s, span->str))
+        return 0;
+    return binds->add_2_string(data, len, span->str);
+}
+
+static struct uni_json_p_binding span_binds = {
+    .add_2_string =	add_2_span
+};
+
+static void *parse_string_span(struct pstate *pstate, struct uni_json_p_binding *binds)
+{
+    /*
+      Parse a string which is passed to the binding as a single
+      span if possible.
+    */
+    struct span span;
+    void *str;
+    int rc;
+
+    ++pstate->p;
+
+    if (pstate->intern) {
+        str = parse_interned(pstate, binds);
+        if (str) return str;
+    }
+
+    span.binds = binds;
+    span.s = span.w = pstate->p;
+    span.str = NULL;
+
+    rc = parse_string_content(pstate, &span_binds, &span);
+    if (rc == -1) {
+        if (span.str) binds->free_string(span.str);
+        return NULL;
+    }
+
+    pstate->last_type = UJ_T_STR;
+    str = span.str ? span.str : binds->make_string_span(span.s, span.w - span.s);
+    if (pstate->ascii && binds->mark_ascii) binds->mark_ascii(str);
+    return str;
 }
 
 void *parse_string(struct pstate *pstate, struct uni_json_p_binding *binds)
@@ -472,6 +963,8 @@ void *parse_string(struct pstate *pstate, struct uni_json_p_binding *binds)
     void *str;
     int rc;
 
+    if (binds->make_string_span) return parse_string_span(pstate, binds);
+
     str = binds->make_string();
 
     ++pstate->p;
@@ -481,6 +974,7 @@ void *parse_string(struct pstate *pstate, struct uni_json_p_binding *binds)
         return NULL;
     }
 
+    if (pstate->ascii && binds->mark_ascii) binds->mark_ascii(str);
     pstate->last_type = UJ_T_STR;
     return str;
 }
@@ -0,0 +1,736 @@
+/*
+  block-wise scanning of string data
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+*/
+
+/*  includes */
+#include <string.h>
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#endif
+
+#include "scan.h"
+
+/*  constants */
+enum {
+    MIN_LEGAL =		32              /* minimum char code which may appear unescaped in a string */
+};
+
+#define ONES	0x0101010101010101ULL
+#define HIGHS	0x8080808080808080ULL
+
+/*  types */
+struct utf8_range {
+    uint8_t len;                /* sequence length */
+    uint8_t lo, hi;             /* range of valid 2nd bytes */
+};
+
+/*  prototypes */
+static uint8_t *skip_plain_swar(uint8_t *, uint8_t *);
+static uint8_t *skip_no_esc_swar(uint8_t *, uint8_t *);
+static int valid_utf8_ranges(uint8_t *, uint8_t *);
+static void classify_block_bytes(uint8_t *, struct block_masks *);
+
+/*  variables */
+/*
+  The function pointers below point to the fastest variant of some
+  scanning routine supported by the CPU the code is running on. They're
+  initialized to portable variants so that they're always usable and
+  switched to vectorized ones (if any) when the library is loaded.
+*/
+uint8_t *(*skip_plain)(uint8_t *, uint8_t *) = skip_plain_swar;
+uint8_t *(*skip_no_esc)(uint8_t *, uint8_t *) = skip_no_esc_swar;
+int (*valid_utf8)(uint8_t *, uint8_t *) = valid_utf8_ranges;
+void (*classify_block)(uint8_t *, struct block_masks *) = classify_block_bytes;
+
+/*
+  RFC3629
+  -------
+   Code Points        First Byte Second Byte Third Byte Fourth Byte
+   U+0080..U+07FF     C2..DF     80..BF
+   U+0800..U+0FFF     E0         A0..BF      80..BF
+   U+1000..U+CFFF     E1..EC     80..BF      80..BF
+   U+D000..U+D7FF     ED         80..9F      80..BF
+   U+E000..U+FFFF     EE..EF     80..BF      80..BF
+   U+10000..U+3FFFF   F0         90..BF      80..BF     80..BF
+   U+40000..U+FFFFF   F1..F3     80..BF      80..BF     80..BF
+   U+100000..U+10FFFF F4         80..8F      80..BF     80..BF
+
+  Bytes not mentioned in the first column cannot start a sequence
+  and have a length of 0 in the table below.
+*/
+static struct utf8_range utf8_ranges[256] = {
+#define r_(l, f, t) { .len = l, .lo = f, .hi = t }
+
+    [0xc2 ... 0xdf] =	r_(2, 0x80, 0xbf),
+    [0xe0] =		r_(3, 0xa0, 0xbf),
+    [0xe1 ... 0xec] =	r_(3, 0x80, 0xbf),
+    [0xed] =		r_(3, 0x80, 0x9f),
+    [0xee ... 0xef] =	r_(3, 0x80, 0xbf),
+    [0xf0] =		r_(4, 0x90, 0xbf),
+    [0xf1 ... 0xf3] =	r_(4, 0x80, 0xbf),
+    [0xf4] =		r_(4, 0x80, 0x8f)
+
+#undef r_
+};
+
+/*  routines */
+/**  portable */
+static inline int plain(unsigned c)
+{
+    return c >= MIN_LEGAL && c < 128 && c != '"' && c != '\\';
+}
+
+static inline int no_esc(unsigned c)
+{
+    return c >= MIN_LEGAL && c != '"' && c != '\\';
+}
+
+static uint8_t *skip_plain_bytes(uint8_t *p, uint8_t *e)
+{
+    while (p < e && plain(*p)) ++p;
+    return p;
+}
+
+static uint8_t *skip_no_esc_bytes(uint8_t *p, uint8_t *e)
+{
+    while (p < e && no_esc(*p)) ++p;
+    return p;
+}
+
+static inline uint64_t has_zero(uint64_t x)
+{
+    return (x - ONES) & ~x & HIGHS;
+}
+
+static inline uint64_t has_special(uint64_t x)
+{
+    return has_zero(x ^ ONES * '"') | has_zero(x ^ ONES * '\\');
+}
+
+static uint8_t *skip_plain_swar(uint8_t *p, uint8_t *e)
+{
+    /*
+      Skip over a run of 'plain' string characters, ie, printable
+      ASCII characters other than " and \. Returns a pointer to the
+      first byte which isn't plain or e.
+
+      Looks at 8 bytes at a time using 64-bit arithmetic. Subtracting
+      32 from each byte of a word without any bytes < 32 or >= 128
+      won't cause a borrow and leaves all high bits clear. Any byte
+      < 32 thus shows up as a set high bit in x - 32 * ONES and any
+      byte >= 128 as set high bit in x itself. Bytes equal to some c
+      are found by looking for zero bytes in x ^ c * ONES.
+
+      The combined expression detects reliably whether there's a
+      non-plain byte in x but not where. The exact position is
+      determined by the bytewise loop.
+    */
+    uint64_t x, hit;
+
+    while (e - p >= 8) {
+        memcpy(&x, p, 8);
+
+        hit = (x - ONES * MIN_LEGAL) | x | has_special(x);
+        if (hit & HIGHS) break;
+
+        p += 8;
+    }
+
+    return skip_plain_bytes(p, e);
+}
+
+static uint8_t *skip_no_esc_swar(uint8_t *p, uint8_t *e)
+{
+    /*
+      Skip over a run of bytes which may appear unescaped in a
+      string, ie, everything except control characters, " and
+      \. Same technique as in skip_plain but bytes >= 128 must not
+      stop the scan. Masking the borrow bits with ~x accomplishes
+      that.
+    */
+    uint64_t x, hit;
+
+    while (e - p >= 8) {
+        memcpy(&x, p, 8);
+
+        hit = ((x - ONES * MIN_LEGAL) & ~x) | has_special(x);
+        if (hit & HIGHS) break;
+
+        p += 8;
+    }
+
+    return skip_no_esc_bytes(p, e);
+}
+
+static void classify_block_bytes(uint8_t *p, struct block_masks *m)
+{
+    /*
+      Classify the BLOCK_LEN bytes starting at p for the tape
+      builder, setting bit n of a mask if byte n belongs to the
+      corresponding class.
+    */
+    uint64_t bit;
+    unsigned i;
+
+    memset(m, 0, sizeof(*m));
+
+    for (i = 0; i < BLOCK_LEN; ++i) {
+        bit = (uint64_t)1 << i;
+
+        switch (p[i]) {
+        case '"':
+            m->quote |= bit;
+            break;
+
+        case '\\':
+            m->bslash |= bit;
+            break;
+
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+            m->ws |= bit;
+            break;
+
+        case '[':
+        case ']':
+        case '{':
+        case '}':
+        case ',':
+        case ':':
+            m->op |= bit;
+        }
+    }
+}
+
+static int valid_utf8_ranges(uint8_t *p, uint8_t *e)
+{
+    /*
+      Check if the bytes from p up to e are a valid UTF-8 string by
+      looking up the allowed length and range of 2nd bytes of each
+      sequence in utf8_ranges. Returns 1 if so, 0 otherwise.
+
+      Runs of ASCII characters are skipped 8 bytes at a time.
+    */
+    struct utf8_range *r;
+    uint64_t x;
+    unsigned c;
+
+    while (p < e) {
+        if (e - p >= 8) {
+            memcpy(&x, p, 8);
+            if (!(x & HIGHS)) {
+                p += 8;
+                continue;
+            }
+        }
+
+        c = *p;
+        if (c < 128) {
+            ++p;
+            continue;
+        }
+
+        r = utf8_ranges + c;
+        if (!r->len || e - p < r->len) return 0;
+        if (p[1] < r->lo || p[1] > r->hi) return 0;
+
+        switch (r->len) {
+        case 4:
+            if ((p[3] & 0xc0) != 0x80) return 0;
+
+        case 3:
+            if ((p[2] & 0xc0) != 0x80) return 0;
+
+            /*  "non-characters" (0xfffe, 0xffff) */
+            if (c == 0xef && p[1] == 0xbf && (p[2] | 1) == 0xbf) return 0;
+        }
+
+        p += r->len;
+    }
+
+    return 1;
+}
+
+#ifdef __x86_64__
+/**  x86 */
+/*
+  The vector variants of skip_plain below all use the same trick for
+  finding bytes < 32 or >= 128 with a single comparison: Compared as
+  signed quantities, all bytes >= 128 are negative and thus also < 32.
+
+  The skip_no_esc variants find bytes < 32 as bytes which are equal to
+  the unsigned minimum of themselves and 31.
+*/
+static uint8_t *skip_plain_sse2(uint8_t *p, uint8_t *e)
+{
+    __m128i quote, bslash, min_legal, v, hit;
+    unsigned m;
+
+    quote = _mm_set1_epi8('"');
+    bslash = _mm_set1_epi8('\\');
+    min_legal = _mm_set1_epi8(MIN_LEGAL);
+
+    while (e - p >= 16) {
+        v = _mm_loadu_si128((__m128i *)p);
+
+        hit = _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, bslash));
+        hit = _mm_or_si128(hit, _mm_cmplt_epi8(v, min_legal));
+        m = _mm_movemask_epi8(hit);
+        if (m) return p + __builtin_ctz(m);
+
+        p += 16;
+    }
+
+    return skip_plain_swar(p, e);
+}
+
+static uint8_t *skip_no_esc_sse2(uint8_t *p, uint8_t *e)
+{
+    __m128i quote, bslash, max_ctrl, v, hit;
+    unsigned m;
+
+    quote = _mm_set1_epi8('"');
+    bslash = _mm_set1_epi8('\\');
+    max_ctrl = _mm_set1_epi8(MIN_LEGAL - 1);
+
+    while (e - p >= 16) {
+        v = _mm_loadu_si128((__m128i *)p);
+
+        hit = _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, bslash));
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi8(_mm_min_epu8(v, max_ctrl), v));
+        m = _mm_movemask_epi8(hit);
+        if (m) return p + __builtin_ctz(m);
+
+        p += 16;
+    }
+
+    return skip_no_esc_swar(p, e);
+}
+
+_target_("avx2")
+static uint8_t *skip_plain_avx2(uint8_t *p, uint8_t *e)
+{
+    __m256i quote, bslash, min_legal, v, hit;
+    uint32_t m;
+
+    quote = _mm256_set1_epi8('"');
+    bslash = _mm256_set1_epi8('\\');
+    min_legal = _mm256_set1_epi8(MIN_LEGAL);
+
+    while (e - p >= 32) {
+        v = _mm256_loadu_si256((__m256i *)p);
+
+        hit = _mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, bslash));
+        hit = _mm256_or_si256(hit, _mm256_cmpgt_epi8(min_legal, v));
+        m = _mm256_movemask_epi8(hit);
+        if (m) return p + __builtin_ctz(m);
+
+        p += 32;
+    }
+
+    return skip_plain_sse2(p, e);
+}
+
+_target_("avx2")
+static uint8_t *skip_no_esc_avx2(uint8_t *p, uint8_t *e)
+{
+    __m256i quote, bslash, max_ctrl, v, hit;
+    uint32_t m;
+
+    quote = _mm256_set1_epi8('"');
+    bslash = _mm256_set1_epi8('\\');
+    max_ctrl = _mm256_set1_epi8(MIN_LEGAL - 1);
+
+    while (e - p >= 32) {
+        v = _mm256_loadu_si256((__m256i *)p);
+
+        hit = _mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, bslash));
+        hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(_mm256_min_epu8(v, max_ctrl), v));
+        m = _mm256_movemask_epi8(hit);
+        if (m) return p + __builtin_ctz(m);
+
+        p += 32;
+    }
+
+    return skip_no_esc_sse2(p, e);
+}
+
+/*
+  Block classification for the tape builder. [ and ] differ from {
+  and } only in bit 5, hence, after setting this bit in all bytes,
+  the four brackets are the bytes equal to { or }.
+*/
+static void classify_block_sse2(uint8_t *p, struct block_masks *m)
+{
+    __m128i quote, bslash, space, tab, lf, cr, lbrace, rbrace, comma, colon, bit5;
+    __m128i v, ws, op, br;
+    uint64_t mq, mb, mw, mo;
+    unsigned i;
+
+    quote = _mm_set1_epi8('"');
+    bslash = _mm_set1_epi8('\\');
+    space = _mm_set1_epi8(' ');
+    tab = _mm_set1_epi8('\t');
+    lf = _mm_set1_epi8('\n');
+    cr = _mm_set1_epi8('\r');
+    lbrace = _mm_set1_epi8('{');
+    rbrace = _mm_set1_epi8('}');
+    comma = _mm_set1_epi8(',');
+    colon = _mm_set1_epi8(':');
+    bit5 = _mm_set1_epi8(0x20);
+
+    mq = mb = mw = mo = 0;
+    for (i = 0; i < BLOCK_LEN; i += 16) {
+        v = _mm_loadu_si128((__m128i *)(p + i));
+
+        ws = _mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, tab));
+        ws = _mm_or_si128(ws, _mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, cr)));
+
+        op = _mm_or_si128(_mm_cmpeq_epi8(v, comma), _mm_cmpeq_epi8(v, colon));
+        br = _mm_or_si128(v, bit5);
+        op = _mm_or_si128(op, _mm_or_si128(_mm_cmpeq_epi8(br, lbrace), _mm_cmpeq_epi8(br, rbrace)));
+
+        mq |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, quote)) << i;
+        mb |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, bslash)) << i;
+        mw |= (uint64_t)(uint16_t)_mm_movemask_epi8(ws) << i;
+        mo |= (uint64_t)(uint16_t)_mm_movemask_epi8(op) << i;
+    }
+
+    m->quote = mq;
+    m->bslash = mb;
+    m->ws = mw;
+    m->op = mo;
+}
+
+_target_("avx2")
+static void classify_block_avx2(uint8_t *p, struct block_masks *m)
+{
+    __m256i quote, bslash, space, tab, lf, cr, lbrace, rbrace, comma, colon, bit5;
+    __m256i v, ws, op, br;
+    uint64_t mq, mb, mw, mo;
+    unsigned i;
+
+    quote = _mm256_set1_epi8('"');
+    bslash = _mm256_set1_epi8('\\');
+    space = _mm256_set1_epi8(' ');
+    tab = _mm256_set1_epi8('\t');
+    lf = _mm256_set1_epi8('\n');
+    cr = _mm256_set1_epi8('\r');
+    lbrace = _mm256_set1_epi8('{');
+    rbrace = _mm256_set1_epi8('}');
+    comma = _mm256_set1_epi8(',');
+    colon = _mm256_set1_epi8(':');
+    bit5 = _mm256_set1_epi8(0x20);
+
+    mq = mb = mw = mo = 0;
+    for (i = 0; i < BLOCK_LEN; i += 32) {
+        v = _mm256_loadu_si256((__m256i *)(p + i));
+
+        ws = _mm256_or_si256(_mm256_cmpeq_epi8(v, space), _mm256_cmpeq_epi8(v, tab));
+        ws = _mm256_or_si256(ws, _mm256_or_si256(_mm256_cmpeq_epi8(v, lf),
+                                                 _mm256_cmpeq_epi8(v, cr)));
+
+        op = _mm256_or_si256(_mm256_cmpeq_epi8(v, comma), _mm256_cmpeq_epi8(v, colon));
+        br = _mm256_or_si256(v, bit5);
+        op = _mm256_or_si256(op, _mm256_or_si256(_mm256_cmpeq_epi8(br, lbrace),
+                                                 _mm256_cmpeq_epi8(br, rbrace)));
+
+        mq |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, quote)) << i;
+        mb |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, bslash)) << i;
+        mw |= (uint64_t)(uint32_t)_mm256_movemask_epi8(ws) << i;
+        mo |= (uint64_t)(uint32_t)_mm256_movemask_epi8(op) << i;
+    }
+
+    m->quote = mq;
+    m->bslash = mb;
+    m->ws = mw;
+    m->op = mo;
+}
+
+/*
+  UTF-8 validation 32 bytes at a time based on
+
+  John Keiser, Daniel Lemire, "Validating UTF-8 In Less Than One
+  Instruction Per Byte", Software: Practice and Experience 51 (5), 2021
+
+  Most errors can be detected by looking at the high nibble of a byte
+  and both nibbles of the byte before it. Three table lookups map each
+  of these to a set of error classes it's compatible with and the AND
+  of the three is non-zero if there's an error. Third and fourth
+  bytes of 3- and 4-byte sequences (which look like 'two
+  continuations' to the lookup) are checked by looking 2 and 3 bytes
+  back. The non-characters 0xfffe and 0xffff aren't UTF-8 errors as
+  such and need to be checked separately.
+*/
+enum {
+    TOO_SHORT =		1,      /* 11______ 0_______, 11______ 11______ */
+    TOO_LONG =		2,      /* 0_______ 10______ */
+    OVERLONG_3 =	4,      /* 11100000 100_____ */
+    TOO_LARGE =		8,      /* 11110100 1001____ and larger */
+    SURROGATE =		16,     /* 11101101 101_____ */
+    OVERLONG_2 =	32,     /* 1100000_ 10______ */
+    TOO_LARGE_1000 =	64,     /* 11110101 1000____ and larger */
+    OVERLONG_4 =	64,     /* 11110000 1000____ */
+    TWO_CONTS =		128,    /* 10______ 10______ */
+
+    CARRY =		TOO_SHORT | TOO_LONG | TWO_CONTS
+};
+
+#define prev_n(cur, prev, n)                                            \
+    _mm256_alignr_epi8(cur, _mm256_permute2x128_si256(prev, cur, 0x21), 16 - (n))
+
+_target_("avx2")
+static inline __m256i high_nibbles(__m256i v)
+{
+    return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0f));
+}
+
+_target_("avx2")
+static __m256i utf8_errors(__m256i cur, __m256i prev)
+{
+    __m256i prev1, prev2, prev3, b1_hi, b1_lo, b2_hi, special, must23, nonch;
+
+    prev1 = prev_n(cur, prev, 1);
+
+    b1_hi = _mm256_shuffle_epi8(
+        _mm256_setr_epi8(
+            TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+            TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+            TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+            TOO_SHORT | OVERLONG_2,
+            TOO_SHORT,
+            TOO_SHORT | OVERLONG_3 | SURROGATE,
+            TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4,
+
+            TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+            TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+            TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+            TOO_SHORT | OVERLONG_2,
+            TOO_SHORT,
+            TOO_SHORT | OVERLONG_3 | SURROGATE,
+            TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4),
+        high_nibbles(prev1));
+
+    b1_lo = _mm256_shuffle_epi8(
+        _mm256_setr_epi8(
+            CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+            CARRY | OVERLONG_2,
+            CARRY,
+            CARRY,
+            CARRY | TOO_LARGE,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+
+            CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+            CARRY | OVERLONG_2,
+            CARRY,
+            CARRY,
+            CARRY | TOO_LARGE,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+            CARRY | TOO_LARGE | TOO_LARGE_1000,
+            CARRY | TOO_LARGE | TOO_LARGE_1000),
+        _mm256_and_si256(prev1, _mm256_set1_epi8(0x0f)));
+
+    b2_hi = _mm256_shuffle_epi8(
+        _mm256_setr_epi8(
+            TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+            TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+            TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+
+            TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+            TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+            TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+            TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT),
+        high_nibbles(cur));
+
+    special = _mm256_and_si256(_mm256_and_si256(b1_hi, b1_lo), b2_hi);
+
+    /*
+      A byte must be a 2nd continuation if the byte 2 positions back
+      is >= 0xe0 and a 3rd if the one 3 positions back is >= 0xf0.
+      Saturating subtraction maps these to values with the high bit
+      set. Exactly these bytes must have TWO_CONTS (the high bit) set
+      in special.
+    */
+    prev2 = prev_n(cur, prev, 2);
+    prev3 = prev_n(cur, prev, 3);
+    must23 = _mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8(0xe0 - 0x80)),
+                             _mm256_subs_epu8(prev3, _mm256_set1_epi8(0xf0 - 0x80)));
+    must23 = _mm256_and_si256(must23, _mm256_set1_epi8(0x80));
+
+    /*  "non-characters" (0xfffe, 0xffff) are EF BF BE and EF BF BF */
+    nonch = _mm256_and_si256(_mm256_cmpeq_epi8(prev2, _mm256_set1_epi8(0xef)),
+                             _mm256_cmpeq_epi8(prev1, _mm256_set1_epi8(0xbf)));
+    nonch = _mm256_and_si256(nonch,
+                             _mm256_cmpeq_epi8(_mm256_or_si256(cur, _mm256_set1_epi8(1)),
+                                               _mm256_set1_epi8(0xbf)));
+
+    return _mm256_or_si256(_mm256_xor_si256(must23, special), nonch);
+}
+
+_target_("avx2")
+static inline __m256i incomplete(__m256i v)
+{
+    /*
+      Non-zero if the last three bytes of v start a sequence
+      extending past it.
+    */
+    return _mm256_subs_epu8(v,
+                            _mm256_setr_epi8(
+                                -1, -1, -1, -1, -1, -1, -1, -1,
+                                -1, -1, -1, -1, -1, -1, -1, -1,
+                                -1, -1, -1, -1, -1, -1, -1, -1,
+                                -1, -1, -1, -1, -1,
+                                0xf0 - 1, 0xe0 - 1, 0xc0 - 1));
+}
+
+_target_("avx2")
+static int valid_utf8_avx2(uint8_t *p, uint8_t *e)
+{
+    __m256i cur, prev, errs, prev_inc;
+    uint8_t last[32];
+    size_t left;
+
+    errs = prev = prev_inc = _mm256_setzero_si256();
+
+    do {
+        left = e - p;
+        if (left >= 32)
+            cur = _mm256_loadu_si256((__m256i *)p);
+        else {
+            /*
+              A final partial block is padded with ASCII 0 so that
+              truncated sequences show up as TOO_SHORT.
+            */
+            memset(last, 0, sizeof(last));
+            memcpy(last, p, left);
+            cur = _mm256_loadu_si256((__m256i *)last);
+        }
+
+        if (_mm256_movemask_epi8(cur))
+            errs = _mm256_or_si256(errs, utf8_errors(cur, prev));
+        else
+            errs = _mm256_or_si256(errs, prev_inc);
+
+        prev_inc = incomplete(cur);
+        prev = cur;
+        p += left >= 32 ? 32 : left;
+    } while (p < e);
+
+    errs = _mm256_or_si256(errs, prev_inc);
+    return _mm256_testz_si256(errs, errs);
+}
+
+_target_("avx512bw")
+static uint8_t *skip_plain_avx512(uint8_t *p, uint8_t *e)
+{
+    __m512i quote, bslash, min_legal, v;
+    __mmask64 in, m;
+
+    quote = _mm512_set1_epi8('"');
+    bslash = _mm512_set1_epi8('\\');
+    min_legal = _mm512_set1_epi8(MIN_LEGAL);
+
+    in = ~(__mmask64)0;
+    while (p < e) {
+        /*
+          The final partial block is read with a masked load which
+          doesn't touch memory beyond e. Masked-off bytes are 0 and
+          would match as < 32, hence, the & in.
+        */
+        if (e - p < 64) in = ((__mmask64)1 << (e - p)) - 1;
+        v = _mm512_maskz_loadu_epi8(in, p);
+
+        m = _mm512_cmpeq_epi8_mask(v, quote) | _mm512_cmpeq_epi8_mask(v, bslash)
+            | _mm512_cmplt_epi8_mask(v, min_legal);
+        m &= in;
+        if (m) return p + __builtin_ctzll(m);
+
+        if (in != ~(__mmask64)0) break;
+        p += 64;
+    }
+
+    return e;
+}
+
+_target_("avx512bw")
+static uint8_t *skip_no_esc_avx512(uint8_t *p, uint8_t *e)
+{
+    __m512i quote, bslash, min_legal, v;
+    __mmask64 in, m;
+
+    quote = _mm512_set1_epi8('"');
+    bslash = _mm512_set1_epi8('\\');
+    min_legal = _mm512_set1_epi8(MIN_LEGAL);
+
+    in = ~(__mmask64)0;
+    while (p < e) {
+        if (e - p < 64) in = ((__mmask64)1 << (e - p)) - 1;
+        v = _mm512_maskz_loadu_epi8(in, p);
+
+        m = _mm512_cmpeq_epi8_mask(v, quote) | _mm512_cmpeq_epi8_mask(v, bslash)
+            | _mm512_cmplt_epu8_mask(v, min_legal);
+        m &= in;
+        if (m) return p + __builtin_ctzll(m);
+
+        if (in != ~(__mmask64)0) break;
+        p += 64;
+    }
+
+    return e;
+}
+
+/**  variant selection */
+static _init_ void select_skippers(void)
+{
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512bw")) {
+        skip_plain = skip_plain_avx512;
+        skip_no_esc = skip_no_esc_avx512;
+    } else if (__builtin_cpu_supports("avx2")) {
+        skip_plain = skip_plain_avx2;
+        skip_no_esc = skip_no_esc_avx2;
+    } else {
+        skip_plain = skip_plain_sse2;
+        skip_no_esc = skip_no_esc_sse2;
+    }
+
+    if (__builtin_cpu_supports("avx2")) {
+        valid_utf8 = valid_utf8_avx2;
+        classify_block = classify_block_avx2;
+    } else
+        classify_block = classify_block_sse2;
+}
+#endif
@@ -0,0 +1,462 @@
+/*
+  event parser
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+*/
+
+/*  includes */
+#include <stddef.h>
+#include <string.h>
+
+#include "uni_json_p_binding.h"
+#include "uni_json_p_events.h"
+#include "uni_json_parser.h"
+#include "pstate.h"
+#include "lib.h"
+#include "parser_literals.h"
+#include "parser_number.h"
+#include "parser_string.h"
+
+/*  constants */
+enum {
+    V_OK,                       /* value was found */
+    V_NONE                      /* no value, cf no_value in uni_json_parser.c */
+};
+
+/*  types */
+typedef int chunk_func(uint8_t *, size_t, unsigned, void *);
+
+struct ev_state {
+    struct pstate pstate;
+    struct uni_json_p_events *evs;
+    void *p;
+    int stopped;
+
+    /*
+      String data is passed on with a delay of one chunk so that
+      the last chunk can be flagged as such. Unless escape sequences
+      are involved, this means a string is passed on as a single
+      chunk.
+    */
+    chunk_func *chunk;
+    uint8_t *s;                 /* start of the string in the input */
+    uint8_t *pend;
+    size_t pend_len;
+    uint8_t esc[STAGE_SIZE];
+};
+
+typedef int ev_func(struct ev_state *);
+
+/*  prototypes */
+static int ev_value(struct ev_state *);
+static int ev_whitespace(struct ev_state *);
+static int ev_close_char(struct ev_state *);
+static int ev_false(struct ev_state *);
+static int ev_null(struct ev_state *);
+static int ev_true(struct ev_state *);
+static int ev_number(struct ev_state *);
+static int ev_string(struct ev_state *);
+static int ev_array(struct ev_state *);
+static int ev_object(struct ev_state *);
+
+static int add_chunk(uint8_t *, size_t, void *);
+
+/*  variables */
+static ev_func *ev_map[256] = {
+    /*
+      Same as tok_map in uni_json_parser.c but for the event
+      parsing functions.
+    */
+    ['\t'] =		ev_whitespace,
+    ['\r'] =		ev_whitespace,
+    ['\n'] =		ev_whitespace,
+    [' '] =		ev_whitespace,
+
+    [']'] =		ev_close_char,
+    ['}'] =		ev_close_char,
+
+    ['f'] =		ev_false,
+    ['n'] =		ev_null,
+    ['t'] =		ev_true,
+
+    ['-'] =		ev_number,
+    ['0' ... '9'] =	ev_number,
+
+    ['"'] =		ev_string,
+
+    ['['] =		ev_array,
+    ['{'] =		ev_object
+};
+
+/*
+  The string parser adds data to strings with the add_2_string
+  binding routine. This one passes it on as events.
+*/
+static struct uni_json_p_binding chunk_binds = {
+    .add_2_string =	add_chunk
+};
+
+/*  routines */
+/**  helpers */
+static int emitted(struct ev_state *st, int rc)
+{
+    /*
+      Check the return value of an event routine. Returns 0 if
+      parsing should continue, otherwise, -1 after recording that
+      parsing was stopped.
+    */
+    if (rc) return 0;
+
+    st->stopped = 1;
+    return -1;
+}
+
+static int send_chunk(struct ev_state *st, uint8_t *data, size_t len, unsigned flags)
+{
+    if (!st->chunk) return 0;
+    return emitted(st, st->chunk(data, len, flags, st->p));
+}
+
+static int add_chunk(uint8_t *data, size_t len, void *str)
+{
+    struct ev_state *st;
+
+    st = str;
+    if (st->pend_len && send_chunk(st, st->pend, st->pend_len, 0) == -1)
+        return 0;
+
+    /*
+      Text with escapes is decoded into a local buffer of the
+      caller. Such chunks are copied as they're sent later.
+    */
+    if (data < st->s || data >= st->pstate.e) {
+        memcpy(st->esc, data, len);
+        data = st->esc;
+    }
+
+    st->pend = data;
+    st->pend_len = len;
+    return 1;
+}
+
+static uint8_t *skip_ws(uint8_t *p, uint8_t *e)
+{
+    while (p < e && ev_map[*p] == ev_whitespace) ++p;
+    return p;
+}
+
+/**  simple values */
+static int ev_whitespace(struct ev_state *)
+{
+    /* dummy routine to mark whitespace in ev_map */
+    return -1;
+}
+
+static int ev_close_char(struct ev_state *)
+{
+    return V_NONE;
+}
+
+static int ev_literal(struct ev_state *st, uint8_t *want)
+{
+    struct uni_json_p_events *evs;
+    int rc;
+
+    rc = skip_literal(&st->pstate, want);
+    if (rc == -1) return -1;
+
+    evs = st->evs;
+    switch (*want) {
+    case 'f':
+        rc = evs->boolean ? evs->boolean(0, st->p) : 1;
+        break;
+
+    case 'n':
+        rc = evs->null ? evs->null(st->p) : 1;
+        break;
+
+    case 't':
+        rc = evs->boolean ? evs->boolean(1, st->p) : 1;
+    }
+
+    return emitted(st, rc);
+}
+
+static int ev_false(struct ev_state *st)
+{
+    return ev_literal(st, "false");
+}
+
+static int ev_null(struct ev_state *st)
+{
+    return ev_literal(st, "null");
+}
+
+static int ev_true(struct ev_state *st)
+{
+    return ev_literal(st, "true");
+}
+
+static int ev_number(struct ev_state *st)
+{
+    struct uni_json_p_events *evs;
+    unsigned flags;
+    uint8_t *s;
+    int rc;
+
+    s = st->pstate.p;
+    rc = skip_number(&st->pstate, &flags);
+    if (rc == -1) return -1;
+
+    evs = st->evs;
+    if (!evs->number) return 0;
+    return emitted(st, evs->number(s, st->pstate.p - s, flags, st->p));
+}
+
+static int parse_chunks(struct ev_state *st, chunk_func *chunk)
+{
+    int rc;
+
+    st->chunk = chunk;
+    st->pend_len = 0;
+
+    st->s = ++st->pstate.p;
+    rc = parse_string_content(&st->pstate, &chunk_binds, st);
+    if (rc == -1) return -1;
+
+    return send_chunk(st, st->pend, st->pend_len, UJ_EV_LAST);
+}
+
+static int ev_string(struct ev_state *st)
+{
+    return parse_chunks(st, st->evs->string);
+}
+
+/**  structures */
+static int ev_value(struct ev_state *st)
+{
+    /*
+      Parse a JSON value, skipping leading and trailing
+      whitespace. Returns V_OK if a value was found, V_NONE if not
+      and -1 in case of an error or if parsing was stopped.
+    */
+    ev_func *ev;
+    uint8_t *p, *e;
+    int rc;
+
+    e = st->pstate.e;
+    p = st->pstate.p = skip_ws(st->pstate.p, e);
+    if (p == e) return V_NONE;
+
+    ev = ev_map[*p];
+    if (!ev) {
+        st->pstate.err.code = UJ_E_INV;
+        st->pstate.err.pos = p;
+        return -1;
+    }
+
+    rc = ev(st);
+    if (rc) return rc;
+
+    st->pstate.p = skip_ws(st->pstate.p, e);
+    return V_OK;
+}
+
+static int ev_key(struct ev_state *st, uint8_t *pos)
+{
+    /*
+      Parse a key. As the events for a value have to be generated
+      while parsing it, anything not starting with a " is flagged
+      as invalid key right away.
+    */
+    uint8_t *p, *e;
+    int rc;
+
+    e = st->pstate.e;
+    p = st->pstate.p = skip_ws(st->pstate.p, e);
+    if (p == e) return V_NONE;
+
+    switch (*p) {
+    case '"':
+        rc = parse_chunks(st, st->evs->key);
+        if (rc == -1) return -1;
+
+        st->pstate.p = skip_ws(st->pstate.p, e);
+        return V_OK;
+
+    case ']':
+    case '}':
+        return V_NONE;
+    }
+
+    if (ev_map[*p]) {
+        st->pstate.err.code = UJ_E_INV_KEY;
+        st->pstate.err.pos = pos;
+    } else {
+        st->pstate.err.code = UJ_E_INV;
+        st->pstate.err.pos = p;
+    }
+
+    return -1;
+}
+
+static int enter(struct ev_state *st, int (*start)(void *))
+{
+    struct pstate *pstate;
+
+    pstate = &st->pstate;
+
+    ++pstate->level;
+    if (pstate->level > pstate->max_nesting) {
+        pstate->err.code = UJ_E_TOO_DEEP;
+        pstate->err.pos = pstate->p;
+        return -1;
+    }
+
+    ++pstate->p;
+    return start ? emitted(st, start(st->p)) : 0;
+}
+
+static int leave(struct ev_state *st, int (*end)(void *))
+{
+    --st->pstate.level;
+    return end ? emitted(st, end(st->p)) : 0;
+}
+
+static int ev_array(struct ev_state *st)
+{
+    struct pstate *pstate;
+    int rc;
+
+    pstate = &st->pstate;
+
+    rc = enter(st, st->evs->start_array);
+    if (rc == -1) return -1;
+
+    rc = ev_value(st);
+    if (rc == -1) return -1;
+
+    if (rc == V_NONE) {
+        rc = skip_one_of(pstate, "]");
+        if (rc == -1) return -1;
+    } else
+        do {
+            rc = skip_one_of(pstate, ",]");
+            if (rc == -1) return -1;
+
+            if (rc == ',') {
+                rc = ev_value(st);
+                if (rc == -1) return -1;
+
+                if (rc == V_NONE) {
+                    pstate->err.code = UJ_E_NO_VAL;
+                    pstate->err.pos = pstate->p;
+                    return -1;
+                }
+
+                rc = ',';
+            }
+        } while (rc == ',');
+
+    return leave(st, st->evs->end_array);
+}
+
+static int ev_object(struct ev_state *st)
+{
+    struct pstate *pstate;
+    uint8_t *pos;
+    int c, rc;
+
+    pstate = &st->pstate;
+
+    rc = enter(st, st->evs->start_object);
+    if (rc == -1) return -1;
+
+    pos = pstate->p;
+    rc = ev_key(st, pos);
+    if (rc == -1) return -1;
+
+    if (rc == V_NONE) {
+        c = skip_one_of(pstate, "}");
+        if (c == -1) return -1;
+    } else
+        do {
+            c = skip_one_of(pstate, ":");
+            if (c == -1) return -1;
+
+            rc = ev_value(st);
+            if (rc == -1) return -1;
+
+            if (rc == V_NONE) {
+                pstate->err.code = UJ_E_NO_VAL;
+                pstate->err.pos = pstate->p;
+                return -1;
+            }
+
+            c = skip_one_of(pstate, ",}");
+            if (c == -1) return -1;
+
+            if (c == ',') {
+                pos = pstate->p;
+                rc = ev_key(st, pos);
+                if (rc == -1) return -1;
+
+                if (rc == V_NONE) {
+                    pstate->err.code = UJ_E_NO_KEY;
+                    pstate->err.pos = pstate->p;
+                    return -1;
+                }
+            }
+        } while (c == ',');
+
+    return leave(st, st->evs->end_object);
+}
+
+/**  API */
+int uni_json_parse_events(uint8_t *data, size_t len,
+                          struct uni_json_p_events *evs, void *p)
+{
+    /*
+      Parse a JSON text, generating events instead of creating
+      values.
+
+      Returns 1 if the text was parsed completely, 0 if an event
+      routine stopped parsing and -1 after invoking the error
+      handler in case of an error.
+    */
+    struct ev_state st;
+    struct pstate *pstate;
+    int rc;
+
+    pstate = &st.pstate;
+    pstate->p = data;
+    pstate->e = data + len;
+    pstate->level = 0;
+    pstate->max_nesting = uni_json_max_nesting;
+
+    st.evs = evs;
+    st.p = p;
+    st.stopped = 0;
+
+    rc = ev_value(&st);
+    if (rc == -1) {
+        if (st.stopped) return 0;
+
+        evs->on_error(pstate->err.code, pstate->err.pos - data, p);
+        return -1;
+    }
+
+    if (rc == V_NONE) {
+        evs->on_error(UJ_E_NO_VAL, 0, p);
+        return -1;
+    }
+
+    if (pstate->p != pstate->e) {
+        evs->on_error(UJ_E_GARBAGE, pstate->p - data, p);
+        return -1;
+    }
+
+    return 1;
+}
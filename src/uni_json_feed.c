@@ -0,0 +1,849 @@
+/*
+  push parser for chunked input
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+*/
+
+/*  includes */
+#include <stddef.h>
+#include <string.h>
+
+#include "uni_json_p_binding.h"
+#include "uni_json_parser.h"
+#include "uni_json_types.h"
+#include "pstate.h"
+#include "lib.h"
+#include "scan.h"
+#include "parser_literals.h"
+#include "parser_number.h"
+#include "parser_string.h"
+
+/*  constants */
+enum {
+    S_TOP,                      /* expecting the top-level value */
+    S_DONE,                     /* top-level value complete */
+    S_ARY_FIRST,                /* after [ */
+    S_ARY_VAL,                  /* after , in an array */
+    S_ARY_NEXT,                 /* after a value in an array */
+    S_OBJ_FIRST,                /* after { */
+    S_OBJ_KEY,                  /* after , in an object */
+    S_OBJ_COLON,                /* after a key */
+    S_OBJ_VAL,                  /* after : */
+    S_OBJ_NEXT                  /* after a value in an object */
+};
+
+enum {
+    T_NONE,                     /* between tokens */
+    T_STR,                      /* in a string */
+    T_ESC,                      /* in a carried escape sequence */
+    T_UTF8,                     /* in a carried UTF-8 sequence */
+    T_SCALAR                    /* in a carried number or literal */
+};
+
+enum {
+    C_INV,                      /* can't start a value */
+    C_WS,
+    C_SCALAR,                   /* starts a number or literal */
+    C_STR,
+    C_ARY,
+    C_OBJ,
+    C_CLOSE,
+    C_SEP                       /* , or : */
+};
+
+enum {
+    MIN_LEGAL =		32,     /* minimum char code which may appear unescaped in a string */
+
+    INIT_FRAMES =	16,
+    INIT_CARRY =	32,
+
+    MAX_ESC =		11,     /* uXXXX\uXXXX */
+    MAX_UTF8 =		4
+};
+
+/*  types */
+typedef void *parse_func(struct pstate *, struct uni_json_p_binding *);
+
+struct frame {
+    void *ctr, *key;
+    size_t key_pos;             /* where a key should start (UJ_E_INV_KEY) */
+    int type, state;
+};
+
+struct uni_json_feed {
+    struct uni_json_p_binding *binds;
+    void *err_p;
+    size_t budget;
+
+    /*  position of current chunk in the input */
+    uint8_t *chunk;
+    size_t ofs;
+
+    /*
+      frames[0] is a pseudo-frame for the top-level value, the
+      others are the arrays and objects presently being parsed.
+    */
+    struct frame *frames;
+    unsigned level, n_frames, max_nesting;
+    void *val;
+    int val_type;
+
+    /*  current token */
+    int tok;
+    void *str;
+    int ascii;                  /* str has only ASCII chars so far */
+    parse_func *scalar;
+    size_t tok_pos;
+
+    /*
+      Tokens which need to be parsed as a whole but extend beyond
+      the end of a chunk are accumulated here.
+    */
+    uint8_t *carry;
+    size_t carry_len, carry_size;
+};
+
+/*  variables */
+static uint8_t cls[256] = {
+    ['\t'] =		C_WS,
+    ['\r'] =		C_WS,
+    ['\n'] =		C_WS,
+    [' '] =		C_WS,
+
+    ['f'] =		C_SCALAR,
+    ['n'] =		C_SCALAR,
+    ['t'] =		C_SCALAR,
+    ['-'] =		C_SCALAR,
+    ['0' ... '9'] =	C_SCALAR,
+
+    ['"'] =		C_STR,
+    ['['] =		C_ARY,
+    ['{'] =		C_OBJ,
+
+    [']'] =		C_CLOSE,
+    ['}'] =		C_CLOSE,
+
+    [','] =		C_SEP,
+    [':'] =		C_SEP
+};
+
+static parse_func *scalars[256] = {
+    ['f'] =		parse_false,
+    ['n'] =		parse_null,
+    ['t'] =		parse_true,
+
+    ['-'] =		parse_number,
+    ['0' ... '9'] =	parse_number
+};
+
+/*  routines */
+/**  helpers */
+static inline size_t pos_of(struct uni_json_feed *feed, uint8_t *p)
+{
+    return feed->ofs + (p - feed->chunk);
+}
+
+static inline int in_scalar(unsigned c)
+{
+    /*
+      Numbers and literals are considered to extend up to the
+      next char which could legitimately follow them. Everything
+      in between is passed to the parse function which will stop
+      where the actual number or literal ends.
+    */
+    return cls[c] == C_INV || cls[c] == C_SCALAR;
+}
+
+static void release(struct uni_json_feed *feed)
+{
+    struct uni_json_p_binding *binds;
+    struct frame *f;
+
+    binds = feed->binds;
+    if (feed->str) binds->free_string(feed->str);
+
+    f = feed->frames + feed->level;
+    while (f > feed->frames) {
+        if (f->key) binds->free_string(f->key);
+        free_obj(f->type, f->ctr, binds);
+
+        --f;
+    }
+
+    if (feed->val) free_obj(feed->val_type, feed->val, binds);
+
+    if (feed->carry) binds->dealloc(feed->carry);
+    binds->dealloc(feed->frames);
+    binds->dealloc(feed);
+}
+
+static int fail(struct uni_json_feed *feed, unsigned code, size_t pos)
+{
+    /*
+      Abort parsing because of an error. All memory is released
+      before the error handler is invoked.
+    */
+    void (*on_error)(unsigned, size_t, void *);
+    void *err_p;
+
+    on_error = feed->binds->on_error;
+    err_p = feed->err_p;
+    release(feed);
+
+    on_error(code, pos, err_p);
+    return -1;
+}
+
+static void *grow(struct uni_json_p_binding *binds, void *old, size_t used, size_t size)
+{
+    void *new;
+
+    new = binds->alloc(size);
+    if (!new) return NULL;
+
+    if (old) {
+        memcpy(new, old, used);
+        binds->dealloc(old);
+    }
+
+    return new;
+}
+
+static int carry_add(struct uni_json_feed *feed, uint8_t *p, size_t len)
+{
+    uint8_t *carry;
+    size_t size;
+
+    if (!len) return 0;
+
+    size = feed->carry_size;
+    if (feed->carry_len + len > size) {
+        if (!size) size = INIT_CARRY;
+        while (size < feed->carry_len + len) size *= 2;
+
+        carry = grow(feed->binds, feed->carry, feed->carry_len, size);
+        if (!carry) return fail(feed, UJ_E_NO_MEM, pos_of(feed, p));
+
+        feed->carry = carry;
+        feed->carry_size = size;
+    }
+
+    memcpy(feed->carry + feed->carry_len, p, len);
+    feed->carry_len += len;
+    return 0;
+}
+
+/**  values */
+static int value_done(struct uni_json_feed *feed, void *v, int type, size_t pos)
+{
+    /*
+      Store a completed value as required by the state of the
+      innermost frame.
+    */
+    struct uni_json_p_binding *binds;
+    struct frame *f;
+    int rc;
+
+    binds = feed->binds;
+    f = feed->frames + feed->level;
+
+    switch (f->state) {
+    case S_TOP:
+        feed->val = v;
+        feed->val_type = type;
+        f->state = S_DONE;
+        break;
+
+    case S_ARY_FIRST:
+    case S_ARY_VAL:
+        rc = binds->add_2_array(v, f->ctr);
+        if (!rc) {
+            free_obj(type, v, binds);
+            return fail(feed, UJ_E_ADD, pos);
+        }
+
+        f->state = S_ARY_NEXT;
+        break;
+
+    case S_OBJ_FIRST:
+    case S_OBJ_KEY:
+        if (type != UJ_T_STR) {
+            free_obj(type, v, binds);
+            return fail(feed, UJ_E_INV_KEY, f->key_pos);
+        }
+
+        f->key = v;
+        f->state = S_OBJ_COLON;
+        break;
+
+    case S_OBJ_VAL:
+        rc = binds->add_2_object(f->key, v, f->ctr);
+        if (!rc) {
+            free_obj(type, v, binds);
+            return fail(feed, UJ_E_ADD, pos);
+        }
+
+        f->key = NULL;
+        f->state = S_OBJ_NEXT;
+    }
+
+    return 0;
+}
+
+static int junk(struct uni_json_feed *feed, size_t pos)
+{
+    /* a char which can't follow a value */
+    if (feed->frames[feed->level].state == S_DONE)
+        return fail(feed, UJ_E_GARBAGE, pos);
+    return fail(feed, UJ_E_INV_IN, pos);
+}
+
+/**  containers */
+static int open_ctr(struct uni_json_feed *feed, int type, uint8_t **pp)
+{
+    struct uni_json_p_binding *binds;
+    struct frame *f;
+    uint8_t *p;
+    unsigned n;
+
+    binds = feed->binds;
+    p = *pp;
+
+    if (feed->level + 1 > feed->max_nesting)
+        return fail(feed, UJ_E_TOO_DEEP, pos_of(feed, p));
+
+    if (feed->level + 1 == feed->n_frames) {
+        n = feed->n_frames * 2;
+        f = grow(binds, feed->frames, sizeof(*f) * feed->n_frames, sizeof(*f) * n);
+        if (!f) return fail(feed, UJ_E_NO_MEM, pos_of(feed, p));
+
+        feed->frames = f;
+        feed->n_frames = n;
+    }
+
+    f = feed->frames + ++feed->level;
+    f->type = type;
+    f->key = NULL;
+    f->key_pos = pos_of(feed, p + 1);
+
+    if (type == UJ_T_ARY) {
+        f->ctr = binds->make_array();
+        f->state = S_ARY_FIRST;
+    } else {
+        f->ctr = binds->make_object();
+        f->state = S_OBJ_FIRST;
+    }
+
+    *pp = p + 1;
+    return 0;
+}
+
+static int close_ctr(struct uni_json_feed *feed, uint8_t **pp)
+{
+    struct frame *f;
+    uint8_t *p;
+
+    p = *pp;
+    f = feed->frames + feed->level--;
+
+    *pp = p + 1;
+    return value_done(feed, f->ctr, f->type, pos_of(feed, p + 1));
+}
+
+/**  numbers and literals */
+static int scalar_done(struct uni_json_feed *feed, uint8_t *s, uint8_t *r, uint8_t *e)
+{
+    /*
+      Parse a complete number or literal which started at input
+      position tok_pos.
+
+      s		start of the token
+      r		end of the run of chars which might belong to it
+      e		end of data, either r or r + 1 if the char terminating
+		the run is available, so that errors are detected at
+		the same positions as by uni_json_parse
+    */
+    struct pstate pstate;
+    size_t pos;
+    void *v;
+    int rc;
+
+    feed->tok = T_NONE;
+    feed->carry_len = 0;
+    pos = feed->tok_pos;
+
+    pstate.p = s;
+    pstate.e = e;
+    v = feed->scalar(&pstate, feed->binds);
+    if (!v) return fail(feed, pstate.err.code, pos + (pstate.err.pos - s));
+
+    rc = value_done(feed, v, pstate.last_type, pos + (pstate.p - s));
+    if (rc == -1) return -1;
+
+    if (pstate.p < r) return junk(feed, pos + (pstate.p - s));
+    return 0;
+}
+
+static int scalar(struct uni_json_feed *feed, uint8_t **pp, uint8_t *e)
+{
+    uint8_t *s, *p;
+
+    s = p = *pp;
+    do ++p; while (p < e && in_scalar(*p));
+    *pp = p;
+
+    if (p == e) {
+        feed->tok = T_SCALAR;
+        return carry_add(feed, s, p - s);
+    }
+
+    return scalar_done(feed, s, p, p + 1);
+}
+
+/**  strings */
+static inline uint8_t *utf8_whole(uint8_t *p, uint8_t *e)
+{
+    /*
+      Return a pointer to the end of the last complete UTF-8
+      sequence in the data from p to e, assuming that the last
+      one may be truncated.
+    */
+    uint8_t *q;
+    unsigned c, len;
+
+    q = e;
+    while (q > p && e - q < MAX_UTF8 - 1) {
+        c = *--q;
+        if (c < 0x80) break;
+        if (c < 0xc0) continue;
+
+        len = c < 0xe0 ? 2 : c < 0xf0 ? 3 : 4;
+        if (e - q < len) return q;
+        break;
+    }
+
+    return e;
+}
+
+static int add(struct uni_json_feed *feed, uint8_t *s, uint8_t *p)
+{
+    int rc;
+
+    if (p == s) return 0;
+
+    rc = feed->binds->add_2_string(s, p - s, feed->str);
+    if (!rc) return fail(feed, UJ_E_ADD, pos_of(feed, p));
+    return 0;
+}
+
+static int string_done(struct uni_json_feed *feed, size_t pos)
+{
+    void *str;
+
+    str = feed->str;
+    feed->str = NULL;
+    feed->tok = T_NONE;
+    if (feed->ascii && feed->binds->mark_ascii) feed->binds->mark_ascii(str);
+
+    return value_done(feed, str, UJ_T_STR, pos);
+}
+
+static int string(struct uni_json_feed *feed, uint8_t **pp, uint8_t *e)
+{
+    /*
+      Same algorithm as in parse_string_content, except that
+      escape and UTF-8 sequences extending beyond the end of the
+      chunk are carried over to the next one.
+    */
+    struct pstate pstate;
+    uint8_t *p, *q, *s, *bad;
+    unsigned c;
+    int rc;
+
+    s = p = bad = *pp;
+
+    while (p = skip_plain(p, e), p < e) {
+        c = *p;
+
+        if (c == '"') {
+            if (add(feed, s, p) == -1) return -1;
+
+            *pp = p + 1;
+            return string_done(feed, pos_of(feed, p + 1));
+        }
+
+        if (c == '\\') {
+            if (add(feed, s, p) == -1) return -1;
+
+            pstate.p = p + 1;
+            pstate.e = e;
+            pstate.ascii = 1;
+            rc = parse_esc(&pstate, feed->binds, feed->str);
+            if (!pstate.ascii) feed->ascii = 0;
+            if (rc == -1) {
+                if (pstate.err.code != UJ_E_EOS)
+                    return fail(feed, pstate.err.code, pos_of(feed, pstate.err.pos));
+
+                *pp = e;
+                feed->tok = T_ESC;
+                feed->tok_pos = pos_of(feed, p + 1);
+                return carry_add(feed, p + 1, e - p - 1);
+            }
+
+            s = p = pstate.p;
+            continue;
+        }
+
+        if (c < MIN_LEGAL) return fail(feed, UJ_E_INV_CHAR, pos_of(feed, p));
+        feed->ascii = 0;
+
+        if (p >= bad) {
+            bad = skip_no_esc(p, e);
+            q = bad == e ? utf8_whole(p, e) : bad;
+            if (q > p && valid_utf8(p, q)) {
+                p = q;
+                continue;
+            }
+        }
+
+        q = skip_utf8(p, e);
+        if (!q) {
+            if (e - p >= MAX_UTF8) return fail(feed, UJ_E_INV_UTF8, pos_of(feed, p));
+            if (add(feed, s, p) == -1) return -1;
+
+            *pp = e;
+            feed->tok = T_UTF8;
+            feed->tok_pos = pos_of(feed, p);
+            return carry_add(feed, p, e - p);
+        }
+
+        p = q;
+    }
+
+    *pp = e;
+    return add(feed, s, e);
+}
+
+/**  carried tokens */
+static int resume(struct uni_json_feed *feed, uint8_t **pp, uint8_t *e, int last)
+{
+    /*
+      Continue with a token carried over from an earlier chunk with
+      the data from *pp to e. last is true if there won't be any more
+      data.
+    */
+    struct pstate pstate;
+    uint8_t *p, *q, *carry;
+    size_t old, take;
+    int rc;
+
+    p = *pp;
+    old = feed->carry_len;
+
+    switch (feed->tok) {
+    case T_SCALAR:
+        q = p;
+        while (q < e && in_scalar(*q)) ++q;
+
+        *pp = q;
+        if (q == e) {
+            if (carry_add(feed, p, q - p) == -1) return -1;
+            if (!last) return 0;
+
+            carry = feed->carry;
+            return scalar_done(feed, carry, carry + feed->carry_len, carry + feed->carry_len);
+        }
+
+        if (carry_add(feed, p, q - p + 1) == -1) return -1;
+        carry = feed->carry;
+        return scalar_done(feed, carry, carry + feed->carry_len - 1, carry + feed->carry_len);
+
+    case T_ESC:
+        take = MAX_ESC - old;
+        if (take > (size_t)(e - p)) take = e - p;
+        if (carry_add(feed, p, take) == -1) return -1;
+        carry = feed->carry;
+
+        pstate.p = carry;
+        pstate.e = carry + feed->carry_len;
+        pstate.ascii = 1;
+        rc = parse_esc(&pstate, feed->binds, feed->str);
+        if (!pstate.ascii) feed->ascii = 0;
+        if (rc == -1) {
+            if (pstate.err.code == UJ_E_EOS && !last) {
+                *pp = p + take;
+                return 0;
+            }
+
+            return fail(feed, pstate.err.code, feed->tok_pos + (pstate.err.pos - carry));
+        }
+
+        *pp = p + (pstate.p - carry - old);
+        break;
+
+    case T_UTF8:
+        take = MAX_UTF8 - old;
+        if (take > (size_t)(e - p)) take = e - p;
+        if (carry_add(feed, p, take) == -1) return -1;
+        carry = feed->carry;
+
+        q = skip_utf8(carry, carry + feed->carry_len);
+        if (!q) {
+            if (feed->carry_len < MAX_UTF8 && !last) {
+                *pp = p + take;
+                return 0;
+            }
+
+            return fail(feed, UJ_E_INV_UTF8, feed->tok_pos);
+        }
+
+        rc = feed->binds->add_2_string(carry, q - carry, feed->str);
+        if (!rc) return fail(feed, UJ_E_ADD, feed->tok_pos + (q - carry));
+
+        *pp = p + (q - carry - old);
+    }
+
+    feed->tok = T_STR;
+    feed->carry_len = 0;
+    return 0;
+}
+
+/**  structure */
+static int no_value(struct uni_json_feed *feed, uint8_t **pp)
+{
+    /*
+      Handle a ] or } where a value could have been.
+    */
+    struct frame *f;
+    uint8_t *p;
+
+    p = *pp;
+    f = feed->frames + feed->level;
+
+    switch (f->state) {
+    case S_TOP:
+        return fail(feed, UJ_E_NO_VAL, 0);
+
+    case S_ARY_FIRST:
+        if (*p == ']') return close_ctr(feed, pp);
+        break;
+
+    case S_OBJ_FIRST:
+        if (*p == '}') return close_ctr(feed, pp);
+        break;
+
+    case S_OBJ_KEY:
+        return fail(feed, UJ_E_NO_KEY, pos_of(feed, p));
+
+    default:
+        return fail(feed, UJ_E_NO_VAL, pos_of(feed, p));
+    }
+
+    return fail(feed, UJ_E_INV_IN, pos_of(feed, p));
+}
+
+static int value_start(struct uni_json_feed *feed, uint8_t **pp, uint8_t *e)
+{
+    uint8_t *p;
+    unsigned c;
+
+    p = *pp;
+    c = *p;
+
+    switch (cls[c]) {
+    case C_STR:
+        feed->str = feed->binds->make_string();
+        feed->ascii = 1;
+        feed->tok = T_STR;
+
+        *pp = p + 1;
+        return 0;
+
+    case C_ARY:
+        return open_ctr(feed, UJ_T_ARY, pp);
+
+    case C_OBJ:
+        return open_ctr(feed, UJ_T_OBJ, pp);
+
+    case C_SCALAR:
+        feed->scalar = scalars[c];
+        feed->tok_pos = pos_of(feed, p);
+        return scalar(feed, pp, e);
+
+    case C_CLOSE:
+        return no_value(feed, pp);
+    }
+
+    return fail(feed, UJ_E_INV, pos_of(feed, p));
+}
+
+static int structure(struct uni_json_feed *feed, uint8_t **pp, uint8_t *e)
+{
+    /*
+      Skip whitespace and handle the next structural char or the
+      start of a value.
+    */
+    struct frame *f;
+    uint8_t *p;
+    unsigned c;
+
+    p = *pp;
+    while (p < e && cls[*p] == C_WS) ++p;
+    *pp = p;
+    if (p == e) return 0;
+
+    c = *p;
+    f = feed->frames + feed->level;
+
+    switch (f->state) {
+    case S_DONE:
+        return fail(feed, UJ_E_GARBAGE, pos_of(feed, p));
+
+    case S_ARY_NEXT:
+        if (c == ']') return close_ctr(feed, pp);
+        if (c != ',') return junk(feed, pos_of(feed, p));
+
+        f->state = S_ARY_VAL;
+        break;
+
+    case S_OBJ_COLON:
+        if (c != ':') return junk(feed, pos_of(feed, p));
+
+        f->state = S_OBJ_VAL;
+        break;
+
+    case S_OBJ_NEXT:
+        if (c == '}') return close_ctr(feed, pp);
+        if (c != ',') return junk(feed, pos_of(feed, p));
+
+        f->state = S_OBJ_KEY;
+        f->key_pos = pos_of(feed, p + 1);
+        break;
+
+    default:
+        return value_start(feed, pp, e);
+    }
+
+    *pp = p + 1;
+    return 0;
+}
+
+static int run(struct uni_json_feed *feed, uint8_t *p, uint8_t *e)
+{
+    int rc;
+
+    feed->chunk = p;
+    while (p < e) {
+        switch (feed->tok) {
+        case T_NONE:
+            rc = structure(feed, &p, e);
+            break;
+
+        case T_STR:
+            rc = string(feed, &p, e);
+            break;
+
+        default:
+            rc = resume(feed, &p, e, 0);
+        }
+
+        if (rc == -1) return -1;
+    }
+
+    return 0;
+}
+
+/**  API */
+struct uni_json_feed *uni_json_feed_start(struct uni_json_p_binding *binds, void *err_p)
+{
+    struct uni_json_feed *feed;
+
+    feed = binds->alloc(sizeof(*feed));
+    if (!feed) return NULL;
+    memset(feed, 0, sizeof(*feed));
+
+    feed->frames = binds->alloc(sizeof(*feed->frames) * INIT_FRAMES);
+    if (!feed->frames) {
+        binds->dealloc(feed);
+        return NULL;
+    }
+
+    feed->binds = binds;
+    feed->err_p = err_p;
+    feed->n_frames = INIT_FRAMES;
+    feed->max_nesting = uni_json_max_nesting;
+    feed->frames->state = S_TOP;
+
+    return feed;
+}
+
+void uni_json_feed_budget(struct uni_json_feed *feed, size_t budget)
+{
+    feed->budget = budget;
+}
+
+int uni_json_feed(struct uni_json_feed *feed, uint8_t *data, size_t len, size_t *used)
+{
+    int rc;
+
+    if (feed->budget && len > feed->budget) len = feed->budget;
+
+    rc = run(feed, data, data + len);
+    if (rc == -1) return -1;
+
+    feed->ofs += len;
+    if (used) *used = len;
+    return 0;
+}
+
+void *uni_json_feed_finish(struct uni_json_feed *feed)
+{
+    uint8_t *p;
+    void *v;
+    int rc;
+
+    p = NULL;
+    feed->chunk = p;
+    if (feed->tok > T_STR) {
+        rc = resume(feed, &p, p, 1);
+        if (rc == -1) return NULL;
+    }
+
+    if (feed->tok == T_STR) {
+        fail(feed, UJ_E_EOS, feed->ofs);
+        return NULL;
+    }
+
+    switch (feed->frames[feed->level].state) {
+    case S_DONE:
+        v = feed->val;
+        feed->val = NULL;
+        release(feed);
+        return v;
+
+    case S_TOP:
+        fail(feed, UJ_E_NO_VAL, 0);
+        break;
+
+    case S_ARY_VAL:
+    case S_OBJ_VAL:
+        fail(feed, UJ_E_NO_VAL, feed->ofs);
+        break;
+
+    case S_OBJ_KEY:
+        fail(feed, UJ_E_NO_KEY, feed->ofs);
+        break;
+
+    default:
+        fail(feed, UJ_E_EOS, feed->ofs);
+    }
+
+    return NULL;
+}
+
+void uni_json_feed_abort(struct uni_json_feed *feed)
+{
+    release(feed);
+}
@@ -0,0 +1,134 @@
+/*
+  parser handles
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+*/
+
+/*  includes */
+#include <stddef.h>
+#include <string.h>
+
+#include "uni_json_p_binding.h"
+#include "uni_json_parser.h"
+#include "pstate.h"
+#include "parser_string.h"
+#include "parser_text.h"
+#include "tape.h"
+
+/*  types */
+struct uni_json_parser {
+    struct uni_json_p_binding *binds;
+    unsigned max_nesting, flags;
+
+    /*
+      Scratch memory kept across parses. The intern table is
+      empty between parses. frames is either local or the
+      largest set of frames the iterative parser needed so far.
+    */
+    struct intern_slot interned[N_INTERN];
+    struct iter_frame *frames;
+    unsigned n_frames;
+    struct iter_frame local[INIT_FRAMES];
+    struct uni_json_tape tape;
+};
+
+/*  routines */
+struct uni_json_parser *uni_json_parser_new(struct uni_json_p_binding *binds)
+{
+    struct uni_json_parser *parser;
+
+    parser = binds->alloc(sizeof(*parser));
+    if (!parser) return NULL;
+    memset(parser, 0, sizeof(*parser));
+
+    parser->binds = binds;
+    parser->max_nesting = -1;
+    parser->frames = parser->local;
+    parser->n_frames = INIT_FRAMES;
+    parser->tape.binds = binds;
+
+    return parser;
+}
+
+void uni_json_parser_free(struct uni_json_parser *parser)
+{
+    struct uni_json_p_binding *binds;
+
+    binds = parser->binds;
+    if (parser->frames != parser->local) binds->dealloc(parser->frames);
+    tape_release(&parser->tape);
+    binds->dealloc(parser);
+}
+
+unsigned uni_json_parser_max_nesting(struct uni_json_parser *parser)
+{
+    return parser->max_nesting;
+}
+
+void uni_json_parser_set_max_nesting(struct uni_json_parser *parser, unsigned max)
+{
+    parser->max_nesting = max;
+}
+
+unsigned uni_json_parser_flags(struct uni_json_parser *parser)
+{
+    return parser->flags;
+}
+
+void uni_json_parser_set_flags(struct uni_json_parser *parser, unsigned flags)
+{
+    parser->flags = flags;
+}
+
+void *uni_json_parser_parse(struct uni_json_parser *parser, uint8_t *data, size_t len,
+                            void *err_p)
+{
+    /*
+      Parse a JSON text with the settings of parser, using the
+      recursive, the iterative or the two-stage parser depending
+      on the flags. The latter keeps the tape memory for the next
+      text.
+    */
+    struct uni_json_p_binding *binds;
+    struct iter_frame *frames;
+    struct pstate pstate;
+    unsigned n_frames;
+    void *v;
+    int rc;
+
+    binds = parser->binds;
+
+    pstate.p = data;
+    pstate.e = data + len;
+    pstate.max_nesting = parser->max_nesting;
+    reuse_intern(&pstate, binds, parser->interned);
+
+    if ((parser->flags & UJ_P_TAPE) && len <= MAX_TAPE_LEN) {
+        rc = tape_index(&parser->tape, data, len);
+        if (rc == -1) {
+            end_intern(&pstate, binds);
+
+            pstate.err.code = UJ_E_NO_MEM;
+            pstate.err.pos = data;
+            v = NULL;
+        } else
+            v = tape_walk(&parser->tape, &pstate);
+    } else if (parser->flags & UJ_P_ITER) {
+        frames = parser->frames;
+        n_frames = parser->n_frames;
+        v = parse_text_iter(&pstate, binds, &frames, &n_frames);
+
+        if (frames != parser->frames) {
+            if (parser->frames != parser->local) binds->dealloc(parser->frames);
+
+            parser->frames = frames;
+            parser->n_frames = n_frames;
+        }
+    } else
+        v = parse_text(&pstate, binds);
+
+    if (!v) binds->on_error(pstate.err.code, pstate.err.pos - data, err_p);
+    return v;
+}
@@ -0,0 +1,423 @@
+/*
+  iterative parser
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+*/
+
+/*  includes */
+#include <stddef.h>
+#include <string.h>
+
+#include "uni_json_p_binding.h"
+#include "uni_json_parser.h"
+#include "uni_json_types.h"
+#include "pstate.h"
+#include "lib.h"
+#include "parser_literals.h"
+#include "parser_number.h"
+#include "parser_string.h"
+#include "parser_text.h"
+
+/*  constants */
+/*
+  What a completed value is for. Frame 0 is a pseudo-frame for the
+  top-level value.
+*/
+enum {
+    F_TOP,
+    F_ARY,                      /* array element */
+    F_KEY,                      /* object key */
+    F_VAL                       /* object member value */
+};
+
+/*  types */
+typedef void *parse_func(struct pstate *, struct uni_json_p_binding *);
+
+struct iter {
+    struct pstate *pstate;
+    struct uni_json_p_binding *binds;
+
+    /*
+      frames[0] is a pseudo-frame for the top-level value. The
+      frames passed in by the caller are in orig.
+    */
+    struct iter_frame *frames, *orig;
+    unsigned level, n_frames;
+};
+
+/*  prototypes */
+static void *whitespace(struct pstate *, struct uni_json_p_binding *);
+static void *close_char(struct pstate *, struct uni_json_p_binding *);
+static void *open_char(struct pstate *, struct uni_json_p_binding *);
+
+/*  variables */
+static parse_func *tok_map[256] = {
+    /*
+      Same as tok_map in uni_json_parser.c except that the
+      characters starting arrays and objects are mapped to a dummy
+      routine as these are handled by the main loop.
+    */
+    ['\t'] =		whitespace,
+    ['\r'] =		whitespace,
+    ['\n'] =		whitespace,
+    [' '] =		whitespace,
+
+    [']'] =		close_char,
+    ['}'] =		close_char,
+
+    ['f'] =		parse_false,
+    ['n'] =		parse_null,
+    ['t'] =		parse_true,
+
+    ['-'] =		parse_number,
+    ['0' ... '9'] =	parse_number,
+
+    ['"'] =		parse_string,
+
+    ['['] =		open_char,
+    ['{'] =		open_char
+};
+
+/*  routines */
+/**  helpers */
+static void *whitespace(struct pstate *, struct uni_json_p_binding *)
+{
+    /* dummy routine to mark whitespace in tok_map */
+    return NULL;
+}
+
+static void *close_char(struct pstate *, struct uni_json_p_binding *)
+{
+    /* dummy routine to mark ] and } in tok_map */
+    return NULL;
+}
+
+static void *open_char(struct pstate *, struct uni_json_p_binding *)
+{
+    /* dummy routine to mark [ and { in tok_map */
+    return NULL;
+}
+
+static uint8_t *skip_ws(uint8_t *p, uint8_t *e)
+{
+    while (p < e && tok_map[*p] == whitespace) ++p;
+    return p;
+}
+
+static inline int fail(struct iter *it, unsigned code, uint8_t *pos)
+{
+    it->pstate->err.code = code;
+    it->pstate->err.pos = pos;
+    return -1;
+}
+
+static void release(struct iter *it)
+{
+    /*
+      Free all partially constructed arrays and objects after an
+      error.
+    */
+    struct uni_json_p_binding *binds;
+    struct iter_frame *f;
+
+    binds = it->binds;
+    f = it->frames + it->level;
+    while (f > it->frames) {
+        if (f->key) binds->free_string(f->key);
+        free_obj(f->state == F_ARY ? UJ_T_ARY : UJ_T_OBJ, f->ctr, binds);
+
+        --f;
+    }
+}
+
+/**  structures */
+static int open_ctr(struct iter *it)
+{
+    /*
+      Start a new array or object at the current position,
+      allocating more frames if necessary.
+    */
+    struct uni_json_p_binding *binds;
+    struct pstate *pstate;
+    struct iter_frame *f;
+    unsigned n;
+
+    pstate = it->pstate;
+    binds = it->binds;
+
+    if (it->level + 1 > pstate->max_nesting)
+        return fail(it, UJ_E_TOO_DEEP, pstate->p);
+
+    if (it->level + 1 == it->n_frames) {
+        if (!binds->alloc) return fail(it, UJ_E_NO_MEM, pstate->p);
+
+        n = it->n_frames * 2;
+        f = binds->alloc(sizeof(*f) * n);
+        if (!f) return fail(it, UJ_E_NO_MEM, pstate->p);
+
+        memcpy(f, it->frames, sizeof(*f) * it->n_frames);
+        if (it->frames != it->orig) binds->dealloc(it->frames);
+
+        it->frames = f;
+        it->n_frames = n;
+    }
+
+    f = it->frames + ++it->level;
+    f->key = NULL;
+
+    if (*pstate->p == '[') {
+        f->ctr = binds->make_array();
+        f->state = F_ARY;
+    } else {
+        f->ctr = binds->make_object();
+        f->state = F_KEY;
+        f->pos = pstate->p + 1;
+    }
+
+    ++pstate->p;
+    return 0;
+}
+
+static void *close_ctr(struct iter *it)
+{
+    struct iter_frame *f;
+
+    f = it->frames + it->level--;
+    it->pstate->last_type = f->state == F_ARY ? UJ_T_ARY : UJ_T_OBJ;
+    return f->ctr;
+}
+
+static int no_value(struct iter *it, int first)
+{
+    /*
+      Handle a missing value, ie, end of input or a close
+      char. Returns 1 if this closed an empty container, -1
+      otherwise.
+    */
+    struct pstate *pstate;
+    struct iter_frame *f;
+    int c;
+
+    pstate = it->pstate;
+    f = it->frames + it->level;
+
+    switch (f->state) {
+    case F_TOP:
+        return fail(it, UJ_E_NO_VAL, pstate->p);
+
+    case F_ARY:
+        if (!first) return fail(it, UJ_E_NO_VAL, pstate->p);
+
+        c = skip_one_of(pstate, "]");
+        break;
+
+    case F_KEY:
+        if (!first) return fail(it, UJ_E_NO_KEY, pstate->p);
+
+        c = skip_one_of(pstate, "}");
+        break;
+
+    default:
+        return fail(it, UJ_E_NO_VAL, pstate->p);
+    }
+
+    return c == -1 ? -1 : 1;
+}
+
+static int value_done(struct iter *it, void *v)
+{
+    /*
+      Store a completed value in the innermost container. Returns
+      1 if a value should be parsed next, 0 if the container was
+      closed and -1 on error.
+    */
+    struct uni_json_p_binding *binds;
+    struct pstate *pstate;
+    struct iter_frame *f;
+    int c, rc;
+
+    pstate = it->pstate;
+    binds = it->binds;
+    f = it->frames + it->level;
+
+    switch (f->state) {
+    case F_ARY:
+        rc = binds->add_2_array(v, f->ctr);
+        if (!rc) {
+            free_obj(pstate->last_type, v, binds);
+            return fail(it, UJ_E_ADD, pstate->p);
+        }
+
+        c = skip_one_of(pstate, ",]");
+        if (c == -1) return -1;
+        return c == ',';
+
+    case F_KEY:
+        if (pstate->last_type != UJ_T_STR) {
+            free_obj(pstate->last_type, v, binds);
+            return fail(it, UJ_E_INV_KEY, f->pos);
+        }
+
+        f->key = v;
+
+        c = skip_one_of(pstate, ":");
+        if (c == -1) return -1;
+
+        f->state = F_VAL;
+        return 1;
+    }
+
+    rc = binds->add_2_object(f->key, v, f->ctr);
+    if (!rc) {
+        free_obj(pstate->last_type, v, binds);
+        return fail(it, UJ_E_ADD, pstate->p);
+    }
+    f->key = NULL;
+
+    c = skip_one_of(pstate, ",}");
+    if (c == -1) return -1;
+
+    f->state = F_KEY;
+    f->pos = pstate->p;
+    return c == ',';
+}
+
+static void *run(struct iter *it)
+{
+    /*
+      Main loop: Parse values until the top-level value is
+      complete. Arrays and objects are tracked in frames instead
+      of by recursion, hence, the amount of C stack used doesn't
+      depend on the nesting depth.
+    */
+    struct pstate *pstate;
+    parse_func *parse;
+    uint8_t *p, *e;
+    int first, rc;
+    void *v;
+
+    pstate = it->pstate;
+    e = pstate->e;
+    first = 1;
+
+    while (1) {
+        /*  start of a value */
+        p = pstate->p = skip_ws(pstate->p, e);
+        parse = p < e ? tok_map[*p] : close_char;
+
+        if (parse == close_char) {
+            rc = no_value(it, first);
+            if (rc == -1) return NULL;
+
+            v = close_ctr(it);
+        } else if (parse == open_char) {
+            rc = open_ctr(it);
+            if (rc == -1) return NULL;
+
+            first = 1;
+            continue;
+        } else if (parse) {
+            pstate->key = it->frames[it->level].state == F_KEY;
+            v = parse(pstate, it->binds);
+            pstate->key = 0;
+            if (!v) return NULL;
+        } else {
+            fail(it, UJ_E_INV, p);
+            return NULL;
+        }
+
+        /*  end of a value */
+        while (1) {
+            pstate->p = skip_ws(pstate->p, e);
+            if (!it->level) return v;
+
+            rc = value_done(it, v);
+            if (rc == -1) return NULL;
+            if (rc) break;
+
+            v = close_ctr(it);
+        }
+
+        first = 0;
+    }
+}
+
+void *parse_text_iter(struct pstate *pstate, struct uni_json_p_binding *binds,
+                      struct iter_frame **frames, unsigned *n_frames)
+{
+    /*
+      Same as parse_text but without using recursion for nested
+      arrays and objects. *frames must point to *n_frames frames,
+      at least one. If more are needed, they're allocated with
+      binds->alloc. Upon return, *frames and *n_frames are the
+      largest set of frames which was used. If these were
+      allocated, the caller must free them.
+    */
+    struct iter it;
+    uint8_t *data;
+    void *v;
+
+    data = pstate->p;
+    pstate->level = 0;
+
+    it.pstate = pstate;
+    it.binds = binds;
+    it.frames = it.orig = *frames;
+    it.n_frames = *n_frames;
+    it.level = 0;
+    it.frames->state = F_TOP;
+
+    v = run(&it);
+    end_intern(pstate, binds);
+
+    *frames = it.frames;
+    *n_frames = it.n_frames;
+
+    if (!v) {
+        release(&it);
+
+        /*  as parse_text, no value at all is reported at 0 */
+        if (pstate->err.code == UJ_E_NO_VAL && !it.level) pstate->err.pos = data;
+        return NULL;
+    }
+
+    if (pstate->p != pstate->e) {
+        free_obj(pstate->last_type, v, binds);
+
+        pstate->err.code = UJ_E_GARBAGE;
+        pstate->err.pos = pstate->p;
+        return NULL;
+    }
+
+    return v;
+}
+
+/**  API */
+void *uni_json_parse_iter(uint8_t *data, size_t len,
+                          struct uni_json_p_binding *binds, void *err_p)
+{
+    /*
+      Parse a JSON text like uni_json_parse but without using
+      recursion for nested arrays and objects.
+    */
+    struct intern_slot interned[N_INTERN];
+    struct iter_frame local[INIT_FRAMES], *frames;
+    struct pstate pstate;
+    unsigned n_frames;
+    void *v;
+
+    pstate.p = data;
+    pstate.e = data + len;
+    pstate.max_nesting = uni_json_max_nesting;
+    start_intern(&pstate, binds, interned);
+
+    frames = local;
+    n_frames = INIT_FRAMES;
+    v = parse_text_iter(&pstate, binds, &frames, &n_frames);
+    if (frames != local) binds->dealloc(frames);
+
+    if (!v) binds->on_error(pstate.err.code, pstate.err.pos - data, err_p);
+    return v;
+}
@@ -9,6 +9,7 @@
 /*  includes */
 #include <stddef.h>
 #include <stdio.h>
+#include <string.h>
 #include "compiler.h"
 
 #include "uni_json_p_binding.h"
@@ -20,6 +21,7 @@
 #include "parser_number.h"
 #include "parser_object.h"
 #include "parser_string.h"
+#include "parser_text.h"
 
 /*  types */
 typedef void *parse_func(struct pstate *, struct uni_json_p_binding *);
@@ -86,7 +88,9 @@ static char *ec_msg_map[] = {
     [UJ_E_INV_ESC] =	"illegal escape sequence",
     [UJ_E_INV_KEY] =	"object key is no string",
     [UJ_E_NO_KEY] =	"missing key in object",
-    [UJ_E_TOO_DEEP] =	"too many levels of nesting"
+    [UJ_E_TOO_DEEP] =	"too many levels of nesting",
+    [UJ_E_NO_MEM] =	"failed to allocate memory",
+    [UJ_E_INV_PATH] =	"invalid JSON pointer"
 };
 
 /* parse_value returns &no_value if no value was found */
@@ -133,7 +137,10 @@ void *parse_value(struct pstate *pstate, struct uni_json_p_binding *binds)
     e = pstate->e;
     while (p < e && (parse = tok_map[*p], parse == whitespace))
         ++p;
-    if (p == e) return &no_value;
+    if (p == e) {
+        pstate->p = p;
+        return &no_value;
+    }
 
     if (!parse) {
         pstate->err.code = UJ_E_INV;
@@ -160,9 +167,50 @@ char *uni_json_ec_2_msg(unsigned ec)
     return "not implemented";
 }
 
+void *parse_text(struct pstate *pstate, struct uni_json_p_binding *binds)
+{
+    /*
+      Parse the JSON text from pstate->p to pstate->e which must
+      be a single value. Nesting limit and intern table must have
+      been set up by the caller. The intern table is emptied and
+      the value stack freed before returning.
+
+      Returns the value or NULL with error code and position in
+      *pstate.
+    */
+    uint8_t *data;
+    void *v;
+
+    data = pstate->p;
+    pstate->level = 0;
+    start_batch(pstate);
+
+    v = parse_value(pstate, binds);
+    end_batch(pstate, binds);
+    end_intern(pstate, binds);
+    if (!v) return NULL;
+
+    if ((int *)v == &no_value) {
+        pstate->err.code = UJ_E_NO_VAL;
+        pstate->err.pos = data;
+        return NULL;
+    }
+
+    if (pstate->p != pstate->e) {
+        free_obj(pstate->last_type, v, binds);
+
+        pstate->err.code = UJ_E_GARBAGE;
+        pstate->err.pos = pstate->p;
+        return NULL;
+    }
+
+    return v;
+}
+
 void *uni_json_parse(uint8_t *data, size_t len,
                      struct uni_json_p_binding *binds, void *err_p)
 {
+    struct intern_slot interned[N_INTERN];
     struct pstate pstate;
     void *v;
 
@@ -173,25 +221,88 @@ void *uni_json_parse(uint8_t *data, size_t len,
 
     pstate.p = data;
     pstate.e = data + len;
-    pstate.level = 0;
+    pstate.max_nesting = uni_json_max_nesting;
+    start_intern(&pstate, binds, interned);
 
-    v = parse_value(&pstate, binds);
+    v = parse_text(&pstate, binds);
+    if (!v) binds->on_error(pstate.err.code, pstate.err.pos - data, err_p);
+    return v;
+}
 
-    if (!v) {
-        binds->on_error(pstate.err.code, pstate.err.pos - data, err_p);
-        return NULL;
-    }
+static uint8_t *skip_ws(uint8_t *p, uint8_t *e)
+{
+    while (p < e && tok_map[*p] == whitespace) ++p;
+    return p;
+}
 
-    if ((int *)v == &no_value) {
-        binds->on_error(UJ_E_NO_VAL, 0, err_p);
-        return NULL;
-    }
+int uni_json_parse_seq(uint8_t *data, size_t len, struct uni_json_p_binding *binds,
+                       int (*on_value)(void *val, size_t pos, void *cb_p),
+                       void *cb_p, unsigned flags)
+{
+    /*
+      Parse a sequence of JSON values, eg, newline-delimited
+      JSON. Each value is passed to on_value together with its
+      position. Parsing stops when on_value returns 0.
 
-    if (pstate.p != pstate.e) {
-        free_obj(pstate.last_type, v, binds);
-        binds->on_error(UJ_E_GARBAGE, pstate.p - data, err_p);
-        return NULL;
+      If UJ_SEQ_RESYNC is set in flags, parsing continues after
+      the next linefeed after an error instead of stopping.
+
+      Returns the number of values passed to on_value or -1 if
+      parsing was aborted because of an error.
+    */
+    struct intern_slot interned[N_INTERN];
+    struct pstate pstate;
+    uint8_t *p, *e;
+    unsigned n;
+    void *v;
+    int rc;
+
+    e = data + len;
+    p = data;
+    n = 0;
+    pstate.max_nesting = uni_json_max_nesting;
+    start_intern(&pstate, binds, interned);
+    start_batch(&pstate);
+
+    while (p = skip_ws(p, e), p < e) {
+        pstate.p = p;
+        pstate.e = e;
+        pstate.level = 0;
+
+        v = parse_value(&pstate, binds);
+        if (!v || (int *)v == &no_value) {
+            /* no_value here means a close char without a container */
+            if (v) {
+                pstate.err.code = UJ_E_NO_VAL;
+                pstate.err.pos = p;
+            }
+
+            /*
+              The intern table must be empty and the value stack
+              freed when invoking the error handler as it might
+              not return.
+            */
+            end_batch(&pstate, binds);
+            end_intern(&pstate, binds);
+            binds->on_error(pstate.err.code, pstate.err.pos - data, cb_p);
+            if (!(flags & UJ_SEQ_RESYNC)) return -1;
+            reuse_intern(&pstate, binds, interned);
+
+            p = memchr(pstate.err.pos, '\n', e - pstate.err.pos);
+            if (!p) break;
+
+            ++p;
+            continue;
+        }
+
+        rc = on_value(v, p - data, cb_p);
+        ++n;
+        if (!rc) break;
+
+        p = pstate.p;
     }
 
-    return v;
+    end_batch(&pstate, binds);
+    end_intern(&pstate, binds);
+    return n;
 }
@@ -0,0 +1,524 @@
+/*
+  path-projected parsing
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+*/
+
+/*  includes */
+#include <stddef.h>
+#include <string.h>
+
+#include "uni_json_p_binding.h"
+#include "uni_json_parser.h"
+#include "pstate.h"
+#include "lib.h"
+#include "parser_string.h"
+#include "parser_skip.h"
+
+/*  constants */
+enum {
+    INIT_PATHS =	16      /* paths tracked without allocating memory */
+};
+
+/*  types */
+struct path {
+    uint8_t *s, *e;             /* the JSON pointer */
+
+    /*
+      Next segment to match, NULL if all segments matched. idx is
+      the segment as array index or -1 if it isn't one.
+    */
+    uint8_t *seg, *seg_e;
+    size_t idx;
+    int wild;
+
+    unsigned depth;             /* number of segments matched */
+
+    /*  comparison of the segment with an object key */
+    uint8_t *cur;
+    int same;
+};
+
+struct sel {
+    struct pstate pstate;
+    struct uni_json_p_binding *binds;
+    struct path *paths;
+    unsigned n_paths, depth;
+
+    int (*on_value)(unsigned path, void *val, size_t pos, void *cb_p);
+    void *cb_p;
+    uint8_t *data;
+    int n, stopped;
+
+    int (*skip)(struct pstate *);
+};
+
+/*  prototypes */
+static int cmp_key(uint8_t *, size_t, void *);
+static int select_value(struct sel *);
+
+void *parse_value(struct pstate *, struct uni_json_p_binding *);
+
+/*  variables */
+extern int no_value;
+
+/*
+  The string parser adds data to strings with the add_2_string
+  binding routine. This one compares object keys with the
+  segments of the paths instead.
+*/
+static struct uni_json_p_binding cmp_binds = {
+    .add_2_string =	cmp_key
+};
+
+/*  routines */
+/**  helpers */
+static uint8_t *skip_ws(uint8_t *p, uint8_t *e)
+{
+    while (p < e && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p;
+    return p;
+}
+
+/**  paths */
+static int check_path(uint8_t *p)
+{
+    /*
+      Check that a path is a valid JSON pointer (RFC 6901), ie,
+      either empty or a sequence of segments starting with a / with
+      ~ only used as part of ~0 or ~1.
+    */
+    if (!*p) return 0;
+    if (*p != '/') return -1;
+
+    while (*++p)
+        if (*p == '~' && p[1] != '0' && p[1] != '1') return -1;
+
+    return 0;
+}
+
+static void set_seg(struct path *path, uint8_t *seg)
+{
+    uint8_t *p;
+    size_t idx;
+
+    path->seg = seg;
+    if (!seg) return;
+
+    path->seg_e = memchr(seg, '/', path->e - seg);
+    if (!path->seg_e) path->seg_e = path->e;
+
+    path->wild = path->seg_e - seg == 1 && *seg == '*';
+
+    /*  array indices are decimal without leading zeroes */
+    path->idx = -1;
+    if (seg == path->seg_e || path->seg_e - seg > 19 || (*seg == '0' && path->seg_e - seg > 1))
+        return;
+
+    idx = 0;
+    for (p = seg; p < path->seg_e; ++p) {
+        if (*p < '0' || *p > '9') return;
+        idx = idx * 10 + *p - '0';
+    }
+    path->idx = idx;
+}
+
+static void next_seg(struct path *path)
+{
+    ++path->depth;
+    set_seg(path, path->seg_e == path->e ? NULL : path->seg_e + 1);
+}
+
+static void prev_seg(struct path *path)
+{
+    uint8_t *p;
+
+    p = path->seg ? path->seg - 1 : path->e;
+    do --p; while (*p != '/');
+
+    --path->depth;
+    set_seg(path, p + 1);
+}
+
+static int cmp_key(uint8_t *data, size_t len, void *p)
+{
+    /*
+      Compare a chunk of an object key with the segments of all
+      paths matched so far, decoding ~0 and ~1 in the latter.
+    */
+    struct path *path, *end;
+    struct sel *sel;
+    uint8_t *q, *d;
+    unsigned c;
+
+    sel = p;
+    path = sel->paths;
+    end = path + sel->n_paths;
+    while (path < end) {
+        if (path->depth == sel->depth && path->seg && path->same) {
+            q = path->cur;
+
+            for (d = data; d < data + len; ++d) {
+                if (q == path->seg_e) break;
+
+                c = *q++;
+                if (c == '~') c = *q++ == '1' ? '/' : '~';
+                if (c != *d) break;
+            }
+
+            path->cur = q;
+            path->same = d == data + len;
+        }
+
+        ++path;
+    }
+
+    return 1;
+}
+
+/**  structures */
+static int select_child(struct sel *sel, size_t idx, int key)
+{
+    /*
+      Select from an array element or object member value. The
+      paths whose next segment matches idx or the key which was
+      just compared are advanced by one segment while doing so.
+    */
+    struct path *path, *end;
+    int rc;
+
+    end = sel->paths + sel->n_paths;
+    for (path = sel->paths; path < end; ++path) {
+        if (path->depth != sel->depth || !path->seg) continue;
+
+        if (path->wild
+            || (key ? path->same && path->cur == path->seg_e : path->idx == idx))
+            next_seg(path);
+    }
+
+    ++sel->depth;
+    rc = select_value(sel);
+    --sel->depth;
+
+    for (path = sel->paths; path < end; ++path)
+        if (path->depth > sel->depth) prev_seg(path);
+
+    return rc;
+}
+
+static int enter(struct sel *sel)
+{
+    struct pstate *pstate;
+
+    pstate = &sel->pstate;
+
+    ++pstate->level;
+    if (pstate->level > pstate->max_nesting) {
+        pstate->err.code = UJ_E_TOO_DEEP;
+        pstate->err.pos = pstate->p;
+        return -1;
+    }
+
+    ++pstate->p;
+    return 0;
+}
+
+static int select_array(struct sel *sel)
+{
+    /*  same checks in the same order as parse_array */
+    struct pstate *pstate;
+    size_t idx;
+    int rc;
+
+    pstate = &sel->pstate;
+
+    rc = enter(sel);
+    if (rc == -1) return -1;
+
+    idx = 0;
+    rc = select_child(sel, idx, 0);
+    if (rc == -1) return -1;
+
+    if (rc == SKIP_NONE) {
+        rc = skip_one_of(pstate, "]");
+        if (rc == -1) return -1;
+    } else
+        do {
+            rc = skip_one_of(pstate, ",]");
+            if (rc == -1) return -1;
+
+            if (rc == ',') {
+                rc = select_child(sel, ++idx, 0);
+                if (rc == -1) return -1;
+
+                if (rc == SKIP_NONE) {
+                    pstate->err.code = UJ_E_NO_VAL;
+                    pstate->err.pos = pstate->p;
+                    return -1;
+                }
+
+                rc = ',';
+            }
+        } while (rc == ',');
+
+    --pstate->level;
+    return SKIP_OK;
+}
+
+static int select_key(struct sel *sel)
+{
+    /*
+      Parse an object key, comparing it with the next segments of
+      the paths matched so far.
+    */
+    struct pstate *pstate;
+    struct path *path, *end;
+    uint8_t *pos, *p, *e;
+    int rc;
+
+    pstate = &sel->pstate;
+    pos = pstate->p;
+
+    e = pstate->e;
+    p = pstate->p = skip_ws(pos, e);
+
+    if (p == e || *p != '"') {
+        /*  skipped for the same error as parse_object */
+        rc = skip_value(pstate);
+        if (rc != SKIP_OK) return rc;
+
+        pstate->err.code = UJ_E_INV_KEY;
+        pstate->err.pos = pos;
+        return -1;
+    }
+
+    end = sel->paths + sel->n_paths;
+    for (path = sel->paths; path < end; ++path) {
+        path->cur = path->seg;
+        path->same = 1;
+    }
+
+    ++pstate->p;
+    rc = parse_string_content(pstate, &cmp_binds, sel);
+    if (rc == -1) return -1;
+
+    pstate->p = skip_ws(pstate->p, e);
+    return SKIP_OK;
+}
+
+static int select_object(struct sel *sel)
+{
+    /*  same checks in the same order as parse_object */
+    struct pstate *pstate;
+    int c, rc;
+
+    pstate = &sel->pstate;
+
+    rc = enter(sel);
+    if (rc == -1) return -1;
+
+    rc = select_key(sel);
+    if (rc == -1) return -1;
+
+    if (rc == SKIP_NONE) {
+        c = skip_one_of(pstate, "}");
+        if (c == -1) return -1;
+    } else
+        do {
+            c = skip_one_of(pstate, ":");
+            if (c == -1) return -1;
+
+            rc = select_child(sel, 0, 1);
+            if (rc == -1) return -1;
+
+            if (rc == SKIP_NONE) {
+                pstate->err.code = UJ_E_NO_VAL;
+                pstate->err.pos = pstate->p;
+                return -1;
+            }
+
+            c = skip_one_of(pstate, ",}");
+            if (c == -1) return -1;
+
+            if (c == ',') {
+                rc = select_key(sel);
+                if (rc == -1) return -1;
+
+                if (rc == SKIP_NONE) {
+                    pstate->err.code = UJ_E_NO_KEY;
+                    pstate->err.pos = pstate->p;
+                    return -1;
+                }
+            }
+        } while (c == ',');
+
+    --pstate->level;
+    return SKIP_OK;
+}
+
+/**  values */
+static int emit(struct sel *sel, unsigned i)
+{
+    /*
+      Parse the value at the current position for path i and
+      pass it on.
+    */
+    struct pstate *pstate;
+    uint8_t *pos;
+    void *v;
+    int rc;
+
+    pstate = &sel->pstate;
+    pos = pstate->p;
+
+    v = parse_value(pstate, sel->binds);
+    if (!v) return -1;
+    if ((int *)v == &no_value) return SKIP_NONE;
+
+    ++sel->n;
+    rc = sel->on_value(i, v, pos - sel->data, sel->cb_p);
+    if (!rc) {
+        sel->stopped = 1;
+        return -1;
+    }
+
+    return SKIP_OK;
+}
+
+static int select_value(struct sel *sel)
+{
+    /*
+      Handle a value at the current depth: Values at the end of a
+      path are created and passed on, arrays and objects which
+      contain the next segment of a path are descended into and
+      everything else is skipped without creating anything.
+
+      Returns the same as skip_value.
+    */
+    struct pstate *pstate;
+    struct path *path;
+    uint8_t *p, *e, *end;
+    unsigned i;
+    int deeper, rc;
+
+    pstate = &sel->pstate;
+    e = pstate->e;
+    p = pstate->p = skip_ws(pstate->p, e);
+
+    end = NULL;
+    deeper = 0;
+    for (i = 0; i < sel->n_paths; ++i) {
+        path = sel->paths + i;
+        if (path->depth != sel->depth) continue;
+
+        if (path->seg) {
+            deeper = 1;
+            continue;
+        }
+
+        /*  one value for each path ending here */
+        pstate->p = p;
+        rc = emit(sel, i);
+        if (rc != SKIP_OK) return rc;
+        end = pstate->p;
+    }
+
+    if (deeper && p < e && (*p == '[' || *p == '{')) {
+        pstate->p = p;
+        rc = *p == '[' ? select_array(sel) : select_object(sel);
+        if (rc == -1) return -1;
+
+        pstate->p = skip_ws(pstate->p, e);
+
+        return SKIP_OK;
+    }
+
+    if (end) return SKIP_OK;
+    return sel->skip(pstate);
+}
+
+/**  API */
+int uni_json_parse_paths(uint8_t *data, size_t len, struct uni_json_p_binding *binds,
+                         char **paths, unsigned n_paths,
+                         int (*on_value)(unsigned path, void *val, size_t pos, void *cb_p),
+                         void *cb_p, unsigned flags)
+{
+    /*
+      Parse a JSON text but only create the values at the given
+      JSON pointers. Each value is passed to on_value together
+      with the index of the path and its position. Parsing stops
+      when on_value returns 0.
+
+      Everything else is skipped. Unless UJ_PATH_NO_VALIDATE is set
+      in flags, this includes the same checks as uni_json_parse.
+
+      Returns the number of values passed to on_value or -1 after
+      invoking the error handler in case of an error.
+    */
+    struct intern_slot interned[N_INTERN];
+    struct path local[INIT_PATHS];
+    struct pstate *pstate;
+    struct sel sel;
+    unsigned i;
+    int rc;
+
+    for (i = 0; i < n_paths; ++i)
+        if (check_path((uint8_t *)paths[i]) == -1) {
+            binds->on_error(UJ_E_INV_PATH, i, cb_p);
+            return -1;
+        }
+
+    sel.paths = local;
+    if (n_paths > INIT_PATHS) {
+        sel.paths = binds->alloc ? binds->alloc(sizeof(*sel.paths) * n_paths) : NULL;
+        if (!sel.paths) {
+            binds->on_error(UJ_E_NO_MEM, 0, cb_p);
+            return -1;
+        }
+    }
+
+    for (i = 0; i < n_paths; ++i) {
+        sel.paths[i].s = (uint8_t *)paths[i];
+        sel.paths[i].e = sel.paths[i].s + strlen(paths[i]);
+        sel.paths[i].depth = 0;
+        set_seg(sel.paths + i, *paths[i] ? sel.paths[i].s + 1 : NULL);
+    }
+
+    sel.binds = binds;
+    sel.n_paths = n_paths;
+    sel.depth = 0;
+    sel.on_value = on_value;
+    sel.cb_p = cb_p;
+    sel.data = data;
+    sel.n = sel.stopped = 0;
+    sel.skip = flags & UJ_PATH_NO_VALIDATE ? skip_value_fast : skip_value;
+
+    pstate = &sel.pstate;
+    pstate->p = data;
+    pstate->e = data + len;
+    pstate->level = 0;
+    pstate->key = 0;
+    pstate->max_nesting = uni_json_max_nesting;
+    start_intern(pstate, binds, interned);
+    start_batch(pstate);
+
+    rc = select_value(&sel);
+    end_batch(pstate, binds);
+    end_intern(pstate, binds);
+    if (sel.paths != local) binds->dealloc(sel.paths);
+
+    if (rc == -1) {
+        if (sel.stopped) return sel.n;
+    } else if (rc == SKIP_NONE) {
+        pstate->err.code = UJ_E_NO_VAL;
+        pstate->err.pos = data;
+    } else if (pstate->p != pstate->e) {
+        pstate->err.code = UJ_E_GARBAGE;
+        pstate->err.pos = pstate->p;
+    } else
+        return sel.n;
+
+    binds->on_error(pstate->err.code, pstate->err.pos - data, cb_p);
+    return -1;
+}
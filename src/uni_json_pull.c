@@ -0,0 +1,537 @@
+/*
+  pull serializer
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+*/
+
+/*  includes */
+#include <math.h>
+#include <string.h>
+
+#include "uni_json_types.h"
+#include "uni_json_s_binding.h"
+#include "uni_json_serializer.h"
+#include "scan.h"
+#include "number_fmt.h"
+#include "ser_common.h"
+
+/*  constants */
+enum {
+    INIT_PULL_FRAMES =	16,
+    CARRY_SIZE =	64      /* > output of a single step */
+};
+
+enum {
+    /*  kinds of text being output */
+    TXT_NONE,
+    TXT_RAW,                    /* number text from get_num_data */
+    TXT_STR,                    /* string value */
+    TXT_KEY                     /* object key */
+};
+
+/*  types */
+struct pull_frame {
+    unsigned type, first;
+    void *iter;
+    void *val;                  /* value to output next, if any */
+    struct kvp_heap kvph;       /* sorted key-value pairs for UJ_FMT_DET/PRETTY */
+    struct kvp_buf kb;          /* storage of kvph, kept after the frame was popped */
+};
+
+struct uni_json_pull {
+    struct uni_json_s_binding *binds;
+    int fmt;
+    void *val;                  /* top-level value until started */
+
+    /*  caller buffer of the current call */
+    uint8_t *p, *e;
+
+    /*
+      Output still due before the next step: data of the last step
+      which didn't fit into the caller buffer, indentation and
+      string or number text, in this order.
+    */
+    uint8_t carry[CARRY_SIZE];
+    unsigned c_pos, c_len;
+    unsigned tabs;
+    struct uj_data txt;
+    size_t t_pos;
+    unsigned t_kind, t_open;
+
+    /*  open arrays and objects */
+    struct pull_frame *frames;
+    unsigned depth, n_frames;
+    struct pull_frame local[INIT_PULL_FRAMES];
+};
+
+/*  routines */
+/**  output */
+static void emit(struct uni_json_pull *pl, void *data, size_t len)
+{
+    /*
+      Output at most CARRY_SIZE bytes, keeping whatever doesn't fit
+      into the caller buffer for the next call.
+    */
+    size_t room;
+
+    if (pl->c_pos == pl->c_len) {
+        room = pl->e - pl->p;
+        if (room >= len) {
+            memcpy(pl->p, data, len);
+            pl->p += len;
+            return;
+        }
+
+        memcpy(pl->p, data, room);
+        pl->p += room;
+        data = (uint8_t *)data + room;
+        len -= room;
+
+        pl->c_pos = pl->c_len = 0;
+    }
+
+    memcpy(pl->carry + pl->c_len, data, len);
+    pl->c_len += len;
+}
+
+static void drain_carry(struct uni_json_pull *pl)
+{
+    size_t len;
+
+    len = pl->c_len - pl->c_pos;
+    if (len > (size_t)(pl->e - pl->p)) len = pl->e - pl->p;
+
+    memcpy(pl->p, pl->carry + pl->c_pos, len);
+    pl->p += len;
+    pl->c_pos += len;
+}
+
+static void drain_tabs(struct uni_json_pull *pl)
+{
+    size_t len;
+
+    len = pl->tabs;
+    if (len > (size_t)(pl->e - pl->p)) len = pl->e - pl->p;
+
+    memset(pl->p, '\t', len);
+    pl->p += len;
+    pl->tabs -= len;
+}
+
+static void end_txt(struct uni_json_pull *pl)
+{
+    struct uni_json_s_binding *binds;
+
+    binds = pl->binds;
+
+    switch (pl->t_kind) {
+    case TXT_RAW:
+        if (binds->free_num_data) binds->free_num_data(&pl->txt);
+        break;
+
+    case TXT_STR:
+        emit(pl, "\"", 1);
+        if (binds->free_string_data) binds->free_string_data(&pl->txt);
+        break;
+
+    case TXT_KEY:
+        if (pl->fmt == UJ_FMT_PRETTY)
+            emit(pl, "\" : ", 4);
+        else
+            emit(pl, "\":", 2);
+    }
+
+    pl->t_kind = TXT_NONE;
+}
+
+static void drain_txt(struct uni_json_pull *pl)
+{
+    /*
+      Output as much of the pending text as fits into the caller
+      buffer. Strings are escaped like in ser_string_data, except
+      that runs of bytes are limited to the space left.
+    */
+    struct esc *esc;
+    uint8_t *s, *r, *q, *e;
+    size_t room;
+
+    s = pl->txt.s + pl->t_pos;
+    e = pl->txt.s + pl->txt.len;
+
+    if (pl->t_kind == TXT_RAW) {
+        room = pl->e - pl->p;
+        if (room > (size_t)(e - s)) room = e - s;
+
+        memcpy(pl->p, s, room);
+        pl->p += room;
+        s += room;
+    } else {
+        if (!pl->t_open) {
+            emit(pl, "\"", 1);
+            pl->t_open = 1;
+        }
+
+        while (s < e && pl->p < pl->e) {
+            room = pl->e - pl->p;
+            q = (size_t)(e - s) > room ? s + room : e;
+
+            r = s;
+            while (r < q && r - s < SCALAR_RUN && !escs[*r].len) ++r;
+            if (r - s == SCALAR_RUN) r = skip_no_esc(r, q);
+
+            memcpy(pl->p, s, r - s);
+            pl->p += r - s;
+            s = r;
+
+            while (s < e && pl->p < pl->e && (esc = escs + *s)->len) {
+                emit(pl, esc->s, esc->len);
+                ++s;
+            }
+        }
+    }
+
+    pl->t_pos = s - pl->txt.s;
+    if (s == e) end_txt(pl);
+}
+
+/**  frames */
+static void clear_kvp_bufs(struct pull_frame *f, unsigned n)
+{
+    while (n) {
+        f->kb.kvps = NULL;
+        f->kb.size = 0;
+
+        ++f;
+        --n;
+    }
+}
+
+static struct pull_frame *push(struct uni_json_pull *pl, unsigned type)
+{
+    struct uni_json_s_binding *binds;
+    struct pull_frame *frames, *f;
+    unsigned n;
+
+    if (pl->depth == pl->n_frames) {
+        binds = pl->binds;
+
+        n = pl->n_frames * 2;
+        frames = binds->alloc(n * sizeof(*frames));
+        if (!frames) return NULL;
+
+        memcpy(frames, pl->frames, pl->depth * sizeof(*frames));
+        clear_kvp_bufs(frames + pl->depth, n - pl->depth);
+        if (pl->frames != pl->local) binds->dealloc(pl->frames);
+
+        pl->frames = frames;
+        pl->n_frames = n;
+    }
+
+    f = pl->frames + pl->depth++;
+    f->type = type;
+    f->first = 1;
+    f->val = NULL;
+    f->kvph.h = NULL;
+
+    return f;
+}
+
+static void pop(struct uni_json_pull *pl)
+{
+    struct uni_json_s_binding *binds;
+    struct pull_frame *f;
+
+    binds = pl->binds;
+    f = pl->frames + --pl->depth;
+
+    if (f->type == UJ_T_ARY) {
+        if (binds->end_array_traversal) binds->end_array_traversal(f->iter);
+        return;
+    }
+
+    if (binds->end_object_traversal) binds->end_object_traversal(f->iter);
+}
+
+/**  steps */
+static int begin_value(struct uni_json_pull *pl, void *val)
+{
+    /*
+      Start output of val. Strings and number text become pending
+      text, arrays and objects get a frame. Returns -1 if
+      allocating memory failed, 1 otherwise.
+    */
+    struct uni_json_s_binding *binds;
+    struct pull_frame *f;
+    struct uj_kv_pair *kvps;
+    uint8_t num[FMT_NUM_MAX];
+    union uj_num nv;
+    size_t max_kvps, len;
+    int type;
+
+    binds = pl->binds;
+
+    switch (binds->type_of(val)) {
+    case UJ_T_BOOL:
+        if (binds->get_bool_value(val))
+            emit(pl, "true", 4);
+        else
+            emit(pl, "false", 5);
+        break;
+
+    case UJ_T_NUM:
+        type = binds->get_num_value ? binds->get_num_value(val, &nv) : UJ_NUM_DATA;
+        switch (type) {
+        case UJ_NUM_DATA:
+            binds->get_num_data(val, &pl->txt);
+            pl->t_pos = 0;
+            pl->t_kind = TXT_RAW;
+            return 1;
+
+        case UJ_NUM_INT64:
+            len = fmt_int(nv.i, num);
+            break;
+
+        case UJ_NUM_UINT64:
+            len = fmt_uint(nv.u, num);
+            break;
+
+        default:
+            if (!isfinite(nv.d)) {
+                emit(pl, "null", 4);
+                return 1;
+            }
+
+            len = fmt_double(nv.d, num);
+        }
+
+        emit(pl, num, len);
+        break;
+
+    case UJ_T_STR:
+        binds->get_string_data(val, &pl->txt);
+        pl->t_pos = 0;
+        pl->t_kind = TXT_STR;
+        pl->t_open = 0;
+        break;
+
+    case UJ_T_ARY:
+        f = push(pl, UJ_T_ARY);
+        if (!f) return -1;
+
+        f->iter = binds->start_array_traversal(val);
+
+        emit(pl, "[", 1);
+        if (pl->fmt == UJ_FMT_PRETTY) {
+            emit(pl, "\n", 1);
+            pl->tabs = pl->depth;
+        }
+        break;
+
+    case UJ_T_OBJ:
+        f = push(pl, UJ_T_OBJ);
+        if (!f) return -1;
+
+        max_kvps = binds->max_kv_pairs(val);
+        f->iter = binds->start_object_traversal(val);
+
+        emit(pl, "{", 1);
+        if (pl->fmt != UJ_FMT_FAST && max_kvps) {
+            kvps = kvp_buf_get(&f->kb, max_kvps, binds);
+            if (!kvps) return -1;
+
+            build_kvph(f->iter, kvps, &f->kvph, binds);
+            if (!f->kvph.last)
+                f->kvph.h = NULL;
+            else if (pl->fmt == UJ_FMT_PRETTY) {
+                emit(pl, "\n", 1);
+                pl->tabs = pl->depth;
+            }
+        }
+        break;
+
+    default:
+        emit(pl, "null", 4);
+    }
+
+    return 1;
+}
+
+static void next_sep(struct uni_json_pull *pl, struct pull_frame *f)
+{
+    if (f->first) {
+        f->first = 0;
+        return;
+    }
+
+    if (pl->fmt == UJ_FMT_PRETTY) {
+        emit(pl, ",\n", 2);
+        pl->tabs = pl->depth;
+    } else
+        emit(pl, ",", 1);
+}
+
+static void next_elem(struct uni_json_pull *pl, struct pull_frame *f)
+{
+    void *v;
+
+    v = pl->binds->next_value(f->iter);
+    if (!v) {
+        emit(pl, "]", 1);
+        pop(pl);
+        return;
+    }
+
+    next_sep(pl, f);
+    f->val = v;
+}
+
+static void next_kvp(struct uni_json_pull *pl, struct pull_frame *f)
+{
+    struct uj_kv_pair kvp;
+
+    if (pl->fmt == UJ_FMT_FAST) {
+        if (!pl->binds->next_kv_pair(f->iter, &kvp)) goto done;
+    } else {
+        if (!f->kvph.h || !f->kvph.last) goto done;
+
+        kvp = f->kvph.h[1];
+        rm_kvph_root(&f->kvph);
+    }
+
+    next_sep(pl, f);
+
+    pl->txt = kvp.key;
+    pl->t_pos = 0;
+    pl->t_kind = TXT_KEY;
+    pl->t_open = 0;
+    f->val = kvp.val;
+    return;
+
+done:
+    emit(pl, "}", 1);
+    pop(pl);
+}
+
+static int step(struct uni_json_pull *pl)
+{
+    /*
+      Perform the next step of the serialization, ie, start output
+      of a value or move on in the innermost array or object. Values
+      are started in a separate step after the separator before
+      them so that the indentation comes first. Returns 0 if the
+      output is complete.
+    */
+    struct pull_frame *f;
+    void *v;
+
+    if (pl->val) {
+        v = pl->val;
+        pl->val = NULL;
+        return begin_value(pl, v);
+    }
+
+    if (!pl->depth) return 0;
+
+    f = pl->frames + pl->depth - 1;
+    if (f->val) {
+        v = f->val;
+        f->val = NULL;
+        return begin_value(pl, v);
+    }
+
+    if (f->type == UJ_T_ARY)
+        next_elem(pl, f);
+    else
+        next_kvp(pl, f);
+
+    return 1;
+}
+
+/**  API */
+struct uni_json_pull *uni_json_pull_start(struct uni_json_s_binding *binds, void *val,
+                                          int fmt)
+{
+    struct uni_json_pull *pl;
+
+    pl = binds->alloc(sizeof(*pl));
+    if (!pl) return NULL;
+
+    pl->binds = binds;
+    pl->fmt = fmt;
+    pl->val = val;
+
+    pl->c_pos = pl->c_len = 0;
+    pl->tabs = 0;
+    pl->t_kind = TXT_NONE;
+
+    pl->frames = pl->local;
+    pl->depth = 0;
+    pl->n_frames = INIT_PULL_FRAMES;
+    clear_kvp_bufs(pl->local, INIT_PULL_FRAMES);
+
+    return pl;
+}
+
+int uni_json_pull(struct uni_json_pull *pl, uint8_t *buf, size_t len, size_t *used)
+{
+    /*
+      Store up to len bytes of output in buf and their number in
+      *used. Returns 1 if there's more output, 0 if the output is
+      complete and -1 if allocating memory failed.
+    */
+    int rc;
+
+    pl->p = buf;
+    pl->e = buf + len;
+
+    rc = 1;
+    while (pl->p < pl->e) {
+        if (pl->c_pos < pl->c_len)
+            drain_carry(pl);
+        else if (pl->tabs)
+            drain_tabs(pl);
+        else if (pl->t_kind != TXT_NONE)
+            drain_txt(pl);
+        else {
+            rc = step(pl);
+            if (rc <= 0) break;
+        }
+    }
+
+    *used = pl->p - buf;
+    if (rc == -1) return -1;
+
+    return pl->c_pos < pl->c_len || pl->tabs || pl->t_kind != TXT_NONE
+        || pl->val || pl->depth;
+}
+
+void uni_json_pull_free(struct uni_json_pull *pl)
+{
+    /*
+      Free the pull serializer, ending traversals which are still in
+      progress if the output isn't complete.
+    */
+    struct uni_json_s_binding *binds;
+    unsigned ndx;
+
+    binds = pl->binds;
+
+    switch (pl->t_kind) {
+    case TXT_RAW:
+        if (binds->free_num_data) binds->free_num_data(&pl->txt);
+        break;
+
+    case TXT_STR:
+        if (binds->free_string_data) binds->free_string_data(&pl->txt);
+    }
+
+    while (pl->depth) pop(pl);
+
+    for (ndx = 0; ndx < pl->n_frames; ++ndx)
+        if (pl->frames[ndx].kb.kvps) binds->dealloc(pl->frames[ndx].kb.kvps);
+    if (pl->frames != pl->local) binds->dealloc(pl->frames);
+
+    binds->dealloc(pl);
+}
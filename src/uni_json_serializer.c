@@ -7,47 +7,103 @@
 */
 
 /*  includes */
-#include <alloca.h>
+#include <errno.h>
+#include <math.h>
+#include <poll.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/uio.h>
 
 #include "uni_json_types.h"
 #include "uni_json_s_binding.h"
 #include "uni_json_serializer.h"
+#include "scan.h"
+#include "number_fmt.h"
+#include "ser_common.h"
+
+/*  constants */
+enum {
+    SER_BUF_SIZE =	4096,   /* default size of the output buffer */
+    SER_MIN_BUF_SIZE =	64,
+
+    /*  fd sink */
+    FD_BUF_SIZE =	65536,
+    FD_IOVS =		64,     /* max entries in the iovec list */
+    FD_REF_MIN =	256,    /* min length of data referenced in place */
+
+    /*  deterministic output */
+    INIT_SCRATCH_LEVELS =	16,
+    MIN_KVP_BUF =		8,
+
+    /*  pretty-printing */
+    SEP_TABS =		32      /* tabs in the cached separator */
+};
 
 /*  types */
-typedef void serialize_func(void *val, void *sink, struct uni_json_s_binding *binds,
-                            unsigned level, int fmt);
+struct fd_sink {
+    int fd, err;
+    unsigned flags;
+
+    /*
+      Output waiting to be written with writev. seg is the start
+      of the data in the buffer which isn't in the list yet.
+    */
+    struct iovec iov[FD_IOVS];
+    unsigned n_iov;
+    uint8_t *seg;
+};
 
-struct kvp_heap {
-    struct uj_kv_pair *h;
-    size_t last;
+struct sstate {
+    struct uni_json_s_binding *binds;
+    void *sink;
+    int fmt;
+
+    /*
+      Output is collected in buf and passed to the output binding
+      routine when buf is full. Data of at least bypass bytes is
+      passed on directly instead.
+    */
+    uint8_t *buf, *p, *e;
+    size_t bypass;
+
+    struct fd_sink *fds;        /* NULL unless writing to a fd */
+
+    /*
+      Scratch arena for sorting key-value pairs, one buffer per
+      nesting level. Buffers are reused for all objects at the
+      same level and freed when the serialization ends.
+    */
+    struct kvp_buf *scr;
+    unsigned n_scr;
+    struct kvp_buf l_scr[INIT_SCRATCH_LEVELS];
 };
 
+struct uni_json_serializer {
+    struct sstate st;
+};
+
+typedef void serialize_func(void *val, struct sstate *st, unsigned level);
+
 /*  prototypes */
-static void ser_null(void *, void *, struct uni_json_s_binding *,
-                     unsigned, int);
+static void ser_null(void *, struct sstate *, unsigned);
 
-static void ser_bool(void *, void *, struct uni_json_s_binding *,
-                     unsigned, int);
+static void ser_bool(void *, struct sstate *, unsigned);
 
-static void ser_number(void *, void *, struct uni_json_s_binding *,
-                       unsigned, int);
+static void ser_number(void *, struct sstate *, unsigned);
 
-static void ser_string(void *, void *, struct uni_json_s_binding *,
-                       unsigned, int);
+static void ser_string(void *, struct sstate *, unsigned);
 
-static void ser_array(void *, void *, struct uni_json_s_binding *,
-                      unsigned, int);
+static void ser_array(void *, struct sstate *, unsigned);
 
-static void ser_object(void *, void *, struct uni_json_s_binding *,
-                       unsigned, int);
+static void ser_object(void *, struct sstate *, unsigned);
 
-static void ser_value(void *, void *, struct uni_json_s_binding *,
-                            unsigned, int);
+static void ser_value(void *, struct sstate *, unsigned);
 
 /*  variables */
+static uint8_t pretty_sep[] =
+    ",\n\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t";
+
 static serialize_func *serers[] = {
     [UJ_T_NULL] =	ser_null,
     [UJ_T_BOOL] =	ser_bool,
@@ -58,60 +114,253 @@ static serialize_func *serers[] = {
     [UJ_T_UNK] =	ser_null
 };
 
-static uint8_t escs[][8] = {
-    "\\u0000",
-    "\\u0001",
-    "\\u0002",
-    "\\u0003",
-    "\\u0004",
-    "\\u0005",
-    "\\u0006",
-    "\\u0007",
-    "\\b",
-    "\\t",
-    "\\n",
-    "\\u000b",
-    "\\f",
-    "\\r",
-    "\\u000e",
-    "\\u000f",
-    "\\u0010",
-    "\\u0011",
-    "\\u0012",
-    "\\u0013",
-    "\\u0014",
-    "\\u0015",
-    "\\u0016",
-    "\\u0017",
-    "\\u0018",
-    "\\u0019",
-    "\\u001a",
-    "\\u001b",
-    "\\u001c",
-    "\\u001d",
-    "\\u001e",
-    "\\u001f",
-
-    ['"'] = "\\\"",
-    ['\\'] = "\\\\"
+/*
+  Escape sequences for bytes which must not appear literally in a
+  JSON string, indexed by byte value. A len of 0 means no escaping is
+  required. Entries are 8 bytes large so that an escape sequence can
+  be copied with a single fixed-size memcpy.
+*/
+struct esc escs[256] = {
+#define esc_(l, t) { .len = l, .s = t }
+
+    [0x00] =	esc_(6, "\\u0000"),
+    [0x01] =	esc_(6, "\\u0001"),
+    [0x02] =	esc_(6, "\\u0002"),
+    [0x03] =	esc_(6, "\\u0003"),
+    [0x04] =	esc_(6, "\\u0004"),
+    [0x05] =	esc_(6, "\\u0005"),
+    [0x06] =	esc_(6, "\\u0006"),
+    [0x07] =	esc_(6, "\\u0007"),
+    [0x08] =	esc_(2, "\\b"),
+    [0x09] =	esc_(2, "\\t"),
+    [0x0a] =	esc_(2, "\\n"),
+    [0x0b] =	esc_(6, "\\u000b"),
+    [0x0c] =	esc_(2, "\\f"),
+    [0x0d] =	esc_(2, "\\r"),
+    [0x0e] =	esc_(6, "\\u000e"),
+    [0x0f] =	esc_(6, "\\u000f"),
+    [0x10] =	esc_(6, "\\u0010"),
+    [0x11] =	esc_(6, "\\u0011"),
+    [0x12] =	esc_(6, "\\u0012"),
+    [0x13] =	esc_(6, "\\u0013"),
+    [0x14] =	esc_(6, "\\u0014"),
+    [0x15] =	esc_(6, "\\u0015"),
+    [0x16] =	esc_(6, "\\u0016"),
+    [0x17] =	esc_(6, "\\u0017"),
+    [0x18] =	esc_(6, "\\u0018"),
+    [0x19] =	esc_(6, "\\u0019"),
+    [0x1a] =	esc_(6, "\\u001a"),
+    [0x1b] =	esc_(6, "\\u001b"),
+    [0x1c] =	esc_(6, "\\u001c"),
+    [0x1d] =	esc_(6, "\\u001d"),
+    [0x1e] =	esc_(6, "\\u001e"),
+    [0x1f] =	esc_(6, "\\u001f"),
+
+    ['"'] =		esc_(2, "\\\""),
+    ['\\'] =		esc_(2, "\\\\")
+
+#undef esc_
 };
 
 /*  routines */
+/**  output */
+static void fd_write(struct sstate *);
+static void fd_out(struct sstate *, uint8_t *, size_t);
+
+static void flush(struct sstate *st)
+{
+    if (st->fds) {
+        fd_write(st);
+        return;
+    }
+
+    if (st->p > st->buf) {
+        st->binds->output(st->buf, st->p - st->buf, st->sink);
+        st->p = st->buf;
+    }
+}
+
+static void out(struct sstate *st, uint8_t *data, size_t len)
+{
+    if (len < st->bypass && len <= (size_t)(st->e - st->p)) {
+        memcpy(st->p, data, len);
+        st->p += len;
+        return;
+    }
+
+    if (st->fds) {
+        fd_out(st, data, len);
+        return;
+    }
+
+    flush(st);
+    if (len >= st->bypass) {
+        st->binds->output(data, len, st->sink);
+        return;
+    }
+
+    memcpy(st->p, data, len);
+    st->p += len;
+}
+
+static inline void out_c(struct sstate *st, unsigned c)
+{
+    if (st->p == st->e) flush(st);
+    *st->p++ = c;
+}
+
+static void start_output(struct sstate *st, uint8_t *buf, size_t size)
+{
+    st->buf = st->p = buf;
+    st->e = buf + size;
+    st->bypass = size / 2;
+    st->fds = NULL;
+
+    st->scr = st->l_scr;
+    st->n_scr = INIT_SCRATCH_LEVELS;
+    memset(st->l_scr, 0, sizeof(st->l_scr));
+}
+
+static void end_output(struct sstate *st)
+{
+    struct uni_json_s_binding *binds;
+    unsigned ndx;
+
+    binds = st->binds;
+    for (ndx = 0; ndx < st->n_scr; ++ndx)
+        if (st->scr[ndx].kvps) binds->dealloc(st->scr[ndx].kvps);
+
+    if (st->scr != st->l_scr) binds->dealloc(st->scr);
+}
+
+static void out_nl(struct sstate *st, unsigned comma, unsigned level)
+{
+    /*
+      Output an optional comma, a newline and level tabs for
+      pretty-printing.
+    */
+    unsigned n;
+
+    n = level < SEP_TABS ? level : SEP_TABS;
+    out(st, pretty_sep + !comma, n + 1 + comma);
+
+    while (level -= n, level) {
+        n = level < SEP_TABS ? level : SEP_TABS;
+        out(st, pretty_sep + 2, n);
+    }
+}
+
+/**  fd sink */
+static void fd_writev(struct fd_sink *fds)
+{
+    /*
+      Write the data in the iovec list, continuing after partial
+      writes. If the fd is non-blocking, wait until it becomes
+      writable when it would have blocked. The first error ends
+      all output.
+    */
+    struct iovec *iov, *e;
+    struct pollfd pfd;
+    ssize_t rc;
+
+    iov = fds->iov;
+    e = iov + fds->n_iov;
+    while (iov < e && !fds->err) {
+        rc = writev(fds->fd, iov, e - iov);
+        if (rc == -1) {
+            switch (errno) {
+            case EINTR:
+                break;
+
+            case EAGAIN:
+                pfd.fd = fds->fd;
+                pfd.events = POLLOUT;
+                if (poll(&pfd, 1, -1) == -1 && errno != EINTR) fds->err = errno;
+                break;
+
+            default:
+                fds->err = errno;
+            }
+
+            continue;
+        }
+
+        while (iov < e && (size_t)rc >= iov->iov_len) {
+            rc -= iov->iov_len;
+            ++iov;
+        }
+
+        if (iov < e) {
+            iov->iov_base = (uint8_t *)iov->iov_base + rc;
+            iov->iov_len -= rc;
+        }
+    }
+}
+
+static inline void fd_add(struct fd_sink *fds, void *data, size_t len)
+{
+    fds->iov[fds->n_iov].iov_base = data;
+    fds->iov[fds->n_iov].iov_len = len;
+    ++fds->n_iov;
+}
+
+static void fd_write(struct sstate *st)
+{
+    struct fd_sink *fds;
+
+    fds = st->fds;
+    if (st->p > fds->seg) fd_add(fds, fds->seg, st->p - fds->seg);
+
+    fd_writev(fds);
+
+    fds->n_iov = 0;
+    st->p = fds->seg = st->buf;
+}
+
+static void fd_out(struct sstate *st, uint8_t *data, size_t len)
+{
+    /*
+      Output data which doesn't fit into the buffer or is at least
+      bypass bytes long. The latter is added to the iovec list
+      after the buffered output before it instead of being
+      copied. Unless the caller guaranteed that the data stays
+      valid, it's written right away.
+    */
+    struct fd_sink *fds;
+
+    if (len < st->bypass) {
+        fd_write(st);
+
+        memcpy(st->p, data, len);
+        st->p += len;
+        return;
+    }
+
+    fds = st->fds;
+    if (st->p > fds->seg) {
+        fd_add(fds, fds->seg, st->p - fds->seg);
+        fds->seg = st->p;
+
+        if (fds->n_iov == FD_IOVS) fd_write(st);
+    }
+
+    fd_add(fds, data, len);
+    if (fds->n_iov == FD_IOVS || !(fds->flags & UJ_FD_REF_DATA)) fd_write(st);
+}
+
 /**  simple types */
-static void ser_null(void *, void *sink, struct uni_json_s_binding *binds,
-                     unsigned, int)
+static void ser_null(void *, struct sstate *st, unsigned)
 {
-    binds->output("null", 4, sink);
+    out(st, "null", 4);
 }
 
-static void ser_bool(void *val, void *sink, struct uni_json_s_binding *binds,
-                     unsigned, int)
+static void ser_bool(void *val, struct sstate *st, unsigned)
 {
     char *vs;
     size_t len;
     int v;
 
-    v = binds->get_bool_value(val);
+    v = st->binds->get_bool_value(val);
     if (v) {
         vs = "true";
         len = 4;
@@ -120,127 +369,165 @@ static void ser_bool(void *val, void *sink, struct uni_json_s_binding *binds,
         len = 5;
     }
 
-    binds->output(vs, len, sink);
+    out(st, vs, len);
 }
 
-static void ser_number(void *val, void *sink, struct uni_json_s_binding *binds,
-                       unsigned, int)
+static void ser_number(void *val, struct sstate *st, unsigned)
 {
+    /*
+      Numbers the binding can return as native value are formatted
+      directly into the output buffer. Non-finite doubles have no
+      JSON representation and are serialized as null. Everything
+      else is output as text provided by get_num_data.
+    */
+    struct uni_json_s_binding *binds;
     struct uj_data data;
+    union uj_num nv;
+    int type;
+
+    binds = st->binds;
+
+    type = binds->get_num_value ? binds->get_num_value(val, &nv) : UJ_NUM_DATA;
+    if (type != UJ_NUM_DATA) {
+        if (st->e - st->p < FMT_NUM_MAX) flush(st);
+
+        switch (type) {
+        case UJ_NUM_INT64:
+            st->p += fmt_int(nv.i, st->p);
+            break;
+
+        case UJ_NUM_UINT64:
+            st->p += fmt_uint(nv.u, st->p);
+            break;
+
+        case UJ_NUM_DOUBLE:
+            if (!isfinite(nv.d)) {
+                out(st, "null", 4);
+                break;
+            }
+
+            st->p += fmt_double(nv.d, st->p);
+        }
+
+        return;
+    }
 
     binds->get_num_data(val, &data);
-    binds->output(data.s, data.len, sink);
+    out(st, data.s, data.len);
     if (binds->free_num_data) binds->free_num_data(&data);
 }
 
 /**  strings */
-static void ser_string_data(uint8_t *s, size_t len, void *sink,
-                            struct uni_json_s_binding *binds)
+static inline void out_esc(struct sstate *st, struct esc *esc)
 {
-    typeof (binds->output) outp;
-    uint8_t *p, *e, *esc;
-    unsigned c;
+    if ((size_t)(st->e - st->p) < sizeof(esc->s)) flush(st);
 
-    outp = binds->output;
-    outp("\"", 1, sink);
+    memcpy(st->p, esc->s, sizeof(esc->s));
+    st->p += esc->len;
+}
+
+static void ser_string_data(uint8_t *s, size_t len, struct sstate *st)
+{
+    /*
+      Output s as JSON string. Strings usually contain long runs of
+      bytes which don't need escaping. These are found by checking
+      the next few bytes with table lookups and switching to
+      skip_no_esc, which checks 16 - 64 bytes at a time, if none of
+      them needs escaping. This keeps the call overhead out of short
+      strings and escape-dense text. Each run is output with a
+      single out call.
+    */
+    struct esc *esc;
+    uint8_t *p, *q, *e;
+
+    out_c(st, '"');
 
     p = s;
-    e = p + len;
+    e = s + len;
     while (p < e) {
-        c = *p;
-
-        if (c < 32 || c == '"' || c == '\\') {
-            if (p > s) outp(s, p - s, sink);
+        q = e - p > SCALAR_RUN ? p + SCALAR_RUN : e;
+        while (p < q && !escs[*p].len) ++p;
+        if (p == q) p = skip_no_esc(p, e);
 
-            esc = escs[c];
-            len = esc[1] == 'u' ? 6 : 2;
-            outp(esc, len, sink);
+        if (p > s) out(st, s, p - s);
 
-            s = p + 1;
+        while (p < e && (esc = escs + *p)->len) {
+            out_esc(st, esc);
+            ++p;
         }
 
-        ++p;
+        s = p;
     }
 
-    if (p > s) outp(s, p - s, sink);
-    outp("\"", 1, sink);
+    out_c(st, '"');
 }
 
-static void ser_string(void *val, void *sink, struct uni_json_s_binding *binds,
-                       unsigned, int)
+static void ser_string(void *val, struct sstate *st, unsigned)
 {
+    struct uni_json_s_binding *binds;
     struct uj_data data;
 
+    binds = st->binds;
     binds->get_string_data(val, &data);
-    ser_string_data(data.s, data.len, sink, binds);
+    ser_string_data(data.s, data.len, st);
     if (binds->free_string_data) binds->free_string_data(&data);
 }
 
 /**  arrays */
-static void ser_array(void *ary, void *sink, struct uni_json_s_binding *binds,
-                      unsigned level, int fmt)
+static void ser_array(void *ary, struct sstate *st, unsigned level)
 {
-    uint8_t *sep;
-    unsigned sep_len;
+    struct uni_json_s_binding *binds;
     void *aiter, *v;
-    typeof (binds->output) outp;
     typeof (binds->next_value) next_val;
+    int pretty;
 
     ++level;
-    outp = binds->output;
+    binds = st->binds;
     aiter = binds->start_array_traversal(ary);
 
-    outp("[", 1, sink);
+    out_c(st, '[');
 
-    if (fmt == UJ_FMT_PRETTY) {
-        sep = alloca(level + 2);
-        *sep = ',';
-        sep[1] = '\n';
-        sep_len = 2;
-        do sep[sep_len] = '\t'; while (++sep_len < level + 2);
-
-        outp(sep + 1, sep_len - 1, sink);
-    } else {
-        sep = ",";
-        sep_len = 1;
-    }
+    pretty = st->fmt == UJ_FMT_PRETTY;
+    if (pretty) out_nl(st, 0, level);
 
     next_val = binds->next_value;
     v = next_val(aiter);
     if (v) {
-        ser_value(v, sink, binds, level, fmt);
+        ser_value(v, st, level);
 
         while (v = next_val(aiter), v) {
-            outp(sep, sep_len, sink);
-            ser_value(v, sink, binds, level, fmt);
+            if (pretty)
+                out_nl(st, 1, level);
+            else
+                out_c(st, ',');
+
+            ser_value(v, st, level);
         }
     }
 
-    outp("]", 1, sink);
+    out_c(st, ']');
     if (binds->end_array_traversal) binds->end_array_traversal(aiter);
 }
 
 /**  objects */
-static void ser_object_fast(void *oiter, void *sink, struct uni_json_s_binding *binds)
+static void ser_object_fast(void *oiter, struct sstate *st)
 {
-    typeof (binds->output) outp;
-    typeof (binds->next_kv_pair) next_kv_pair;
+    typeof (st->binds->next_kv_pair) next_kv_pair;
     struct uj_kv_pair kvp;
 
-    next_kv_pair = binds->next_kv_pair;
+    next_kv_pair = st->binds->next_kv_pair;
     if (!next_kv_pair(oiter, &kvp)) return;
-    outp = binds->output;
 
-    ser_string_data(kvp.key.s, kvp.key.len, sink, binds);
-    outp(":", 1, sink);
-    ser_value(kvp.val, sink, binds, 0, UJ_FMT_FAST);
+    ser_string_data(kvp.key.s, kvp.key.len, st);
+    out_c(st, ':');
+    ser_value(kvp.val, st, 0);
 
     while (next_kv_pair(oiter, &kvp)) {
-        outp(",", 1, sink);
+        out_c(st, ',');
 
-        ser_string_data(kvp.key.s, kvp.key.len, sink, binds);
-        outp(":", 1, sink);
-        ser_value(kvp.val, sink, binds, 0, UJ_FMT_FAST);
+        ser_string_data(kvp.key.s, kvp.key.len, st);
+        out_c(st, ':');
+        ser_value(kvp.val, st, 0);
     }
 }
 
@@ -307,19 +594,48 @@ static int key_cmp(struct uj_kv_pair const *kvp0, struct uj_kv_pair *kvp1)
   insertion and removal are O(log₂(n)).
 */
 
-static void build_kvph(void *oiter,
-                       size_t max_kvps,
-                       struct kvp_heap *kvph,
-                       struct uni_json_s_binding *binds)
+struct uj_kv_pair *kvp_buf_get(struct kvp_buf *kb, size_t max_kvps,
+                               struct uni_json_s_binding *binds)
 {
+    /*
+      Return storage for a heap of max_kvps key-value pairs from
+      kb, growing it if it's too small. Returns NULL if allocating
+      memory failed.
+    */
+    struct uj_kv_pair *kvps;
+    size_t size;
+
+    if (max_kvps < kb->size) return kb->kvps;
+
+    size = kb->size * 2;
+    if (size <= max_kvps) size = max_kvps + 1;
+    if (size < MIN_KVP_BUF) size = MIN_KVP_BUF;
+
+    kvps = binds->alloc(sizeof(*kvps) * size);
+    if (!kvps) return NULL;
+
+    if (kb->kvps) binds->dealloc(kb->kvps);
+    kb->kvps = kvps;
+    kb->size = size;
+
+    return kvps;
+}
+
+void build_kvph(void *oiter, struct uj_kv_pair *kvps, struct kvp_heap *kvph,
+                struct uni_json_s_binding *binds)
+{
+    /*
+      Build the heap in kvps which must have room for max_kv_pairs
+      + 1 entries.
+    */
     typeof (binds->next_kv_pair) next_kv_pair;
-    struct uj_kv_pair *kvps, kvp;
+    struct uj_kv_pair kvp;
     size_t last, at, pre;
 
     next_kv_pair = binds->next_kv_pair;
-    kvps = kvph->h = binds->alloc(sizeof(*kvps) * (max_kvps + 1));
+    kvph->h = kvps;
     if (!next_kv_pair(oiter, kvps + 1)) {
-        binds->dealloc(kvps);
+        kvph->last = 0;
         return;
     }
 
@@ -341,7 +657,7 @@ static void build_kvph(void *oiter,
     kvph->last = last;
 }
 
-static void rm_kvph_root(struct kvp_heap *kvph)
+void rm_kvph_root(struct kvp_heap *kvph)
 {
     size_t at, next, r_next, last;
     struct uj_kv_pair *kvps;
@@ -363,87 +679,224 @@ static void rm_kvph_root(struct kvp_heap *kvph)
     kvph->last = last - 1;
 }
 
-static void ser_object_det(void *oiter, size_t max_kvps, void *sink,
-                           struct uni_json_s_binding *binds,
-                           unsigned level, int fmt)
+static struct kvp_buf *scratch_at(struct sstate *st, unsigned level)
+{
+    /*
+      Return the scratch buffer for level, growing the table of
+      buffers if necessary. Returns NULL if this failed.
+    */
+    struct uni_json_s_binding *binds;
+    struct kvp_buf *scr;
+    unsigned n;
+
+    if (level < st->n_scr) return st->scr + level;
+
+    binds = st->binds;
+    n = st->n_scr * 2;
+    while (n <= level) n *= 2;
+
+    scr = binds->alloc(n * sizeof(*scr));
+    if (!scr) return NULL;
+
+    memcpy(scr, st->scr, st->n_scr * sizeof(*scr));
+    memset(scr + st->n_scr, 0, (n - st->n_scr) * sizeof(*scr));
+    if (st->scr != st->l_scr) binds->dealloc(st->scr);
+
+    st->scr = scr;
+    st->n_scr = n;
+
+    return scr + level;
+}
+
+static void ser_object_det(void *oiter, size_t max_kvps, struct sstate *st,
+                           unsigned level)
 {
-    typeof (binds->output) outp;
+    /*
+      Objects are output unsorted if no memory for sorting the
+      key-value pairs was available.
+    */
     struct kvp_heap kvph;
-    uint8_t *kv_sep, *kvp_sep;
-    size_t kv_sep_len, kvp_sep_len;
+    struct kvp_buf *kb;
+    struct uj_kv_pair *kvps;
+    uint8_t *kv_sep;
+    size_t kv_sep_len;
+    int pretty;
+
+    kb = scratch_at(st, level);
+    kvps = kb ? kvp_buf_get(kb, max_kvps, st->binds) : NULL;
+    if (!kvps) {
+        ser_object_fast(oiter, st);
+        return;
+    }
 
-    build_kvph(oiter, max_kvps, &kvph, binds);
+    build_kvph(oiter, kvps, &kvph, st->binds);
     if (!kvph.last) return;
 
-    outp = binds->output;
-    if (fmt == UJ_FMT_PRETTY) {
+    pretty = st->fmt == UJ_FMT_PRETTY;
+    if (pretty) {
         kv_sep = " : ";
         kv_sep_len = 3;
 
-        kvp_sep = alloca(level + 2);
-        *kvp_sep = ',';
-        kvp_sep[1] = '\n';
-        kvp_sep_len = 2;
-        do kvp_sep[kvp_sep_len] = '\t'; while (++kvp_sep_len < level + 2);
-        outp(kvp_sep + 1, kvp_sep_len -1, sink);
+        out_nl(st, 0, level);
     } else {
         kv_sep = ":";
         kv_sep_len = 1;
-
-        kvp_sep = ",";
-        kvp_sep_len = 1;
     }
 
-    ser_string_data(kvph.h[1].key.s, kvph.h[1].key.len, sink, binds);
-    outp(kv_sep, kv_sep_len, sink);
-    ser_value(kvph.h[1].val, sink, binds, level, fmt);
+    ser_string_data(kvph.h[1].key.s, kvph.h[1].key.len, st);
+    out(st, kv_sep, kv_sep_len);
+    ser_value(kvph.h[1].val, st, level);
 
     while (rm_kvph_root(&kvph), kvph.last) {
-        outp(kvp_sep, kvp_sep_len, sink);
-
-        ser_string_data(kvph.h[1].key.s, kvph.h[1].key.len, sink, binds);
-        outp(kv_sep, kv_sep_len, sink);
-        ser_value(kvph.h[1].val, sink, binds, level, fmt);
+        if (pretty)
+            out_nl(st, 1, level);
+        else
+            out_c(st, ',');
+
+        ser_string_data(kvph.h[1].key.s, kvph.h[1].key.len, st);
+        out(st, kv_sep, kv_sep_len);
+        ser_value(kvph.h[1].val, st, level);
     }
-
-    binds->dealloc(kvph.h);
 }
 
-static void ser_object(void *val, void *sink, struct uni_json_s_binding *binds,
-                       unsigned level, int fmt)
+static void ser_object(void *val, struct sstate *st, unsigned level)
 {
+    struct uni_json_s_binding *binds;
     void *oiter;
     size_t max_kvps;
 
+    binds = st->binds;
     max_kvps = binds->max_kv_pairs(val);
 
-    binds->output("{", 1, sink);
+    out_c(st, '{');
     oiter = binds->start_object_traversal(val);
 
-    switch (fmt) {
+    switch (st->fmt) {
     case UJ_FMT_FAST:
-        ser_object_fast(oiter, sink, binds);
+        ser_object_fast(oiter, st);
         break;
 
     case UJ_FMT_DET:
     case UJ_FMT_PRETTY:
         if (max_kvps)
-            ser_object_det(oiter, max_kvps, sink, binds, level + 1, fmt);
+            ser_object_det(oiter, max_kvps, st, level + 1);
     }
 
-    binds->output("}", 1, sink);
+    out_c(st, '}');
     if (binds->end_object_traversal) binds->end_object_traversal(oiter);
 }
 
 /**  top-level */
-static void ser_value(void *val, void *sink, struct uni_json_s_binding *binds,
-                            unsigned level, int fmt)
+static void ser_value(void *val, struct sstate *st, unsigned level)
 {
-    serers[binds->type_of(val)](val, sink, binds, level, fmt);
+    serers[st->binds->type_of(val)](val, st, level);
 }
 
 void uni_json_serialize(void *val, void *sink, struct uni_json_s_binding *binds,
                         int fmt)
 {
-    ser_value(val, sink, binds, 0, fmt);
+    uint8_t buf[SER_BUF_SIZE];
+    struct sstate st;
+
+    st.binds = binds;
+    st.sink = sink;
+    st.fmt = fmt;
+    start_output(&st, buf, sizeof(buf));
+
+    ser_value(val, &st, 0);
+    flush(&st);
+    end_output(&st);
+}
+
+int uni_json_serialize_fd(void *val, int fd, struct uni_json_s_binding *binds, int fmt,
+                          unsigned flags)
+{
+    /*
+      Serialize val to fd, collecting the output in an iovec list
+      written with writev. Returns 0 on success and -1 with errno
+      set if allocating memory or writing failed.
+    */
+    struct fd_sink *fds;
+    struct sstate st;
+    int err;
+
+    fds = binds->alloc(sizeof(*fds) + FD_BUF_SIZE);
+    if (!fds) {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    fds->fd = fd;
+    fds->err = 0;
+    fds->flags = flags;
+    fds->n_iov = 0;
+
+    st.binds = binds;
+    st.sink = NULL;
+    st.fmt = fmt;
+    start_output(&st, (uint8_t *)(fds + 1), FD_BUF_SIZE);
+
+    st.fds = fds;
+    fds->seg = st.buf;
+    if (flags & UJ_FD_REF_DATA) st.bypass = FD_REF_MIN;
+
+    ser_value(val, &st, 0);
+    fd_write(&st);
+    end_output(&st);
+
+    err = fds->err;
+    binds->dealloc(fds);
+
+    if (err) {
+        errno = err;
+        return -1;
+    }
+
+    return 0;
+}
+
+/**  serializer handles */
+struct uni_json_serializer *uni_json_serializer_new(struct uni_json_s_binding *binds,
+                                                   void *sink, size_t buf_size)
+{
+    /*
+      Create a serializer for writing values to sink through an
+      output buffer of buf_size bytes, the default size if 0.
+    */
+    struct uni_json_serializer *ser;
+
+    if (!buf_size) buf_size = SER_BUF_SIZE;
+    if (buf_size < SER_MIN_BUF_SIZE) buf_size = SER_MIN_BUF_SIZE;
+
+    ser = binds->alloc(sizeof(*ser) + buf_size);
+    if (!ser) return NULL;
+
+    ser->st.binds = binds;
+    ser->st.sink = sink;
+    start_output(&ser->st, (uint8_t *)(ser + 1), buf_size);
+
+    return ser;
+}
+
+void uni_json_serializer_write(struct uni_json_serializer *ser, void *val, int fmt)
+{
+    ser->st.fmt = fmt;
+    ser_value(val, &ser->st, 0);
+}
+
+void uni_json_serializer_output(struct uni_json_serializer *ser, uint8_t *data, size_t len)
+{
+    out(&ser->st, data, len);
+}
+
+void uni_json_serializer_flush(struct uni_json_serializer *ser)
+{
+    flush(&ser->st);
+}
+
+void uni_json_serializer_finish(struct uni_json_serializer *ser)
+{
+    flush(&ser->st);
+    end_output(&ser->st);
+    ser->st.binds->dealloc(ser);
 }
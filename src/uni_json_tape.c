@@ -0,0 +1,600 @@
+/*
+  two-stage parser
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+*/
+
+/*  includes */
+#include <stddef.h>
+#include <string.h>
+
+#include "uni_json_p_binding.h"
+#include "uni_json_parser.h"
+#include "uni_json_types.h"
+#include "pstate.h"
+#include "lib.h"
+#include "scan.h"
+#include "parser_literals.h"
+#include "parser_number.h"
+#include "parser_string.h"
+#include "parser_text.h"
+#include "tape.h"
+
+/*  constants */
+enum {
+    INIT_STACK =	64      /* initial size of the bracket stack */
+};
+
+/*  types */
+typedef void *parse_func(struct pstate *, struct uni_json_p_binding *);
+
+/*  variables */
+static parse_func *scalar_map[256] = {
+    ['f'] =		parse_false,
+    ['n'] =		parse_null,
+    ['t'] =		parse_true,
+
+    ['-'] =		parse_number,
+    ['0' ... '9'] =	parse_number,
+
+    ['"'] =		parse_string
+};
+
+/*  routines */
+/**  stage 1 */
+static int grow_ents(struct uni_json_tape *tape, size_t n)
+{
+    /*
+      Make room for at least BLOCK_LEN more entries after the n
+      used ones. The first guess is one entry per eight bytes of
+      text, the size is doubled after that.
+    */
+    struct uni_json_p_binding *binds;
+    struct tape_ent *ents;
+    size_t cap;
+
+    binds = tape->binds;
+
+    cap = tape->cap ? tape->cap * 2 : tape->len / 8 + BLOCK_LEN;
+    if (cap < n + BLOCK_LEN) cap = n + BLOCK_LEN;
+
+    ents = binds->alloc(cap * sizeof(*ents));
+    if (!ents) return -1;
+
+    if (tape->ents) {
+        memcpy(ents, tape->ents, n * sizeof(*ents));
+        binds->dealloc(tape->ents);
+    }
+
+    tape->ents = ents;
+    tape->cap = cap;
+    return 0;
+}
+
+static int find_structurals(struct uni_json_tape *tape, int *open)
+{
+    /*
+      Stage 1: Record the positions of all structural chars, of
+      all strings and of all other tokens on the tape. Works on
+      blocks of BLOCK_LEN bytes. The last partial block is copied
+      to a buffer and padded with whitespace.
+
+      Sets *open if the text ends inside a string. Returns 0 on
+      success, -1 if memory allocation failed.
+    */
+    uint8_t last[BLOCK_LEN];
+    struct block_masks m;
+    uint64_t esc_carry, in_str, prev_in_str, prev_other;
+    uint64_t esc, quote, other, bits;
+    struct tape_ent *ent;
+    uint8_t *data, *p;
+    size_t len, ofs, n;
+
+    data = tape->data;
+    len = tape->len;
+    esc_carry = prev_in_str = prev_other = 0;
+    ent = tape->ents;
+
+    for (ofs = 0; ofs < len; ofs += BLOCK_LEN) {
+        /*  a block has at most BLOCK_LEN entries */
+        n = ent - tape->ents;
+        if (tape->cap - n < BLOCK_LEN) {
+            if (grow_ents(tape, n) == -1) return -1;
+            ent = tape->ents + n;
+        }
+
+        p = data + ofs;
+        if (len - ofs < BLOCK_LEN) {
+            memset(last, ' ', sizeof(last));
+            memcpy(last, p, len - ofs);
+            p = last;
+        }
+
+        classify_block(p, &m);
+
+        esc = find_escaped(m.bslash, &esc_carry);
+        quote = m.quote & ~esc;
+        in_str = prefix_xor(quote) ^ prev_in_str;
+        prev_in_str = (uint64_t)((int64_t)in_str >> 63);
+
+        /*
+          Other tokens start with a byte which is neither
+          whitespace nor structural nor part of a string and not
+          preceded by another such byte.
+        */
+        other = ~(m.ws | m.op | quote | in_str);
+        bits = (m.op & ~in_str) | (quote & in_str) | (other & ~(other << 1 | prev_other));
+        prev_other = other >> 63;
+
+        while (bits) {
+            ent->pos = ofs + __builtin_ctzll(bits);
+            ++ent;
+
+            bits &= bits - 1;
+        }
+    }
+
+    tape->n_ents = ent - tape->ents;
+    *open = prev_in_str != 0;
+    return 0;
+}
+
+static int grow_stack(struct uni_json_tape *tape)
+{
+    /*  double the size of the bracket stack */
+    struct uni_json_p_binding *binds;
+    uint32_t *stack;
+    unsigned size;
+
+    binds = tape->binds;
+
+    size = tape->stack_size ? tape->stack_size * 2 : INIT_STACK;
+    stack = binds->alloc(size * sizeof(*stack));
+    if (!stack) return -1;
+
+    if (tape->stack) {
+        memcpy(stack, tape->stack, tape->stack_size * sizeof(*stack));
+        binds->dealloc(tape->stack);
+    }
+
+    tape->stack = stack;
+    tape->stack_size = size;
+    return 0;
+}
+
+static int match_brackets(struct uni_json_tape *tape)
+{
+    /*
+      Link every [ and { on the tape to the matching close char
+      and record the number of values in the container at the
+      latter. Sets tape->bad if brackets don't match.
+
+      Returns 0 on success, -1 if memory allocation failed.
+    */
+    struct tape_ent *ents;
+    unsigned sp, depth;
+    uint8_t *data;
+    uint32_t o;
+    size_t i;
+    int c;
+
+    data = tape->data;
+    ents = tape->ents;
+    sp = depth = 0;
+
+    for (i = 0; i < tape->n_ents; ++i) {
+        c = data[ents[i].pos];
+
+        switch (c) {
+        case '[':
+        case '{':
+            /*  counts commas until the container is closed */
+            ents[i].n = 0;
+
+            if (sp == tape->stack_size && grow_stack(tape) == -1) return -1;
+            tape->stack[sp++] = i;
+            if (sp > depth) depth = sp;
+            break;
+
+        case ',':
+            if (sp) ++ents[tape->stack[sp - 1]].n;
+            break;
+
+        case ']':
+        case '}':
+            if (!sp) goto bad;
+
+            o = tape->stack[--sp];
+            if (data[ents[o].pos] + 2 != c) goto bad;
+
+            ents[i].n = ents[o].n + (i != o + 1);
+            ents[o].n = i;
+        }
+    }
+
+    if (sp) goto bad;
+
+    tape->bad = 0;
+    tape->depth = depth;
+    return 0;
+
+bad:
+    tape->bad = 1;
+    tape->depth = 0;
+    return 0;
+}
+
+int tape_index(struct uni_json_tape *tape, uint8_t *data, size_t len)
+{
+    /*
+      Build the tape for a text. Memory allocated for an earlier
+      text is reused if it's large enough.
+
+      Returns 0 on success, -1 if memory allocation failed.
+    */
+    struct uni_json_p_binding *binds;
+    int open;
+
+    binds = tape->binds;
+
+    tape->data = data;
+    tape->len = len;
+    if (find_structurals(tape, &open) == -1) return -1;
+
+    if (open) {
+        tape->bad = 1;
+        return 0;
+    }
+
+    if (match_brackets(tape) == -1) return -1;
+    if (tape->bad || tape->n_frames > tape->depth) return 0;
+
+    if (tape->frames) binds->dealloc(tape->frames);
+    tape->n_frames = 0;
+
+    tape->frames = binds->alloc(sizeof(*tape->frames) * (tape->depth + 1));
+    if (!tape->frames) return -1;
+    tape->n_frames = tape->depth + 1;
+
+    return 0;
+}
+
+void tape_release(struct uni_json_tape *tape)
+{
+    struct uni_json_p_binding *binds;
+
+    binds = tape->binds;
+    if (tape->ents) binds->dealloc(tape->ents);
+    if (tape->stack) binds->dealloc(tape->stack);
+    if (tape->frames) binds->dealloc(tape->frames);
+}
+
+/**  stage 2 */
+static int scalar_end(struct uni_json_tape *tape, struct pstate *pstate, size_t i)
+{
+    /*
+      Check that a scalar which was parsed from the text ended
+      right before the next entry on the tape, apart from
+      whitespace.
+    */
+    uint8_t *p, *e, *next;
+
+    p = pstate->p;
+    e = pstate->e;
+    while (p < e && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p;
+
+    next = i + 1 < tape->n_ents ? tape->data + tape->ents[i + 1].pos : e;
+    return p == next ? 0 : -1;
+}
+
+static void *walk(struct uni_json_tape *tape, struct pstate *pstate, unsigned *plevel)
+{
+    /*
+      Stage 2: Create the value described by the tape with the
+      binding routines. Returns NULL if the text is invalid. The
+      error is then determined by parsing the text again.
+    */
+    struct uni_json_p_binding *binds;
+    struct tape_frame *f;
+    struct tape_ent *ents;
+    parse_func *parse;
+    unsigned level;
+    uint8_t *data;
+    size_t i, n;
+    uint32_t close;
+    void *v;
+    int c, rc;
+
+    binds = tape->binds;
+    data = tape->data;
+    ents = tape->ents;
+    n = tape->n_ents;
+    i = 0;
+    level = 0;
+    f = tape->frames;
+
+value:
+    if (i == n) goto fail;
+
+    c = data[ents[i].pos];
+    switch (c) {
+    case '[':
+    case '{':
+        if (level + 1 > pstate->max_nesting) goto fail;
+
+        /*  the container size is known before creating it */
+        close = ents[i].n;
+        f = tape->frames + ++level;
+        f->open = c;
+        f->key = NULL;
+
+        if (c == '[')
+            f->ctr = binds->make_array_sized ?
+                binds->make_array_sized(ents[close].n) : binds->make_array();
+        else
+            f->ctr = binds->make_object_sized ?
+                binds->make_object_sized(ents[close].n) : binds->make_object();
+
+        if (++i == close) {
+            ++i;
+            goto closed;
+        }
+
+        if (c == '{') goto key;
+        goto value;
+    }
+
+    parse = scalar_map[c];
+    if (!parse) goto fail;
+
+    pstate->p = data + ents[i].pos;
+    v = parse(pstate, binds);
+    if (!v) goto fail;
+
+    if (scalar_end(tape, pstate, i) == -1) {
+        free_obj(pstate->last_type, v, binds);
+        goto fail;
+    }
+    ++i;
+
+have:
+    if (!level) {
+        if (i != n) {
+            free_obj(pstate->last_type, v, binds);
+            goto fail;
+        }
+
+        *plevel = 0;
+        return v;
+    }
+
+    if (f->open == '[')
+        rc = binds->add_2_array(v, f->ctr);
+    else {
+        rc = binds->add_2_object(f->key, v, f->ctr);
+        if (rc) f->key = NULL;
+    }
+
+    if (!rc) {
+        free_obj(pstate->last_type, v, binds);
+        goto fail;
+    }
+
+    if (i == n) goto fail;
+
+    c = data[ents[i].pos];
+    if (c == ',') {
+        ++i;
+        if (f->open == '{') goto key;
+        goto value;
+    }
+
+    if (c != f->open + 2) goto fail;
+    ++i;
+
+closed:
+    v = f->ctr;
+    pstate->last_type = f->open == '[' ? UJ_T_ARY : UJ_T_OBJ;
+    f = tape->frames + --level;
+    goto have;
+
+key:
+    if (i == n || data[ents[i].pos] != '"') goto fail;
+
+    pstate->p = data + ents[i].pos;
+    pstate->key = 1;
+    v = parse_string(pstate, binds);
+    pstate->key = 0;
+    if (!v) goto fail;
+
+    f->key = v;
+    if (scalar_end(tape, pstate, i) == -1) goto fail;
+    ++i;
+
+    if (i == n || data[ents[i].pos] != ':') goto fail;
+    ++i;
+    goto value;
+
+fail:
+    *plevel = level;
+    return NULL;
+}
+
+static void release(struct uni_json_tape *tape, unsigned level)
+{
+    /*  free partially constructed containers after an error */
+    struct uni_json_p_binding *binds;
+    struct tape_frame *f;
+
+    binds = tape->binds;
+    f = tape->frames + level;
+    while (f > tape->frames) {
+        if (f->key) binds->free_string(f->key);
+        free_obj(f->open == '[' ? UJ_T_ARY : UJ_T_OBJ, f->ctr, binds);
+
+        --f;
+    }
+}
+
+static void *reparse(struct uni_json_tape *tape, struct pstate *pstate)
+{
+    /*
+      Parse an invalid text with the iterative parser to find out
+      what's wrong with it. This ensures that errors are reported
+      in the same way as by the other parsers.
+    */
+    struct uni_json_p_binding *binds;
+    struct iter_frame local[INIT_FRAMES], *frames;
+    unsigned n_frames;
+    void *v;
+
+    binds = tape->binds;
+    pstate->p = tape->data;
+    pstate->e = tape->data + tape->len;
+
+    frames = local;
+    n_frames = INIT_FRAMES;
+    v = parse_text_iter(pstate, binds, &frames, &n_frames);
+    if (frames != local) binds->dealloc(frames);
+
+    return v;
+}
+
+void *tape_walk(struct uni_json_tape *tape, struct pstate *pstate)
+{
+    /*
+      Create the value described by a tape. pstate must have been
+      set up as for parse_text. The intern table is emptied before
+      returning.
+
+      Returns the value or NULL with error code and position in
+      *pstate.
+    */
+    struct uni_json_p_binding *binds, copy;
+    struct intern_slot *interned;
+    unsigned level;
+    void *v;
+
+    binds = tape->binds;
+    pstate->e = tape->data + tape->len;
+    pstate->level = 0;
+
+    if (!tape->bad) {
+        /*
+          Errors are only found by parsing the text again after
+          the walk failed. Hence, the walk must not unescape
+          strings in the text.
+        */
+        if (binds->span_flags & UJ_SPAN_IN_SITU) {
+            copy = *binds;
+            copy.span_flags &= ~UJ_SPAN_IN_SITU;
+            tape->binds = &copy;
+        }
+
+        v = walk(tape, pstate, &level);
+        if (!v) release(tape, level);
+        tape->binds = binds;
+
+        if (v) {
+            end_intern(pstate, binds);
+            return v;
+        }
+    }
+
+    interned = pstate->intern;
+    end_intern(pstate, binds);
+    if (interned) reuse_intern(pstate, binds, interned);
+
+    v = reparse(tape, pstate);
+    if (v) {
+        /*  can't happen */
+        free_obj(pstate->last_type, v, binds);
+
+        pstate->err.code = UJ_E_INV;
+        pstate->err.pos = tape->data;
+    }
+
+    return NULL;
+}
+
+/**  API */
+struct uni_json_tape *uni_json_tape_build(uint8_t *data, size_t len,
+                                          struct uni_json_p_binding *binds)
+{
+    /*
+      Build the tape for a text. Returns NULL if this failed
+      because memory couldn't be allocated or the text is too
+      large.
+    */
+    struct uni_json_tape *tape;
+    int rc;
+
+    if (len > MAX_TAPE_LEN) return NULL;
+
+    tape = binds->alloc(sizeof(*tape));
+    if (!tape) return NULL;
+    memset(tape, 0, sizeof(*tape));
+    tape->binds = binds;
+
+    rc = tape_index(tape, data, len);
+    if (rc == -1) {
+        uni_json_tape_free(tape);
+        return NULL;
+    }
+
+    return tape;
+}
+
+void *uni_json_tape_parse(struct uni_json_tape *tape, void *err_p)
+{
+    struct intern_slot interned[N_INTERN];
+    struct uni_json_p_binding *binds;
+    struct pstate pstate;
+    void *v;
+
+    binds = tape->binds;
+    pstate.max_nesting = uni_json_max_nesting;
+    start_intern(&pstate, binds, interned);
+
+    v = tape_walk(tape, &pstate);
+    if (!v) binds->on_error(pstate.err.code, pstate.err.pos - tape->data, err_p);
+    return v;
+}
+
+void uni_json_tape_free(struct uni_json_tape *tape)
+{
+    tape_release(tape);
+    tape->binds->dealloc(tape);
+}
+
+void *uni_json_parse_tape(uint8_t *data, size_t len,
+                          struct uni_json_p_binding *binds, void *err_p)
+{
+    /*
+      Parse a text in two stages, falling back to the iterative
+      parser for texts which are too large for a tape.
+    */
+    struct intern_slot interned[N_INTERN];
+    struct uni_json_tape *tape;
+    struct pstate pstate;
+    void *v;
+
+    if (len > MAX_TAPE_LEN) return uni_json_parse_iter(data, len, binds, err_p);
+
+    tape = uni_json_tape_build(data, len, binds);
+    if (!tape) {
+        binds->on_error(UJ_E_NO_MEM, 0, err_p);
+        return NULL;
+    }
+
+    pstate.max_nesting = uni_json_max_nesting;
+    start_intern(&pstate, binds, interned);
+
+    v = tape_walk(tape, &pstate);
+    uni_json_tape_free(tape);
+
+    if (!v) binds->on_error(pstate.err.code, pstate.err.pos - data, err_p);
+    return v;
+}
@@ -0,0 +1,234 @@
+/*
+  validation without creating values
+
+  Copyright (C) 2025 Rainer Weikusat, rweikusat@talktalk.net
+
+  MIT-licensed.
+*/
+
+/*  includes */
+#include <stddef.h>
+
+#include "uni_json_p_binding.h"
+#include "uni_json_parser.h"
+#include "pstate.h"
+#include "lib.h"
+#include "parser_literals.h"
+#include "parser_number.h"
+#include "parser_string.h"
+#include "scan.h"
+
+/*  constants */
+enum {
+    MAX_VALIDATE_DEPTH =	65536   /* nesting depth supported by uni_json_validate */
+};
+
+/*  prototypes */
+static int discard(uint8_t *, size_t, void *);
+
+/*  variables */
+/*
+  The string parser adds data to strings with the add_2_string
+  binding routine. This one throws it away.
+*/
+static struct uni_json_p_binding discard_binds = {
+    .add_2_string =	discard
+};
+
+/*  routines */
+/**  helpers */
+static int discard(uint8_t *, size_t, void *)
+{
+    return 1;
+}
+
+static inline uint8_t *skip_ws(uint8_t *p, uint8_t *e)
+{
+    while (p < e && (*p == ' ' || *p == '\n' || *p == '\t' || *p == '\r')) ++p;
+    return p;
+}
+
+static inline int fail(struct pstate *pstate, unsigned code, uint8_t *pos)
+{
+    pstate->err.code = code;
+    pstate->err.pos = pos;
+    return -1;
+}
+
+static int check(struct pstate *pstate)
+{
+    /*
+      Check the text in *pstate like parse_text_iter parses it but
+      without creating anything. The only state kept for an open
+      array or object is a bit telling which of both it is. Levels
+      start at 1, hence, the extra word.
+
+      Returns 0 if the text is valid, -1 otherwise.
+    */
+    uint64_t objs[MAX_VALIDATE_DEPTH / 64 + 1];
+    uint8_t *data, *p, *e, *key_pos, *bad_key;
+    unsigned level, max, bad_level, flags;
+    int c, first, key, str, rc;
+
+    data = pstate->p;
+    e = pstate->e;
+
+    max = pstate->max_nesting;
+    if (max > MAX_VALIDATE_DEPTH) max = MAX_VALIDATE_DEPTH;
+
+    /*
+      An array or object in the key position of an object is
+      checked before it's reported as invalid key. bad_level is
+      the level of this object then.
+    */
+    level = bad_level = 0;
+    key_pos = bad_key = NULL;
+    first = key = 0;
+
+    while (1) {
+        /*  start of a value */
+        pstate->p = skip_ws(pstate->p, e);
+        c = pstate->p < e ? *pstate->p : -1;
+        str = 0;
+
+        switch (c) {
+        case '[':
+        case '{':
+            if (level + 1 > max) return fail(pstate, UJ_E_TOO_DEEP, pstate->p);
+
+            if (key) {
+                bad_level = level;
+                bad_key = key_pos;
+            }
+
+            ++level;
+            if (c == '{')
+                objs[level / 64] |= 1ULL << level % 64;
+            else
+                objs[level / 64] &= ~(1ULL << level % 64);
+
+            key = c == '{';
+            key_pos = ++pstate->p;
+            first = 1;
+            continue;
+
+        case '"':
+            /*
+              Strings consisting of printable ASCII chars only are
+              common. Everything else is left to the string parser.
+            */
+            p = skip_plain(pstate->p + 1, e);
+            if (p == e || *p != '"') {
+                ++pstate->p;
+                rc = parse_string_content(pstate, &discard_binds, NULL);
+                if (rc == -1) return -1;
+            } else
+                pstate->p = p + 1;
+
+            str = 1;
+            break;
+
+        case 'f':
+            rc = skip_literal(pstate, "false");
+            if (rc == -1) return -1;
+            break;
+
+        case 'n':
+            rc = skip_literal(pstate, "null");
+            if (rc == -1) return -1;
+            break;
+
+        case 't':
+            rc = skip_literal(pstate, "true");
+            if (rc == -1) return -1;
+            break;
+
+        case '-':
+        case '0' ... '9':
+            rc = skip_number(pstate, &flags);
+            if (rc == -1) return -1;
+            break;
+
+        case ']':
+        case '}':
+        case -1:
+            /*  no value, only valid for an empty array or object */
+            if (!level) return fail(pstate, UJ_E_NO_VAL, data);
+            if (!first) return fail(pstate, key ? UJ_E_NO_KEY : UJ_E_NO_VAL, pstate->p);
+
+            c = skip_one_of(pstate, key ? "}" : "]");
+            if (c == -1) return -1;
+            goto close;
+
+        default:
+            return fail(pstate, UJ_E_INV, pstate->p);
+        }
+
+        /*  end of a value */
+        while (1) {
+            pstate->p = skip_ws(pstate->p, e);
+            if (!level) return pstate->p == e ? 0 : fail(pstate, UJ_E_GARBAGE, pstate->p);
+
+            if (key) {
+                if (!str) return fail(pstate, UJ_E_INV_KEY, key_pos);
+
+                c = skip_one_of(pstate, ":");
+                if (c == -1) return -1;
+
+                key = 0;
+                break;
+            }
+
+            if (objs[level / 64] & 1ULL << level % 64) {
+                c = skip_one_of(pstate, ",}");
+                if (c == -1) return -1;
+
+                if (c == ',') {
+                    key = 1;
+                    key_pos = pstate->p;
+                    break;
+                }
+            } else {
+                c = skip_one_of(pstate, ",]");
+                if (c == -1) return -1;
+                if (c == ',') break;
+            }
+
+        close:
+            --level;
+            if (level && level == bad_level) return fail(pstate, UJ_E_INV_KEY, bad_key);
+
+            key = str = 0;
+        }
+
+        first = 0;
+    }
+}
+
+/**  API */
+int uni_json_validate(uint8_t *data, size_t len, unsigned *err_code, size_t *err_pos)
+{
+    /*
+      Check if a text is valid JSON without calling any binding
+      routines or allocating memory.
+
+      Returns 1 if it is. Otherwise, returns 0 and stores error
+      code and position in *err_code and *err_pos unless these are
+      NULL.
+    */
+    struct pstate pstate;
+    int rc;
+
+    pstate.p = data;
+    pstate.e = data + len;
+    pstate.max_nesting = uni_json_max_nesting;
+    pstate.intern = NULL;
+    pstate.key = 0;
+
+    rc = check(&pstate);
+    if (rc == 0) return 1;
+
+    if (err_code) *err_code = pstate.err.code;
+    if (err_pos) *err_pos = pstate.err.pos - data;
+    return 0;
+}